@@ -52,10 +52,31 @@ static void Evaluate_CameraFunction(benchmark::State& state) {
     state.SetLabel(std::to_string(stopCount).c_str());
 }
 
+// Evaluates the expression tree the function was compiled from.
+static void Evaluate_CameraFunctionTree(benchmark::State& state) {
+    size_t stopCount = state.range(0);
+    auto doc = createFunctionJSON(stopCount);
+    conversion::Error error;
+    optional<PropertyValue<float>> function = conversion::convertJSON<PropertyValue<float>>(doc, error, false, false);
+    if (!function) {
+        state.SkipWithError(error.message.c_str());
+    }
+
+    while(state.KeepRunning()) {
+        float z = 24.0f * static_cast<float>(rand() % 100) / 100;
+        function->asExpression().getExpression().evaluate(expression::EvaluationContext(z));
+    }
+
+    state.SetLabel(std::to_string(stopCount).c_str());
+}
+
 BENCHMARK(Parse_CameraFunction)
     ->Arg(1)->Arg(2)->Arg(4)->Arg(6)->Arg(8)->Arg(10)->Arg(12);
 
 BENCHMARK(Evaluate_CameraFunction)
     ->Arg(1)->Arg(2)->Arg(4)->Arg(6)->Arg(8)->Arg(10)->Arg(12);
 
+BENCHMARK(Evaluate_CameraFunctionTree)
+    ->Arg(1)->Arg(2)->Arg(4)->Arg(6)->Arg(8)->Arg(10)->Arg(12);
+
 
@@ -30,5 +30,82 @@ static void Parse_EvaluateFilter(benchmark::State& state) {
     }
 }
 
+// A road filter of the kind found in vector styles, evaluated against a feature
+// with a realistic number of properties.
+static const char* legacyRoadFilter = R"FILTER(["all",
+    ["==", "$type", "LineString"],
+    ["!in", "structure", "bridge", "tunnel"],
+    ["in", "class", "primary", "secondary", "tertiary"],
+    [">=", "layer", 0],
+    ["!has", "oneway"]
+])FILTER";
+
+static const char* expressionRoadFilter = R"FILTER(["all",
+    ["==", ["geometry-type"], "LineString"],
+    ["!=", ["get", "structure"], "bridge"],
+    ["!=", ["get", "structure"], "tunnel"],
+    ["==", ["get", "class"], "secondary"],
+    ["!", ["has", "oneway"]]
+])FILTER";
+
+static const StubGeometryTileFeature roadFeature = { {}, FeatureType::LineString, {}, {
+    { "class", std::string("secondary") },
+    { "type", std::string("secondary") },
+    { "structure", std::string("none") },
+    { "layer", int64_t(0) },
+    { "len", uint64_t(1234) },
+    { "name", std::string("Main Street") },
+    { "name_en", std::string("Main Street") },
+    { "ref", std::string("B 42") },
+    { "iso_3166_2", std::string("DE-BE") },
+    { "surface", std::string("paved") },
+} };
+
+// Evaluates the expression tree the filter was compiled from.
+static bool evaluateTree(const style::Filter& filter, const style::expression::EvaluationContext& context) {
+    const style::expression::EvaluationResult result = (*filter.expression)->evaluate(context);
+    return result && result->is<bool>() && result->get<bool>();
+}
+
+static void Parse_EvaluateFilter_LegacyTree(benchmark::State& state) {
+    const style::Filter filter = parse(legacyRoadFilter);
+    const style::expression::EvaluationContext context(&roadFeature);
+
+    while (state.KeepRunning()) {
+        benchmark::DoNotOptimize(evaluateTree(filter, context));
+    }
+}
+
+static void Parse_EvaluateFilter_LegacyCompiled(benchmark::State& state) {
+    const style::Filter filter = parse(legacyRoadFilter);
+    const style::expression::EvaluationContext context(&roadFeature);
+
+    while (state.KeepRunning()) {
+        benchmark::DoNotOptimize(filter(context));
+    }
+}
+
+static void Parse_EvaluateFilter_ExpressionTree(benchmark::State& state) {
+    const style::Filter filter = parse(expressionRoadFilter);
+    const style::expression::EvaluationContext context(&roadFeature);
+
+    while (state.KeepRunning()) {
+        benchmark::DoNotOptimize(evaluateTree(filter, context));
+    }
+}
+
+static void Parse_EvaluateFilter_ExpressionCompiled(benchmark::State& state) {
+    const style::Filter filter = parse(expressionRoadFilter);
+    const style::expression::EvaluationContext context(&roadFeature);
+
+    while (state.KeepRunning()) {
+        benchmark::DoNotOptimize(filter(context));
+    }
+}
+
 BENCHMARK(Parse_Filter);
 BENCHMARK(Parse_EvaluateFilter);
+BENCHMARK(Parse_EvaluateFilter_LegacyTree);
+BENCHMARK(Parse_EvaluateFilter_LegacyCompiled);
+BENCHMARK(Parse_EvaluateFilter_ExpressionTree);
+BENCHMARK(Parse_EvaluateFilter_ExpressionCompiled);
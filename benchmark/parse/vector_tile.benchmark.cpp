@@ -2,6 +2,7 @@
 
 #include <mbgl/tile/vector_tile_data.hpp>
 #include <mbgl/util/io.hpp>
+#include <mbgl/util/monotonic_arena.hpp>
 
 using namespace mbgl;
 
@@ -26,3 +27,59 @@ static void Parse_VectorTile(benchmark::State& state) {
 }
 
 BENCHMARK(Parse_VectorTile);
+
+namespace {
+
+// Returns the layers of the tile with their features decoded, so that only the
+// cost of creating the feature objects is measured.
+std::vector<std::unique_ptr<GeometryTileLayer>> decodeLayers(const VectorTileData& tile) {
+    std::vector<std::unique_ptr<GeometryTileLayer>> layers;
+    for (const auto& name : tile.layerNames()) {
+        if (auto layer = tile.getLayer(name)) {
+            for (std::size_t i = 0; i < layer->featureCount(); i++) {
+                layer->getFeature(i);
+            }
+            layers.push_back(std::move(layer));
+        }
+    }
+    return layers;
+}
+
+} // namespace
+
+// Reads the features of a decoded tile the way a layer group is parsed, with
+// one heap allocation per feature.
+static void Parse_VectorTileFeatures(benchmark::State& state) {
+    VectorTileData tile(std::make_shared<std::string>(util::read_file("test/fixtures/api/assets/streets/10-163-395.vector.pbf")));
+    const auto layers = decodeLayers(tile);
+
+    while (state.KeepRunning()) {
+        for (const auto& layer : layers) {
+            std::vector<std::unique_ptr<GeometryTileFeature>> features;
+            for (std::size_t i = 0; i < layer->featureCount(); i++) {
+                features.push_back(layer->getFeature(i));
+            }
+            benchmark::DoNotOptimize(features.data());
+        }
+    }
+}
+
+// Same, with the features created in an arena as in GeometryTileWorker::parse().
+static void Parse_VectorTileTemporaryFeatures(benchmark::State& state) {
+    VectorTileData tile(std::make_shared<std::string>(util::read_file("test/fixtures/api/assets/streets/10-163-395.vector.pbf")));
+    const auto layers = decodeLayers(tile);
+
+    while (state.KeepRunning()) {
+        for (const auto& layer : layers) {
+            util::MonotonicArena arena;
+            std::vector<const GeometryTileFeature*> features;
+            for (std::size_t i = 0; i < layer->featureCount(); i++) {
+                features.push_back(layer->getTemporaryFeature(i, arena));
+            }
+            benchmark::DoNotOptimize(features.data());
+        }
+    }
+}
+
+BENCHMARK(Parse_VectorTileFeatures);
+BENCHMARK(Parse_VectorTileTemporaryFeatures);
@@ -0,0 +1,105 @@
+#include <benchmark/benchmark.h>
+
+#include <mbgl/benchmark/stub_geometry_tile_feature.hpp>
+
+#include <mbgl/programs/attributes.hpp>
+#include <mbgl/renderer/paint_property_binder.hpp>
+#include <mbgl/style/expression/dsl.hpp>
+
+using namespace mbgl;
+using namespace mbgl::style::expression::dsl;
+
+namespace {
+
+// A tile with many features. Each one adds the number of vertices given as the
+// benchmark argument: four for circles, or more for lines and fills.
+constexpr std::size_t featureCount = 50000;
+
+std::vector<StubGeometryTileFeature> createFeatures() {
+    std::vector<StubGeometryTileFeature> features;
+    features.reserve(featureCount);
+    for (std::size_t i = 0; i < featureCount; ++i) {
+        features.emplace_back(uint64_t(i), FeatureType::Point, GeometryCollection(), PropertyMap {
+            { "x", static_cast<int64_t>(i % 100) },
+            { "class", std::string(i % 2 ? "minor" : "major") },
+        });
+    }
+    return features;
+}
+
+style::PropertyExpression<float> createSourceExpression() {
+    return { interpolate(linear(), number(get("x")), 0.0, literal(1.0), 100.0, literal(10.0)) };
+}
+
+style::PropertyExpression<float> createCompositeExpression() {
+    return { interpolate(linear(), zoom(), 10.0, number(get("x")), 16.0, literal(100.0)) };
+}
+
+template <class Binder>
+void populatePerFeature(Binder& binder, const std::vector<StubGeometryTileFeature>& features, std::size_t verticesPerFeature) {
+    for (std::size_t i = 0; i < features.size(); ++i) {
+        binder.populateVertexVector(features[i], (i + 1) * verticesPerFeature, i, {}, {}, {});
+    }
+}
+
+template <class Binder>
+void populateBatched(Binder& binder, const std::vector<StubGeometryTileFeature>& features, std::size_t verticesPerFeature) {
+    for (std::size_t i = 0; i < features.size(); ++i) {
+        binder.queueVertexVector(features[i], (i + 1) * verticesPerFeature, i, {}, {});
+    }
+    binder.populateQueuedVertexVectors();
+}
+
+using SourceBinder = SourceFunctionPaintPropertyBinder<float, attributes::radius::Type>;
+using CompositeBinder = CompositeFunctionPaintPropertyBinder<float, attributes::radius::Type>;
+
+} // namespace
+
+static void PaintPropertyBinder_SourceFunction_PerFeature(benchmark::State& state) {
+    const auto features = createFeatures();
+    const auto expression = createSourceExpression();
+
+    while (state.KeepRunning()) {
+        SourceBinder binder(expression, 0.0f);
+        populatePerFeature(binder, features, state.range(0));
+        benchmark::DoNotOptimize(binder.statistics.max());
+    }
+}
+
+static void PaintPropertyBinder_SourceFunction_Batched(benchmark::State& state) {
+    const auto features = createFeatures();
+    const auto expression = createSourceExpression();
+
+    while (state.KeepRunning()) {
+        SourceBinder binder(expression, 0.0f);
+        populateBatched(binder, features, state.range(0));
+        benchmark::DoNotOptimize(binder.statistics.max());
+    }
+}
+
+static void PaintPropertyBinder_CompositeFunction_PerFeature(benchmark::State& state) {
+    const auto features = createFeatures();
+    const auto expression = createCompositeExpression();
+
+    while (state.KeepRunning()) {
+        CompositeBinder binder(expression, 14.0f, 0.0f);
+        populatePerFeature(binder, features, state.range(0));
+        benchmark::DoNotOptimize(binder.statistics.max());
+    }
+}
+
+static void PaintPropertyBinder_CompositeFunction_Batched(benchmark::State& state) {
+    const auto features = createFeatures();
+    const auto expression = createCompositeExpression();
+
+    while (state.KeepRunning()) {
+        CompositeBinder binder(expression, 14.0f, 0.0f);
+        populateBatched(binder, features, state.range(0));
+        benchmark::DoNotOptimize(binder.statistics.max());
+    }
+}
+
+BENCHMARK(PaintPropertyBinder_SourceFunction_PerFeature)->Arg(4)->Arg(40);
+BENCHMARK(PaintPropertyBinder_SourceFunction_Batched)->Arg(4)->Arg(40);
+BENCHMARK(PaintPropertyBinder_CompositeFunction_PerFeature)->Arg(4)->Arg(40);
+BENCHMARK(PaintPropertyBinder_CompositeFunction_Batched)->Arg(4)->Arg(40);
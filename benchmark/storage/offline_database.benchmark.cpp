@@ -7,6 +7,7 @@
 #include <mbgl/util/string.hpp>
 #include <mbgl/util/logging.hpp>
 
+#include <cstdio>
 #include <random>
 
 class OfflineDatabase : public benchmark::Fixture {
@@ -194,3 +195,76 @@ BENCHMARK_F(OfflineDatabase, ResizeDatabase)(benchmark::State& state) {
         }
     }
 }
+
+namespace {
+
+// Unlike the fixture above, these benchmarks use a database file on disk, so
+// that they measure the cost of journaling and syncing. The arguments are
+// whether the write-ahead log is enabled and the write batch size.
+class OnDiskDatabase {
+public:
+    OnDiskDatabase(const benchmark::State& state) {
+        remove();
+        db = std::make_unique<mbgl::OfflineDatabase>(path);
+        db->setWriteAheadLogEnabled(state.range(0));
+        db->setWriteBatchSize(state.range(1));
+
+        response.data = std::make_shared<std::string>(50 * 1024, 0);
+        response.expires = mbgl::util::now() + std::chrono::hours(1);
+    }
+
+    ~OnDiskDatabase() {
+        db.reset();
+        remove();
+    }
+
+    static mbgl::Resource tile(int64_t i) {
+        return mbgl::Resource::tile("mapbox://tile_on_disk" + mbgl::util::toString(i), 1, 0, 0, 0,
+                                    mbgl::Tileset::Scheme::XYZ);
+    }
+
+    std::unique_ptr<mbgl::OfflineDatabase> db;
+    mbgl::Response response;
+
+private:
+    void remove() {
+        for (const char* suffix : {"", "-journal", "-wal", "-shm"}) {
+            std::remove((path + suffix).c_str());
+        }
+    }
+
+    const std::string path = "offline_database.benchmark.db";
+};
+
+void OfflineDatabase_InsertTileOnDisk(benchmark::State& state) {
+    OnDiskDatabase test(state);
+
+    while (state.KeepRunning()) {
+        test.db->put(OnDiskDatabase::tile(state.iterations()), test.response);
+    }
+    test.db->flush();
+}
+
+void OfflineDatabase_GetTileOnDisk(benchmark::State& state) {
+    OnDiskDatabase test(state);
+
+    const unsigned tileCount = 100;
+    for (unsigned i = 0; i < tileCount; ++i) {
+        test.db->put(OnDiskDatabase::tile(i), test.response);
+    }
+    test.db->flush();
+
+    std::mt19937 gen(0);
+    std::uniform_int_distribution<> dis(0, tileCount - 1);
+
+    while (state.KeepRunning()) {
+        auto res = test.db->get(OnDiskDatabase::tile(dis(gen)));
+        assert(res != nullopt);
+    }
+    test.db->flush();
+}
+
+} // namespace
+
+BENCHMARK(OfflineDatabase_InsertTileOnDisk)->Args({0, 1})->Args({1, 1})->Args({0, 64})->Args({1, 64});
+BENCHMARK(OfflineDatabase_GetTileOnDisk)->Args({0, 1})->Args({1, 1})->Args({0, 64})->Args({1, 64});
@@ -0,0 +1,102 @@
+#include <benchmark/benchmark.h>
+
+#include <mbgl/storage/offline_database.hpp>
+#include <mbgl/storage/offline_download.hpp>
+#include <mbgl/storage/online_file_source.hpp>
+#include <mbgl/storage/response.hpp>
+#include <mbgl/util/run_loop.hpp>
+
+#include <cstdio>
+#include <random>
+
+namespace {
+
+using namespace mbgl;
+
+// Stands in for the tile server: every request is answered on the next run
+// loop iteration, so that the benchmark measures the download engine and the
+// database rather than the network.
+class StandInFileSource : public OnlineFileSource {
+public:
+    StandInFileSource() {
+        std::mt19937 gen(0);
+        std::uniform_int_distribution<> dis(0, 255);
+        std::string data(16 * 1024, 0);
+        for (auto& c : data) {
+            c = static_cast<char>(dis(gen));
+        }
+        tile = std::make_shared<std::string>(std::move(data));
+    }
+
+    std::unique_ptr<AsyncRequest> request(const Resource& resource, Callback callback) override {
+        Response response;
+        response.data = resource.kind == Resource::Kind::Style ? style : tile;
+        return util::RunLoop::Get()->invokeCancellable([response, callback] { callback(response); });
+    }
+
+private:
+    const std::shared_ptr<const std::string> style = std::make_shared<std::string>(R"JSON({
+        "version": 8,
+        "sources": {
+            "tiles": { "type": "vector", "tiles": [ "http://127.0.0.1:3000/{z}/{x}/{y}.pbf" ] }
+        },
+        "layers": []
+    })JSON");
+    std::shared_ptr<const std::string> tile;
+};
+
+class CompletionObserver : public OfflineRegionObserver {
+public:
+    CompletionObserver(util::RunLoop& loop_, uint64_t& tiles_) : loop(loop_), tiles(tiles_) {
+    }
+
+    void statusChanged(OfflineRegionStatus status) override {
+        // The download is deactivated once it's complete.
+        if (status.complete() && status.downloadState == OfflineRegionDownloadState::Inactive) {
+            tiles += status.completedTileCount;
+            loop.stop();
+        }
+    }
+
+    util::RunLoop& loop;
+    uint64_t& tiles;
+};
+
+// Downloads all 1365 tiles of zoom levels 0 to 5 into a database on disk. The
+// arguments are the number of concurrent requests and the batch size.
+void OfflineDownload_Download(benchmark::State& state) {
+    const std::string path = "offline_download.benchmark.db";
+    auto remove = [&] {
+        for (const char* suffix : {"", "-journal", "-wal", "-shm"}) {
+            std::remove((path + suffix).c_str());
+        }
+    };
+
+    util::RunLoop loop;
+    StandInFileSource fileSource;
+    const OfflineTilePyramidRegionDefinition definition{ "http://127.0.0.1:3000/style.json", LatLngBounds::world(),
+                                                         0, 5, 1.0, false };
+    uint64_t tiles = 0;
+
+    while (state.KeepRunning()) {
+        state.PauseTiming();
+        remove();
+        OfflineDatabase db(path);
+        auto region = db.createRegion(definition, {});
+        state.ResumeTiming();
+
+        OfflineDownload download(region->getID(), definition, db, fileSource);
+        download.setMaximumConcurrentRequests(state.range(0));
+        download.setBatchSize(state.range(1));
+        download.setObserver(std::make_unique<CompletionObserver>(loop, tiles));
+        download.setState(OfflineRegionDownloadState::Active);
+        loop.run();
+    }
+
+    state.SetItemsProcessed(tiles);
+    remove();
+}
+
+} // namespace
+
+BENCHMARK(OfflineDownload_Download)->Args({20, 64})->Args({20, 256})->Args({64, 256})->Args({64, 1024});
@@ -0,0 +1,138 @@
+#include <benchmark/benchmark.h>
+
+#include <mbgl/renderer/buckets/symbol_bucket.hpp>
+#include <mbgl/text/cross_tile_symbol_index.hpp>
+#include <mbgl/util/string.hpp>
+
+#include <random>
+
+using namespace mbgl;
+
+namespace {
+
+// Tiles covered by the benchmark at the first zoom level, i.e. a dense city center.
+const uint8_t minZoom = 14;
+const uint8_t maxZoom = 17;
+const uint32_t tileX = 4823;
+const uint32_t tileY = 6160;
+const uint32_t tilesAcross = 2;
+
+SymbolInstance makeSymbolInstance(float x, float y, std::u16string key) {
+    GeometryCoordinates line;
+    ImageMap imageMap;
+    const ShapedTextOrientations shaping{};
+    style::SymbolLayoutProperties::Evaluated layout_;
+    IndexedSubfeature subfeature(0, "", "", 0);
+    Anchor anchor(x, y, 0, 0);
+    std::array<float, 2> textOffset{{0.0f, 0.0f}};
+    std::array<float, 2> iconOffset{{0.0f, 0.0f}};
+    std::array<float, 2> variableTextOffset{{0.0f, 0.0f}};
+    style::SymbolPlacementType placementType = style::SymbolPlacementType::Point;
+
+    auto sharedData = std::make_shared<SymbolInstanceSharedData>(std::move(line),
+                                                                 shaping,
+                                                                 nullopt,
+                                                                 nullopt,
+                                                                 layout_,
+                                                                 placementType,
+                                                                 textOffset,
+                                                                 imageMap,
+                                                                 SymbolContent::IconSDF,
+                                                                 false);
+    return SymbolInstance(anchor, std::move(sharedData), shaping, nullopt, nullopt, 0, 0, placementType, textOffset, 0, 0, iconOffset, subfeature, 0, 0, key, 0.0f, 0.0f, 0.0f, variableTextOffset, false);
+}
+
+struct TileBucket {
+    OverscaledTileID tileID;
+    std::unique_ptr<SymbolBucket> bucket;
+};
+
+// Labels with few distinct texts, like house numbers, spread over the covered
+// area. Each zoom level has its own buckets with the labels that fall into its tiles.
+std::vector<std::vector<TileBucket>> makeBuckets(std::size_t labelCount) {
+    std::mt19937 generator(42);
+    std::uniform_real_distribution<double> position(0, tilesAcross);
+    std::uniform_int_distribution<uint32_t> houseNumber(1, 200);
+
+    struct Label {
+        double x;
+        double y;
+        std::u16string key;
+    };
+    std::vector<Label> labels;
+    labels.reserve(labelCount);
+    for (std::size_t i = 0; i < labelCount; ++i) {
+        const std::string number = util::toString(houseNumber(generator));
+        labels.push_back({ position(generator), position(generator), std::u16string(number.begin(), number.end()) });
+    }
+
+    Immutable<style::SymbolLayoutProperties::PossiblyEvaluated> layout =
+        makeMutable<style::SymbolLayoutProperties::PossiblyEvaluated>();
+    uint32_t bucketInstanceId = 0;
+
+    std::vector<std::vector<TileBucket>> zoomLevels;
+    for (uint8_t z = minZoom; z <= maxZoom; ++z) {
+        const uint32_t scale = 1u << (z - minZoom);
+        const uint32_t tiles = tilesAcross * scale;
+
+        std::vector<std::vector<SymbolInstance>> instances(tiles * tiles);
+        for (const auto& label : labels) {
+            const double x = label.x * scale;
+            const double y = label.y * scale;
+            const auto column = static_cast<uint32_t>(x);
+            const auto row = static_cast<uint32_t>(y);
+            instances[row * tiles + column].push_back(makeSymbolInstance(
+                (x - column) * util::EXTENT, (y - row) * util::EXTENT, label.key));
+        }
+
+        std::vector<TileBucket> buckets;
+        for (uint32_t row = 0; row < tiles; ++row) {
+            for (uint32_t column = 0; column < tiles; ++column) {
+                auto bucket = std::make_unique<SymbolBucket>(layout,
+                                                             std::map<std::string, Immutable<style::LayerProperties>>(),
+                                                             16.0f,
+                                                             1.0f,
+                                                             0,
+                                                             false /*iconsNeedLinear*/,
+                                                             false /*sortFeaturesByY*/,
+                                                             "test",
+                                                             std::move(instances[row * tiles + column]),
+                                                             1.0f,
+                                                             false,
+                                                             std::vector<style::TextWritingModeType>(),
+                                                             false /*iconsInText*/);
+                bucket->bucketInstanceId = ++bucketInstanceId;
+                buckets.push_back({ OverscaledTileID(z, 0, z, tileX * scale + column, tileY * scale + row),
+                                    std::move(bucket) });
+            }
+        }
+        zoomLevels.push_back(std::move(buckets));
+    }
+    return zoomLevels;
+}
+
+} // namespace
+
+// Zooms in level by level, the way the renderer updates the index: the tiles of
+// the new zoom level are added while the ones of the previous level are still
+// shown, and the latter are removed afterwards.
+static void CrossTileSymbolIndex_ZoomIn(benchmark::State& state) {
+    const auto zoomLevels = makeBuckets(state.range(0));
+    uint32_t maxCrossTileID = 0;
+
+    while (state.KeepRunning()) {
+        CrossTileSymbolLayerIndex index;
+        for (const auto& buckets : zoomLevels) {
+            std::unordered_set<uint32_t> currentIDs;
+            for (const auto& tile : buckets) {
+                index.addBucket(tile.tileID, *tile.bucket, maxCrossTileID);
+                currentIDs.insert(tile.bucket->bucketInstanceId);
+            }
+            index.removeStaleBuckets(currentIDs);
+        }
+    }
+
+    benchmark::DoNotOptimize(maxCrossTileID);
+}
+
+BENCHMARK(CrossTileSymbolIndex_ZoomIn)->Arg(1000)->Arg(10000)->Arg(50000);
@@ -0,0 +1,104 @@
+#include <benchmark/benchmark.h>
+
+#include <mbgl/geometry/feature_index.hpp>
+#include <mbgl/util/grid_index.hpp>
+
+#include <random>
+
+using namespace mbgl;
+
+namespace {
+
+using Grid = GridIndex<IndexedSubfeature>;
+
+// Viewport sized grid with the cell size used by CollisionIndex.
+const float gridWidth = 1024 + 2 * 100;
+const float gridHeight = 768 + 2 * 100;
+const uint32_t cellSize = 25;
+
+struct Candidate {
+    Grid::BBox box;
+    std::vector<Grid::BCircle> circles;
+};
+
+// Point labels are boxes, line labels are runs of circles along the line.
+std::vector<Candidate> makeCandidates(std::size_t count) {
+    std::mt19937 generator(42);
+    std::uniform_real_distribution<float> x(0, gridWidth);
+    std::uniform_real_distribution<float> y(0, gridHeight);
+    std::uniform_real_distribution<float> size(8, 64);
+
+    std::vector<Candidate> candidates;
+    candidates.reserve(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        Candidate candidate { { { x(generator), y(generator) }, { 0, 0 } }, {} };
+        candidate.box.max = { candidate.box.min.x + size(generator), candidate.box.min.y + size(generator) / 4 };
+        if (i % 4 == 0) {
+            for (int j = 0; j < 8; ++j) {
+                candidate.circles.push_back({ { candidate.box.min.x + j * 6, candidate.box.min.y }, 4 });
+            }
+        }
+        candidates.push_back(std::move(candidate));
+    }
+    return candidates;
+}
+
+bool allowAll(const IndexedSubfeature&) {
+    return true;
+}
+
+} // namespace
+
+// Places labels the way CollisionIndex does: test for a collision and insert
+// the label if there's none.
+static void GridIndex_Placement(benchmark::State& state) {
+    const auto candidates = makeCandidates(state.range(0));
+    std::size_t placed = 0;
+
+    while (state.KeepRunning()) {
+        Grid grid(gridWidth, gridHeight, cellSize);
+        for (std::size_t i = 0; i < candidates.size(); ++i) {
+            const Candidate& candidate = candidates[i];
+            if (candidate.circles.empty()) {
+                if (!grid.hitTest(candidate.box, allowAll)) {
+                    grid.insert(IndexedSubfeature(i, "", "", i), candidate.box);
+                    placed++;
+                }
+            } else {
+                bool collides = false;
+                for (const auto& circle : candidate.circles) {
+                    collides = collides || grid.hitTest(circle, allowAll);
+                }
+                if (!collides) {
+                    for (const auto& circle : candidate.circles) {
+                        grid.insert(IndexedSubfeature(i, "", "", i), circle);
+                    }
+                    placed++;
+                }
+            }
+        }
+    }
+
+    benchmark::DoNotOptimize(placed);
+}
+
+// Queries a densely filled index, like queryRenderedFeatures does.
+static void GridIndex_Query(benchmark::State& state) {
+    const auto candidates = makeCandidates(state.range(0));
+    Grid grid(gridWidth, gridHeight, cellSize);
+    for (std::size_t i = 0; i < candidates.size(); ++i) {
+        grid.insert(IndexedSubfeature(i, "", "", i), candidates[i].box);
+    }
+
+    std::size_t results = 0;
+    while (state.KeepRunning()) {
+        for (const auto& candidate : candidates) {
+            results += grid.query(candidate.box).size();
+        }
+    }
+
+    benchmark::DoNotOptimize(results);
+}
+
+BENCHMARK(GridIndex_Placement)->Arg(1000)->Arg(10000)->Arg(50000);
+BENCHMARK(GridIndex_Query)->Arg(1000)->Arg(10000);
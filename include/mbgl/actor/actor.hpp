@@ -65,6 +65,12 @@ public:
         return parent.self();
     }
 
+    // Sets the priority at which the scheduler processes messages sent to
+    // this actor; see `Mailbox::setPriority()`.
+    void setPriority(double priority) {
+        parent.mailbox->setPriority(priority);
+    }
+
 private:
     std::shared_ptr<Scheduler> retainer;
     AspiringActor<Object> parent;
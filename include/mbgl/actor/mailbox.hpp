@@ -1,7 +1,9 @@
 #pragma once
 
+#include <mbgl/actor/scheduler.hpp>
 #include <mbgl/util/optional.hpp>
 
+#include <atomic>
 #include <functional>
 #include <memory>
 #include <mutex>
@@ -9,7 +11,6 @@
 
 namespace mbgl {
 
-class Scheduler;
 class Message;
 
 class Mailbox : public std::enable_shared_from_this<Mailbox> {
@@ -31,6 +32,11 @@ public:
 
     bool isOpen() const;
 
+    // Makes the scheduler process this mailbox in order of the given priority,
+    // relative to other prioritized mailboxes. Lower values are processed first.
+    // May be called at any time, including while messages are pending.
+    void setPriority(double);
+
     void push(std::unique_ptr<Message>);
     void receive();
 
@@ -38,6 +44,8 @@ public:
     static std::function<void()> makeClosure(std::weak_ptr<Mailbox>);
 
 private:
+    void scheduleReceive();
+
     optional<Scheduler*> scheduler;
 
     std::recursive_mutex receivingMutex;
@@ -47,6 +55,9 @@ private:
 
     std::mutex queueMutex;
     std::queue<std::unique_ptr<Message>> queue;
+
+    std::atomic<bool> prioritized { false };
+    TaskPriority priority { 0 };
 };
 
 } // namespace mbgl
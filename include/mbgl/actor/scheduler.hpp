@@ -2,6 +2,7 @@
 
 #include <mapbox/weak.hpp>
 
+#include <atomic>
 #include <functional>
 #include <memory>
 
@@ -26,6 +27,34 @@ private:
 template <typename T>
 using PassRefPtr = Pass<std::shared_ptr<T>>;
 
+// The priority of a task that can change while the task is pending.
+// Lower values are more urgent.
+class TaskPriority {
+public:
+    TaskPriority(double value_ = 0) : value(value_) {}
+
+    TaskPriority& operator=(double value_) {
+        if (value.exchange(value_) != value_) {
+            changes()++;
+        }
+        return *this;
+    }
+
+    double load() const { return value.load(); }
+
+    // Counts the changes made to any priority, so that schedulers keeping
+    // tasks ordered by priority know when to re-order them.
+    static std::size_t generation() { return changes().load(); }
+
+private:
+    static std::atomic<std::size_t>& changes() {
+        static std::atomic<std::size_t> count{0};
+        return count;
+    }
+
+    std::atomic<double> value;
+};
+
 /*
     A `Scheduler` is responsible for coordinating the processing of messages by
     one or more actors via their mailboxes. It's an abstract interface. Currently,
@@ -54,6 +83,13 @@ public:
 
     // Enqueues a function for execution.
     virtual void schedule(std::function<void()>) = 0;
+    // Enqueues a function for execution ordered by the value |priority| holds
+    // at the time a thread picks its next task, so that pending work can be
+    // re-prioritized in place. Schedulers without a notion of priority run
+    // the function like any other scheduled one.
+    virtual void scheduleWithPriority(std::function<void()> fn, std::weak_ptr<const TaskPriority>) {
+        schedule(std::move(fn));
+    }
     // Makes a weak pointer to this Scheduler.
     virtual mapbox::base::WeakPtr<Scheduler> makeWeakPtr() = 0;
 
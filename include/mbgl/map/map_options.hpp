@@ -88,6 +88,43 @@ public:
      */
     bool crossSourceCollisions() const;
 
+    /**
+     * @brief Specify whether a single vector tile is parsed using multiple
+     * threads, processing its independent layout groups in parallel. This
+     * cuts the latency of individual heavy tiles, e.g. for still image
+     * rendering, at the cost of some scheduling overhead. By default, it is
+     * set to false.
+     *
+     * @param enableParallelParsing true to enable, false to disable
+     * @return MapOptions for chaining options together.
+     */
+    MapOptions& withParallelTileParsing(bool enableParallelParsing);
+
+    /**
+     * @brief Gets the previously set (or default) parallelTileParsing value.
+     *
+     * @return true if parallel tile parsing is enabled, false otherwise.
+     */
+    bool parallelTileParsing() const;
+
+    /**
+     * @brief Limits the memory used by the tiles each source keeps cached
+     * for reuse after they went out of view, including their GPU buffers.
+     * The least recently used tiles are evicted first. By default, it is set
+     * to 0, which leaves the cache limited by tile count only.
+     *
+     * @param bytes Maximum memory usage of the cache, in bytes.
+     * @return MapOptions for chaining options together.
+     */
+    MapOptions& withTileCacheMemoryLimit(std::size_t bytes);
+
+    /**
+     * @brief Gets the previously set (or default) tile cache memory limit.
+     *
+     * @return Maximum memory usage of each source's tile cache, in bytes.
+     */
+    std::size_t tileCacheMemoryLimit() const;
+
     /**
      * @brief Sets the orientation of the Map. By default, it is set to
      * Upwards.
@@ -2,8 +2,10 @@
 
 #include <mbgl/renderer/query.hpp>
 #include <mbgl/annotation/annotation.hpp>
+#include <mbgl/util/chrono.hpp>
 #include <mbgl/util/geo.hpp>
 #include <mbgl/util/geojson.hpp>
+#include <mbgl/util/optional.hpp>
 
 #include <functional>
 #include <memory>
@@ -58,6 +60,17 @@ public:
     void removeFeatureState(const std::string& sourceID, const optional<std::string>& sourceLayerID,
                             const optional<std::string>& featureID, const optional<std::string>& stateKey);
 
+    // Limits the time spent on symbol placement in a single frame of a
+    // continuous map. A placement that takes longer is resumed in the next
+    // frames, and labels are updated once it is complete. Unlimited by default.
+    void setSymbolPlacementTimeBudget(optional<Duration>);
+
+    // Computes the symbol placement of a continuous map on a worker thread.
+    // Frames are rendered with the previous placement until the new one is
+    // done, and symbols of newly loaded tiles show up once it's swapped in.
+    // Disabled by default.
+    void setBackgroundSymbolPlacement(bool);
+
     // Debug
     void dumpDebugLogs();
 
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
 #include <exception>
 
@@ -29,6 +30,10 @@ public:
     // End of frame, booleans flags that a repaint is required and that placement changed.
     virtual void onDidFinishRenderingFrame(RenderMode, bool /*repaint*/, bool /*placementChanged*/) {}
 
+    // Symbol placement ran out of its time budget in this frame, and will
+    // place the given number of remaining symbol buckets in the next frames.
+    virtual void onSymbolPlacementDeferred(std::size_t /*remainingBuckets*/) {}
+
     // Final frame
     virtual void onDidFinishRenderingMap() {}
 
@@ -148,6 +148,18 @@ public:
      */
     void setOfflineMapboxTileCountLimit(uint64_t) const;
 
+    /*
+     * Sets the number of resources each offline region download requests at
+     * the same time, and the number of downloaded resources it stores in a
+     * single database transaction.
+     *
+     * By default, a download requests as many resources as the network allows
+     * concurrent requests (see setMaximumConcurrentRequests()), and stores them
+     * in batches of 256.
+     */
+    void setMaximumConcurrentOfflineRequests(uint32_t);
+    void setOfflineDownloadBatchSize(uint32_t);
+
     /*
      * Pause file request activity.
      *
@@ -206,6 +218,42 @@ public:
      */
     void runPackDatabaseAutomatically(bool);
 
+    /*
+     * Sets whether the database uses a write-ahead log instead of a rollback
+     * journal.
+     *
+     * A write-ahead log makes writing to the database considerably cheaper, but
+     * the most recent writes may be lost on power failure. By default, it is
+     * disabled.
+     */
+    void setWriteAheadLogEnabled(bool);
+
+    /*
+     * Sets the maximum number of ambient cache writes, including access time
+     * updates for cache hits, that are grouped into a single transaction.
+     *
+     * Pending writes are committed at least once per second. By default, the
+     * batch size is 1, which commits every write immediately.
+     */
+    void setAmbientCacheWriteBatchSize(uint32_t);
+
+    /*
+     * Sets the maximum size in bytes of the in-memory cache that holds the
+     * most recently used responses of the ambient cache and offline regions.
+     *
+     * Requests for resources found in this cache are answered without a
+     * database lookup. Setting the size to 0 disables the cache. By default,
+     * it is 8 MB.
+     */
+    void setMaximumMemoryCacheSize(uint64_t);
+
+    /*
+     * Number of cache lookups that were, or were not, answered by the
+     * in-memory cache.
+     */
+    uint64_t getMemoryCacheHits() const;
+    uint64_t getMemoryCacheMisses() const;
+
     /*
      * Forces revalidation of the ambient cache.
      *
@@ -255,6 +303,15 @@ public:
      */
     void setMaximumAmbientCacheSize(uint64_t size, std::function<void (std::exception_ptr)> callback);
 
+    /*
+     * Sets the maximum number of network requests to a single host that are
+     * in flight at the same time.
+     *
+     * Pending requests to other hosts are started while the limit is reached.
+     * Setting the limit to 0 (the default) disables it.
+     */
+    void setMaximumConcurrentRequestsPerHost(uint32_t);
+
     // For testing only.
     void setOnlineStatus(bool);
     void setMaximumConcurrentRequests(uint32_t);
@@ -262,8 +319,11 @@ public:
     class Impl;
 
 private:
+    class MemoryCache;
+
     // Shared so destruction is done on this thread
     const std::shared_ptr<FileSource> assetFileSource;
+    const std::shared_ptr<MemoryCache> memoryCache;
     const std::unique_ptr<util::Thread<Impl>> impl;
 
     std::mutex cachedBaseURLMutex;
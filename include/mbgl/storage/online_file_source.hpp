@@ -27,6 +27,12 @@ public:
     void setMaximumConcurrentRequests(uint32_t);
     uint32_t getMaximumConcurrentRequests() const;
 
+    // Limits the number of requests to a single host that are in flight at
+    // the same time, so that one slow server can't hold up the others. A
+    // limit of 0 (the default) disables the per-host limit.
+    void setMaximumConcurrentRequestsPerHost(uint32_t);
+    uint32_t getMaximumConcurrentRequestsPerHost() const;
+
     // For testing only.
     void setOnlineStatus(bool);
 
@@ -86,6 +86,9 @@ public:
     LoadingMethod loadingMethod;
     Usage usage{ Usage::Online };
     Priority priority{ Priority::Regular };
+    // Orders requests of the same kind and priority; lower values are loaded
+    // first. Tiles use their distance from the center of the viewport.
+    double order = 0;
     std::string url;
 
     // Includes auxiliary data if this is a tile request.
@@ -7,9 +7,16 @@
 #include <mbgl/style/expression/find_zoom_curve.hpp>
 #include <mbgl/util/range.hpp>
 
+#include <type_traits>
+#include <vector>
+
 namespace mbgl {
 namespace style {
 
+namespace expression {
+class CompiledNumber;
+} // namespace expression
+
 class PropertyExpressionBase {
 public:
     explicit PropertyExpressionBase(std::unique_ptr<expression::Expression>);
@@ -24,7 +31,11 @@ public:
     bool useIntegerZoom = false;
 
 protected:
+    // Evaluates a number-typed expression with its compiled program, see CompiledNumber.
+    optional<double> evaluateNumber(const expression::EvaluationContext&) const;
+
     std::shared_ptr<const expression::Expression> expression;
+    std::shared_ptr<const expression::CompiledNumber> compiledNumber;
     variant<std::nullptr_t, const expression::Interpolate*, const expression::Step*> zoomCurve;
     bool isZoomConstant_;
     bool isFeatureConstant_;
@@ -41,12 +52,8 @@ public:
     }
 
     T evaluate(const expression::EvaluationContext& context, T finalDefaultValue = T()) const {
-        const expression::EvaluationResult result = expression->evaluate(context);
-        if (result) {
-            const optional<T> typed = expression::fromExpressionValue<T>(*result);
-            return typed ? *typed : defaultValue ? *defaultValue : finalDefaultValue;
-        }
-        return defaultValue ? *defaultValue : finalDefaultValue;
+        const optional<T> typed = evaluateTyped(context, std::is_same<T, float>());
+        return typed ? *typed : defaultValue ? *defaultValue : finalDefaultValue;
     }
 
     T evaluate(float zoom) const {
@@ -85,6 +92,26 @@ public:
         return evaluate(expression::EvaluationContext(zoom, &feature, &state), finalDefaultValue);
     }
 
+    // Evaluates the expression for each of the features at the given zoom, and
+    // stores the results in `result`, in the same order.
+    void evaluate(optional<float> zoom,
+                  const std::vector<const GeometryTileFeature*>& features,
+                  const T& finalDefaultValue,
+                  std::vector<T>& result) const {
+        assert(!isFeatureConstant());
+        const T& fallback = defaultValue ? *defaultValue : finalDefaultValue;
+        expression::EvaluationContext context;
+        context.zoom = zoom;
+
+        result.clear();
+        result.reserve(features.size());
+        for (const GeometryTileFeature* feature : features) {
+            context.feature = feature;
+            optional<T> typed = evaluateTyped(context, std::is_same<T, float>());
+            result.push_back(typed ? std::move(*typed) : fallback);
+        }
+    }
+
     std::vector<optional<T>> possibleOutputs() const {
         return expression::fromExpressionValues<T>(expression->possibleOutputs());
     }
@@ -95,6 +122,19 @@ public:
     }
 
 private:
+    optional<T> evaluateTyped(const expression::EvaluationContext& context, std::true_type) const {
+        if (compiledNumber) {
+            const optional<double> result = evaluateNumber(context);
+            return result ? optional<T>(static_cast<T>(*result)) : nullopt;
+        }
+        return evaluateTyped(context, std::false_type());
+    }
+
+    optional<T> evaluateTyped(const expression::EvaluationContext& context, std::false_type) const {
+        const expression::EvaluationResult result = expression->evaluate(context);
+        return result ? expression::fromExpressionValue<T>(*result) : nullopt;
+    }
+
     optional<T> defaultValue;
 };
 
@@ -7,6 +7,10 @@ namespace mbgl {
 class AsyncRequest : private util::noncopyable {
 public:
     virtual ~AsyncRequest() = default;
+
+    // Updates the order in which a pending request is processed relative to
+    // other requests of the same kind. Lower values are processed first.
+    virtual void setPriority(double) {}
 };
 
 } // namespace mbgl
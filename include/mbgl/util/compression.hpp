@@ -1,10 +1,84 @@
 #pragma once
 
+#include <cstddef>
+#include <memory>
 #include <string>
+#include <vector>
 
 namespace mbgl {
 namespace util {
 
+class CompressionPool;
+
+// Compresses data incrementally with zlib. Instances created with a pool
+// borrow their zlib stream from it, so creating them is cheap.
+class Compressor {
+public:
+    Compressor();
+    explicit Compressor(CompressionPool&);
+    ~Compressor();
+
+    // Compresses |size| bytes and appends any output to |out|.
+    void write(const char* data, std::size_t size, std::string& out);
+
+    // Appends the remaining output to |out|. Afterwards, the compressor can
+    // be used for another stream.
+    void finish(std::string& out);
+
+    class Stream;
+
+private:
+    CompressionPool* pool = nullptr;
+    std::unique_ptr<Stream> stream;
+};
+
+// Decompresses zlib or gzip data incrementally. Instances created with a pool
+// borrow their zlib stream from it, so creating them is cheap.
+class Decompressor {
+public:
+    Decompressor();
+    explicit Decompressor(CompressionPool&);
+    ~Decompressor();
+
+    // Decompresses |size| bytes and appends any output to |out|.
+    void write(const char* data, std::size_t size, std::string& out);
+
+    // Throws if the stream was incomplete. Afterwards, the decompressor can
+    // be used for another stream.
+    void finish();
+
+    class Stream;
+
+private:
+    CompressionPool* pool = nullptr;
+    std::unique_ptr<Stream> stream;
+    bool ended = false;
+};
+
+// Keeps the zlib streams of finished compressors and decompressors around for
+// later ones, as setting them up is expensive. A pool is owned by the object
+// that compresses or decompresses data, and frees its streams along with it.
+// Not thread-safe.
+class CompressionPool {
+public:
+    CompressionPool();
+    ~CompressionPool();
+    CompressionPool(const CompressionPool&) = delete;
+    CompressionPool& operator=(const CompressionPool&) = delete;
+
+    std::string compress(const std::string& raw);
+    std::string decompress(const std::string& raw);
+
+private:
+    friend class Compressor;
+    friend class Decompressor;
+
+    std::vector<std::unique_ptr<Compressor::Stream>> compressors;
+    std::vector<std::unique_ptr<Decompressor::Stream>> decompressors;
+};
+
+// Compress or decompress with a stream of their own. Prefer a CompressionPool
+// for repeated use.
 std::string compress(const std::string& raw);
 std::string decompress(const std::string& raw);
 
@@ -195,6 +195,7 @@ target_sources(
         ${MBGL_ROOT}/platform/default/src/mbgl/storage/file_source_request.cpp
         ${MBGL_ROOT}/platform/default/src/mbgl/storage/local_file_request.cpp
         ${MBGL_ROOT}/platform/default/src/mbgl/storage/local_file_source.cpp
+        ${MBGL_ROOT}/platform/default/src/mbgl/storage/mbtiles_file_source.cpp
         ${MBGL_ROOT}/platform/default/src/mbgl/storage/offline.cpp
         ${MBGL_ROOT}/platform/default/src/mbgl/storage/offline_database.cpp
         ${MBGL_ROOT}/platform/default/src/mbgl/storage/offline_download.cpp
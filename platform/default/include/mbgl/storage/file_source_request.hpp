@@ -17,13 +17,17 @@ public:
     ~FileSourceRequest() final;
 
     void onCancel(std::function<void()>&& callback);
+    void onPriorityChange(std::function<void(double)>&& callback);
     void setResponse(const Response& res);
 
+    void setPriority(double) final;
+
     ActorRef<FileSourceRequest> actor();
 
 private:
     FileSource::Callback responseCallback = nullptr;
     std::function<void()> cancelCallback = nullptr;
+    std::function<void(double)> priorityCallback = nullptr;
 
     std::shared_ptr<Mailbox> mailbox;
 };
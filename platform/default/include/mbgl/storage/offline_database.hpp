@@ -8,17 +8,22 @@
 #include <mbgl/util/constants.hpp>
 #include <mbgl/util/mapbox.hpp>
 #include <mbgl/util/expected.hpp>
+#include <mbgl/util/chrono.hpp>
 
 #include <unordered_map>
 #include <memory>
 #include <string>
 #include <list>
+#include <map>
+#include <tuple>
+#include <vector>
 
 namespace mapbox {
 namespace sqlite {
 class Database;
 class Statement;
 class Query;
+class Transaction;
 class Exception;
 } // namespace sqlite
 } // namespace mapbox
@@ -36,6 +41,19 @@ struct MapboxTileLimitExceededException :  util::Exception {
     MapboxTileLimitExceededException() : util::Exception("Mapbox tile limit exceeded") {}
 };
 
+// Compresses the data of cached resources. Every row records the id of the
+// codec that compressed it, so rows written with different codecs can be
+// read side by side, as long as all of them are registered. Id 0 means
+// uncompressed, and id 1 is the built-in zlib codec.
+class OfflineDatabaseCodec {
+public:
+    virtual ~OfflineDatabaseCodec() = default;
+
+    virtual uint8_t id() const = 0;
+    virtual std::string compress(const std::string&) const = 0;
+    virtual std::string decompress(const std::string&) const = 0;
+};
+
 class OfflineDatabase : private util::noncopyable {
 public:
     // Limits affect ambient caching (put) only; resources required by offline
@@ -81,7 +99,15 @@ public:
     optional<std::pair<Response, uint64_t>> getRegionResource(const Resource&);
     optional<int64_t> hasRegionResource(const Resource&);
     uint64_t putRegionResource(int64_t regionID, const Resource&, const Response&);
-    void putRegionResources(int64_t regionID, const std::list<std::tuple<Resource, Response>>&, OfflineRegionStatus&);
+    // Return value is the stored size of each resource, or empty if the batch
+    // wasn't stored completely.
+    std::vector<uint64_t> putRegionResources(int64_t regionID, const std::list<std::tuple<Resource, Response>>&, OfflineRegionStatus&);
+
+    // Progress of an offline download, identified by |key|: the number of
+    // resources at the beginning of the download order that are stored in the
+    // region, and their total size. Returns (0, 0) if there's none.
+    std::pair<uint64_t, uint64_t> getRegionDownloadCheckpoint(int64_t regionID, const std::string& key);
+    void putRegionDownloadCheckpoint(int64_t regionID, const std::string& key, uint64_t count, uint64_t size);
 
     expected<OfflineRegionDefinition, std::exception_ptr> getRegionDefinition(int64_t regionID);
     expected<OfflineRegionStatus, std::exception_ptr> getRegionCompletedStatus(int64_t regionID);
@@ -92,10 +118,32 @@ public:
     bool offlineMapboxTileCountLimitExceeded();
     uint64_t getOfflineMapboxTileCount();
     bool exceedsOfflineMapboxTileCountLimit(const Resource&);
-    void markUsedResources(int64_t regionID, const std::list<Resource>&);
+    // Return value is false if the resources couldn't be marked.
+    bool markUsedResources(int64_t regionID, const std::list<Resource>&);
     std::exception_ptr pack();
     void runPackDatabaseAutomatically(bool autopack_) { autopack = autopack_; }
 
+    // Switches the database to a write-ahead log with NORMAL synchronization,
+    // which makes writes considerably cheaper at the risk of losing the most
+    // recent transactions on power loss. Disabled by default.
+    void setWriteAheadLogEnabled(bool);
+
+    // Groups up to |size| ambient cache writes into a single transaction.
+    // Batched writes are visible to subsequent reads right away, but are only
+    // persisted once the batch is full or flush() is called. Reads are never
+    // part of a batch. A size of 1 (the default) commits every write
+    // immediately.
+    void setWriteBatchSize(uint32_t size);
+
+    // Registers a codec for reading, and uses it to compress new writes.
+    // Databases containing rows written with a custom codec can't be read
+    // without it.
+    void setCompressionCodec(std::shared_ptr<const OfflineDatabaseCodec>);
+    bool hasPendingWrites() const {
+        return batch || !pendingResourceAccessTimes.empty() || !pendingTileAccessTimes.empty();
+    }
+    void flush();
+
 private:
     void initialize();
     void handleError(const mapbox::sqlite::Exception&, const char* action);
@@ -112,18 +160,29 @@ private:
     void cleanup();
     bool disabled();
     void vacuum();
+    void applyJournalMode();
+    void createCheckpointTable();
+
+    bool beginBatchedWrite();
+    void endBatchedWrite();
+    void commitBatch();
+
+    void updateAccessTimes();
+    void flushAccessTimes();
 
     mapbox::sqlite::Statement& getStatement(const char *);
 
     optional<std::pair<Response, uint64_t>> getTile(const Resource::TileData&);
     optional<int64_t> hasTile(const Resource::TileData&);
     bool putTile(const Resource::TileData&, const Response&,
-                 const std::string&, bool compressed);
+                 const std::string&, uint8_t compression);
 
     optional<std::pair<Response, uint64_t>> getResource(const Resource&);
     optional<int64_t> hasResource(const Resource&);
     bool putResource(const Resource&, const Response&,
-                     const std::string&, bool compressed);
+                     const std::string&, uint8_t compression);
+
+    std::shared_ptr<const std::string> decompress(std::string&&, int codecID) const;
 
     uint64_t putRegionResourceInternal(int64_t regionID, const Resource&, const Response&);
 
@@ -144,6 +203,9 @@ private:
     template <class T>
     T getPragma(const char *);
 
+    std::shared_ptr<const OfflineDatabaseCodec> compressionCodec;
+    std::unordered_map<int, std::shared_ptr<const OfflineDatabaseCodec>> codecs;
+
     uint64_t maximumAmbientCacheSize = util::DEFAULT_MAX_CACHE_SIZE;
     uint64_t offlineMapboxTileCountLimit = util::mapbox::DEFAULT_OFFLINE_TILE_COUNT_LIMIT;
 
@@ -151,6 +213,19 @@ private:
 
     bool evict(uint64_t neededFreeSize);
     bool autopack = true;
+
+    bool writeAheadLog = false;
+    uint32_t writeBatchSize = 1;
+    uint32_t batchedWrites = 0;
+    std::unique_ptr<mapbox::sqlite::Transaction> batch;
+
+    // Access times recorded by get() that haven't been written to the
+    // database yet. They are rounded down to accessTimeGranularity, and are
+    // written in bulk before evicting, when flushing, or once there are too
+    // many of them.
+    using TileKey = std::tuple<std::string, uint8_t, int32_t, int32_t, int8_t>;
+    std::map<std::string, Timestamp> pendingResourceAccessTimes;
+    std::map<TileKey, Timestamp> pendingTileAccessTimes;
 };
 
 } // namespace mbgl
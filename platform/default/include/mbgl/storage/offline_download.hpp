@@ -3,8 +3,10 @@
 #include <mbgl/storage/offline.hpp>
 #include <mbgl/storage/resource.hpp>
 #include <mbgl/storage/online_file_source.hpp>
+#include <mbgl/util/tile_cover.hpp>
 
 #include <list>
+#include <map>
 #include <unordered_set>
 #include <memory>
 #include <deque>
@@ -36,7 +38,55 @@ public:
 
     OfflineRegionStatus getStatus() const;
 
+    // Number of resources that are requested at the same time. Defaults to the
+    // maximum number of concurrent requests of the online file source.
+    void setMaximumConcurrentRequests(uint32_t);
+
+    // Number of downloaded resources that are stored in a single transaction.
+    void setBatchSize(uint32_t);
+
 private:
+    /*
+     * The tiles of a tileset are requested in the order of their tile cover. The
+     * number of tiles at the beginning of that order that are stored in the region,
+     * i.e. that were found in or committed to the database, is saved as a checkpoint.
+     * When the download is resumed, these tiles are skipped without checking the
+     * database for each of them.
+     */
+    struct Checkpoint {
+        std::string key;
+        uint64_t queued = 0;
+        uint64_t count = 0;
+        uint64_t size = 0;
+        uint64_t saved = 0;
+
+        // Sizes of stored tiles past the end of the checkpoint, by position.
+        std::map<uint64_t, uint64_t> stored;
+    };
+
+    struct CheckpointPosition {
+        Checkpoint* checkpoint;
+        uint64_t index;
+    };
+
+    struct QueuedResource {
+        Resource resource;
+        optional<CheckpointPosition> position;
+    };
+
+    /*
+     * The tiles of a tileset that are yet to be requested. They are produced from
+     * the tile cover of one zoom level at a time as the download progresses, so
+     * memory use doesn't grow with the number of tiles in the region.
+     */
+    struct TileQueue {
+        Tileset tileset;
+        Range<uint8_t> zoomRange;
+        uint8_t zoom;
+        std::unique_ptr<util::TileCover> cover;
+        Checkpoint* checkpoint;
+    };
+
     void activateDownload();
     void continueDownload();
     void deactivateDownload();
@@ -46,7 +96,7 @@ private:
      * While the request is in progress, it is recorded in `requests`. If the download
      * is deactivated, all in progress requests are cancelled.
      */
-    void ensureResource(Resource&&, std::function<void (Response)> = {});
+    void ensureResource(Resource&&, std::function<void (Response)> = {}, optional<CheckpointPosition> = {});
 
     void onMapboxTileCountLimitExceeded();
 
@@ -59,13 +109,25 @@ private:
 
     std::list<std::unique_ptr<AsyncRequest>> requests;
     std::unordered_set<std::string> requiredSourceURLs;
-    std::deque<Resource> resourcesRemaining;
+    std::deque<QueuedResource> resourcesRemaining;
+    std::list<TileQueue> tileQueues;
     std::list<Resource> resourcesToBeMarkedAsUsed;
     std::list<std::tuple<Resource, Response>> buffer;
+    std::list<optional<CheckpointPosition>> bufferPositions;
+    std::list<std::pair<CheckpointPosition, uint64_t>> usedPositions;
+    std::list<Checkpoint> checkpoints;
+
+    optional<uint32_t> maximumConcurrentRequests;
+    uint32_t batchSize;
 
     void queueResource(Resource&&);
     void queueTiles(style::SourceType, uint16_t tileSize, const Tileset&);
+    bool prepareTiles(TileQueue&);
+    optional<QueuedResource> nextTile();
     void markPendingUsedResources();
+    void flushBuffer();
+    void markStored(const optional<CheckpointPosition>&, uint64_t size);
+    void saveCheckpoints();
 };
 
 } // namespace mbgl
@@ -30,7 +30,8 @@ CREATE TABLE resources (
 
   data BLOB,                                       -- Contents of the resource.
 
-  compressed INTEGER NOT NULL DEFAULT 0,           -- If the resource is compressed with Deflate or not. Compression is
+  compressed INTEGER NOT NULL DEFAULT 0,           -- Codec the resource is compressed with: 0 if uncompressed, 1 for
+                                                   -- Deflate, or the id of a custom OfflineDatabaseCodec. Compression is
                                                    -- optional and should be used when the compression ratio is
                                                    -- significant. Using compression will make decoding time slower
                                                    -- because it will add an extra decompression step.
@@ -77,7 +78,8 @@ CREATE TABLE tiles (
 
   data BLOB,                                       -- Contents of the tile.
 
-  compressed INTEGER NOT NULL DEFAULT 0,           -- If the tile is compressed with Deflate or not. Compression is
+  compressed INTEGER NOT NULL DEFAULT 0,           -- Codec the tile is compressed with: 0 if uncompressed, 1 for
+                                                   -- Deflate, or the id of a custom OfflineDatabaseCodec. Compression is
                                                    -- optional and should be used when the compression ratio is
                                                    -- significant. Using compression will make decoding time slower
                                                    -- because it will add an extra decompression step.
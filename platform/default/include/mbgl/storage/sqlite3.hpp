@@ -66,6 +66,7 @@ class Statement;
 class StatementImpl;
 class Query;
 class Transaction;
+class Savepoint;
 
 void setTempPath(const std::string&);
 
@@ -91,6 +92,7 @@ private:
 
     friend class Statement;
     friend class Transaction;
+    friend class Savepoint;
 };
 
 // A Statement object represents a prepared statement that can be run repeatedly run with a Query object.
@@ -176,5 +178,26 @@ private:
     bool needRollback = true;
 };
 
+// A Savepoint marks a point within a transaction that can be rolled back to
+// without rolling back the rest of the transaction. Destroying a Savepoint
+// that wasn't released rolls back to it.
+class Savepoint {
+public:
+    Savepoint(const Savepoint&) = delete;
+    Savepoint(Savepoint&&) = delete;
+    Savepoint& operator=(const Savepoint&) = delete;
+
+    Savepoint(Database&, const char* name);
+    ~Savepoint();
+
+    void release();
+    void rollback();
+
+private:
+    DatabaseImpl& dbImpl;
+    const std::string name;
+    bool needRollback = true;
+};
+
 } // namespace sqlite
 } // namespace mapbox
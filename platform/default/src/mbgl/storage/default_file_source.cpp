@@ -2,27 +2,263 @@
 #include <mbgl/storage/asset_file_source.hpp>
 #include <mbgl/storage/file_source_request.hpp>
 #include <mbgl/storage/local_file_source.hpp>
+#include <mbgl/storage/mbtiles_file_source.hpp>
 #include <mbgl/storage/online_file_source.hpp>
 #include <mbgl/storage/offline_database.hpp>
 #include <mbgl/storage/offline_download.hpp>
 #include <mbgl/storage/resource_transform.hpp>
 
 #include <mbgl/util/platform.hpp>
+#include <mbgl/util/string.hpp>
 #include <mbgl/util/url.hpp>
 #include <mbgl/util/thread.hpp>
+#include <mbgl/util/timer.hpp>
 #include <mbgl/util/work_request.hpp>
 #include <mbgl/util/stopwatch.hpp>
 
+#include <algorithm>
 #include <cassert>
+#include <functional>
+#include <list>
+#include <memory>
+#include <unordered_map>
 #include <utility>
 
 namespace mbgl {
 
+namespace {
+
+// Upper bound for how long batched ambient cache writes stay uncommitted.
+constexpr Duration batchedWriteInterval = Seconds(1);
+
+constexpr uint64_t defaultMaximumMemoryCacheSize = 8 * 1024 * 1024;
+
+// A network request that is shared by all requests for the same resource made
+// while it is waiting for its first response. Every response it receives is
+// stored once and delivered to all subscribers; the request is cancelled when
+// the last subscriber is released.
+class SharedOnlineRequest : public std::enable_shared_from_this<SharedOnlineRequest> {
+public:
+    using Callback = std::function<void (const Response&)>;
+    using Index = std::unordered_map<std::string, SharedOnlineRequest*>;
+
+    SharedOnlineRequest(Index& index_, std::string key_)
+        : index(index_), key(std::move(key_)) {
+        index.emplace(key, this);
+    }
+
+    ~SharedOnlineRequest() {
+        close();
+    }
+
+    // Requests can't join once the first response arrived, because they
+    // need that response, too. They start their own request instead.
+    void respond(const Response& response) {
+        close();
+        for (const auto& subscriber : subscribers) {
+            subscriber.second.callback(response);
+        }
+    }
+
+    class Subscription : public AsyncRequest {
+    public:
+        Subscription(std::shared_ptr<SharedOnlineRequest> shared_, Callback callback, double order)
+            : shared(std::move(shared_)) {
+            shared->subscribers.emplace(this, Subscriber { std::move(callback), order });
+            shared->updatePriority();
+        }
+
+        ~Subscription() override {
+            shared->subscribers.erase(this);
+            shared->updatePriority();
+        }
+
+        void setPriority(double order) override {
+            shared->subscribers[this].order = order;
+            shared->updatePriority();
+        }
+
+    private:
+        const std::shared_ptr<SharedOnlineRequest> shared;
+    };
+
+    std::unique_ptr<AsyncRequest> request;
+
+private:
+    struct Subscriber {
+        Callback callback;
+        double order;
+    };
+
+    void close() {
+        auto it = index.find(key);
+        if (it != index.end() && it->second == this) {
+            index.erase(it);
+        }
+    }
+
+    // The request is as urgent as its most urgent subscriber.
+    void updatePriority() {
+        if (!request || subscribers.empty()) {
+            return;
+        }
+        auto it = std::min_element(subscribers.begin(), subscribers.end(), [](const auto& a, const auto& b) {
+            return a.second.order < b.second.order;
+        });
+        request->setPriority(it->second.order);
+    }
+
+    Index& index;
+    const std::string key;
+    std::unordered_map<const Subscription*, Subscriber> subscribers;
+};
+
+// Requests only share a network request if they would send the same
+// conditional request to the server.
+std::string sharedOnlineRequestKey(const Resource& resource) {
+    auto timestamp = [](const optional<Timestamp>& t) {
+        return t ? util::toString(int64_t(t->time_since_epoch().count())) : std::string();
+    };
+
+    std::string key = resource.url;
+    key += '\n';
+    key += util::toString(uint8_t(resource.kind));
+    key += resource.priority == Resource::Priority::Low ? "L" : "R";
+    key += '\n';
+    key += timestamp(resource.priorModified);
+    key += '\n';
+    key += timestamp(resource.priorExpires);
+    key += '\n';
+    key += resource.priorEtag ? *resource.priorEtag : std::string();
+    return key;
+}
+
+} // namespace
+
+// Keeps the most recently used responses of the ambient cache in memory, so
+// that repeated requests for the same resource can be answered on the
+// requesting thread, without querying the database. The responses are
+// inserted by the database thread; all methods are thread-safe.
+class DefaultFileSource::MemoryCache {
+public:
+    optional<Response> get(const Resource& resource) {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = index.find(key(resource));
+        // Responses that can't be used right away require a database lookup,
+        // which decides whether they have to be revalidated first.
+        if (it == index.end() || !it->second->response.isUsable()) {
+            misses++;
+            return nullopt;
+        }
+        hits++;
+        entries.splice(entries.end(), entries, it->second);
+        return it->second->response;
+    }
+
+    void put(const Resource& resource, const Response& response) {
+        std::lock_guard<std::mutex> lock(mutex);
+        std::string entryKey = key(resource);
+        auto it = index.find(entryKey);
+        if (it != index.end()) {
+            erase(it->second);
+        }
+
+        if (response.error || response.notModified) {
+            return;
+        }
+
+        const uint64_t entrySize = entryKey.size() + (response.data ? response.data->size() : 0);
+        if (entrySize > maximumSize) {
+            return;
+        }
+
+        entries.push_back({ entryKey, response, entrySize });
+        index.emplace(std::move(entryKey), std::prev(entries.end()));
+        size += entrySize;
+
+        while (size > maximumSize) {
+            erase(entries.begin());
+        }
+    }
+
+    void remove(const Resource& resource) {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = index.find(key(resource));
+        if (it != index.end()) {
+            erase(it->second);
+        }
+    }
+
+    void clear() {
+        std::lock_guard<std::mutex> lock(mutex);
+        index.clear();
+        entries.clear();
+        size = 0;
+    }
+
+    void setMaximumSize(uint64_t maximumSize_) {
+        std::lock_guard<std::mutex> lock(mutex);
+        maximumSize = maximumSize_;
+        while (size > maximumSize) {
+            erase(entries.begin());
+        }
+    }
+
+    uint64_t getHits() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return hits;
+    }
+
+    uint64_t getMisses() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return misses;
+    }
+
+private:
+    struct Entry {
+        std::string key;
+        Response response;
+        uint64_t size;
+    };
+
+    // Ordered from least to most recently used.
+    using Entries = std::list<Entry>;
+
+    // Tiles are identified by their coordinates rather than by their URL, like
+    // in the offline database.
+    static std::string key(const Resource& resource) {
+        if (resource.kind == Resource::Kind::Tile && resource.tileData) {
+            const Resource::TileData& tile = *resource.tileData;
+            return tile.urlTemplate + '\n' + util::toString(tile.pixelRatio) + '/' + util::toString(tile.z) + '/' +
+                   util::toString(tile.x) + '/' + util::toString(tile.y);
+        }
+        return resource.url;
+    }
+
+    void erase(Entries::iterator entry) {
+        size -= entry->size;
+        index.erase(entry->key);
+        entries.erase(entry);
+    }
+
+    mutable std::mutex mutex;
+    Entries entries;
+    std::unordered_map<std::string, Entries::iterator> index;
+    uint64_t maximumSize = defaultMaximumMemoryCacheSize;
+    uint64_t size = 0;
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+};
+
 class DefaultFileSource::Impl {
 public:
-    Impl(std::shared_ptr<FileSource> assetFileSource_, std::string cachePath)
+    Impl(std::shared_ptr<FileSource> assetFileSource_,
+         std::shared_ptr<MemoryCache> memoryCache_,
+         std::string cachePath)
             : assetFileSource(std::move(assetFileSource_))
+            , memoryCache(std::move(memoryCache_))
             , localFileSource(std::make_unique<LocalFileSource>())
+            , mbtilesFileSource(std::make_unique<MBTilesFileSource>())
             , offlineDatabase(std::make_unique<OfflineDatabase>(std::move(cachePath))) {
     }
 
@@ -47,6 +283,7 @@ public:
     }
 
     void setResourceCachePath(const std::string& path, optional<ActorRef<PathChangeCallback>>&& callback) {
+        memoryCache->clear();
         offlineDatabase->changePath(path);
         if (callback) {
             callback->invoke(&PathChangeCallback::operator());
@@ -65,6 +302,7 @@ public:
 
     void mergeOfflineRegions(const std::string& sideDatabasePath,
                              std::function<void (expected<OfflineRegions, std::exception_ptr>)> callback) {
+        memoryCache->clear();
         callback(offlineDatabase->mergeDatabase(sideDatabasePath));
      }
 
@@ -84,10 +322,12 @@ public:
 
     void deleteRegion(OfflineRegion&& region, std::function<void(std::exception_ptr)> callback) {
         downloads.erase(region.getID());
+        memoryCache->clear();
         callback(offlineDatabase->deleteRegion(std::move(region)));
     }
 
     void invalidateRegion(int64_t regionID, std::function<void (std::exception_ptr)> callback) {
+        memoryCache->clear();
         callback(offlineDatabase->invalidateRegion(regionID));
     }
 
@@ -114,10 +354,17 @@ public:
         } else if (LocalFileSource::acceptsURL(resource.url)) {
             //Local file request
             tasks[req] = localFileSource->request(resource, callback);
+        } else if (MBTilesFileSource::acceptsURL(resource.url)) {
+            // Local tile pack request
+            tasks[req] = mbtilesFileSource->request(resource, callback);
         } else {
             // Try the offline database
             if (resource.hasLoadingMethod(Resource::LoadingMethod::Cache)) {
                 auto offlineResponse = offlineDatabase->get(resource);
+                scheduleFlush();
+                if (offlineResponse) {
+                    memoryCache->put(resource, *offlineResponse);
+                }
 
                 if (resource.loadingMethod == Resource::LoadingMethod::CacheOnly) {
                     if (!offlineResponse) {
@@ -153,27 +400,49 @@ public:
 
             // Get from the online file source
             if (resource.hasLoadingMethod(Resource::LoadingMethod::Network)) {
-                MBGL_TIMING_START(watch);
-                tasks[req] = onlineFileSource.request(resource, [=] (Response onlineResponse) {
-                    this->offlineDatabase->put(resource, onlineResponse);
-                    if (resource.kind == Resource::Kind::Tile) {
-                        // onlineResponse.data will be null if data not modified
-                        MBGL_TIMING_FINISH(watch,
-                                           " Action: " << "Requesting," <<
-                                           " URL: " << resource.url.c_str() <<
-                                           " Size: " << (onlineResponse.data != nullptr ? onlineResponse.data->size() : 0) << "B," <<
-                                           " Time")
-                    }
-                    callback(onlineResponse);
-                });
+                tasks[req] = requestOnline(resource, callback);
             }
         }
     }
 
+    std::unique_ptr<AsyncRequest> requestOnline(const Resource& resource, SharedOnlineRequest::Callback callback) {
+        std::string key = sharedOnlineRequestKey(resource);
+        auto it = sharedOnlineRequests.find(key);
+        if (it != sharedOnlineRequests.end()) {
+            return std::make_unique<SharedOnlineRequest::Subscription>(
+                it->second->shared_from_this(), std::move(callback), resource.order);
+        }
+
+        auto shared = std::make_shared<SharedOnlineRequest>(sharedOnlineRequests, std::move(key));
+        MBGL_TIMING_START(watch);
+        shared->request = onlineFileSource.request(resource, [=, sharedRequest = shared.get()] (Response onlineResponse) {
+            this->offlineDatabase->put(resource, onlineResponse);
+            this->memoryCache->put(resource, onlineResponse);
+            scheduleFlush();
+            if (resource.kind == Resource::Kind::Tile) {
+                // onlineResponse.data will be null if data not modified
+                MBGL_TIMING_FINISH(watch,
+                                   " Action: " << "Requesting," <<
+                                   " URL: " << resource.url.c_str() <<
+                                   " Size: " << (onlineResponse.data != nullptr ? onlineResponse.data->size() : 0) << "B," <<
+                                   " Time")
+            }
+            sharedRequest->respond(onlineResponse);
+        });
+        return std::make_unique<SharedOnlineRequest::Subscription>(std::move(shared), std::move(callback), resource.order);
+    }
+
     void cancel(AsyncRequest* req) {
         tasks.erase(req);
     }
 
+    void setPriority(AsyncRequest* req, double priority) {
+        auto it = tasks.find(req);
+        if (it != tasks.end()) {
+            it->second->setPriority(priority);
+        }
+    }
+
     void setOfflineMapboxTileCountLimit(uint64_t limit) {
         offlineDatabase->setOfflineMapboxTileCountLimit(limit);
     }
@@ -186,23 +455,33 @@ public:
         onlineFileSource.setMaximumConcurrentRequests(maximumConcurrentRequests_);
     }
 
+    void setMaximumConcurrentRequestsPerHost(uint32_t maximumConcurrentRequestsPerHost_) {
+        onlineFileSource.setMaximumConcurrentRequestsPerHost(maximumConcurrentRequestsPerHost_);
+    }
+
     void put(const Resource& resource, const Response& response) {
         offlineDatabase->put(resource, response);
+        memoryCache->remove(resource);
+        scheduleFlush();
     }
 
     void resetDatabase(std::function<void (std::exception_ptr)> callback) {
+        memoryCache->clear();
         callback(offlineDatabase->resetDatabase());
     }
 
     void invalidateAmbientCache(std::function<void (std::exception_ptr)> callback) {
+        memoryCache->clear();
         callback(offlineDatabase->invalidateAmbientCache());
     }
 
     void clearAmbientCache(std::function<void (std::exception_ptr)> callback) {
+        memoryCache->clear();
         callback(offlineDatabase->clearAmbientCache());
     }
 
     void setMaximumAmbientCacheSize(uint64_t size, std::function<void (std::exception_ptr)> callback) {
+        memoryCache->clear();
         callback(offlineDatabase->setMaximumAmbientCacheSize(size));
     }
 
@@ -210,7 +489,22 @@ public:
 
     void runPackDatabaseAutomatically(bool autopack) { offlineDatabase->runPackDatabaseAutomatically(autopack); }
 
+    void setWriteAheadLogEnabled(bool enabled) { offlineDatabase->setWriteAheadLogEnabled(enabled); }
+
+    void setAmbientCacheWriteBatchSize(uint32_t size) { offlineDatabase->setWriteBatchSize(size); }
+
 private:
+    void scheduleFlush() {
+        if (flushScheduled || !offlineDatabase->hasPendingWrites()) {
+            return;
+        }
+        flushScheduled = true;
+        flushTimer.start(batchedWriteInterval, Duration::zero(), [this] {
+            flushScheduled = false;
+            offlineDatabase->flush();
+        });
+    }
+
     expected<OfflineDownload*, std::exception_ptr> getDownload(int64_t regionID) {
         auto it = downloads.find(regionID);
         if (it != downloads.end()) {
@@ -222,16 +516,44 @@ private:
         }
         auto download = std::make_unique<OfflineDownload>(regionID, std::move(definition.value()),
                                                           *offlineDatabase, onlineFileSource);
+        if (maximumConcurrentOfflineRequests) {
+            download->setMaximumConcurrentRequests(*maximumConcurrentOfflineRequests);
+        }
+        if (offlineDownloadBatchSize) {
+            download->setBatchSize(*offlineDownloadBatchSize);
+        }
         return downloads.emplace(regionID, std::move(download)).first->second.get();
     }
 
+    void setMaximumConcurrentOfflineRequests(uint32_t maximum) {
+        maximumConcurrentOfflineRequests = maximum;
+        for (auto& download : downloads) {
+            download.second->setMaximumConcurrentRequests(maximum);
+        }
+    }
+
+    void setOfflineDownloadBatchSize(uint32_t size) {
+        offlineDownloadBatchSize = size;
+        for (auto& download : downloads) {
+            download.second->setBatchSize(size);
+        }
+    }
+
     // shared so that destruction is done on the creating thread
     const std::shared_ptr<FileSource> assetFileSource;
+    const std::shared_ptr<MemoryCache> memoryCache;
     const std::unique_ptr<FileSource> localFileSource;
+    const std::unique_ptr<FileSource> mbtilesFileSource;
     std::unique_ptr<OfflineDatabase> offlineDatabase;
     OnlineFileSource onlineFileSource;
+    // Declared before the tasks, which unregister from it when destroyed.
+    SharedOnlineRequest::Index sharedOnlineRequests;
     std::unordered_map<AsyncRequest*, std::unique_ptr<AsyncRequest>> tasks;
     std::unordered_map<int64_t, std::unique_ptr<OfflineDownload>> downloads;
+    optional<uint32_t> maximumConcurrentOfflineRequests;
+    optional<uint32_t> offlineDownloadBatchSize;
+    util::Timer flushTimer;
+    bool flushScheduled = false;
 };
 
 DefaultFileSource::DefaultFileSource(const std::string& cachePath, const std::string& assetPath, bool supportCacheOnlyRequests_)
@@ -240,7 +562,8 @@ DefaultFileSource::DefaultFileSource(const std::string& cachePath, const std::st
 
 DefaultFileSource::DefaultFileSource(const std::string& cachePath, std::unique_ptr<FileSource>&& assetFileSource_, bool supportCacheOnlyRequests_)
         : assetFileSource(std::move(assetFileSource_))
-        , impl(std::make_unique<util::Thread<Impl>>("DefaultFileSource", assetFileSource, cachePath))
+        , memoryCache(std::make_shared<MemoryCache>())
+        , impl(std::make_unique<util::Thread<Impl>>("DefaultFileSource", assetFileSource, memoryCache, cachePath))
         , supportCacheOnlyRequests(supportCacheOnlyRequests_) {
 }
 
@@ -289,9 +612,38 @@ void DefaultFileSource::setResourceCachePath(const std::string& path, optional<A
 std::unique_ptr<AsyncRequest> DefaultFileSource::request(const Resource& resource, Callback callback) {
     auto req = std::make_unique<FileSourceRequest>(std::move(callback));
 
-    req->onCancel([fs = impl->actor(), req = req.get()] () { fs.invoke(&Impl::cancel, req); });
+    // Answer repeated requests from memory. If a network request is required
+    // as well, the database thread only needs to schedule the revalidation.
+    optional<Response> cachedResponse;
+    if (resource.hasLoadingMethod(Resource::LoadingMethod::Cache) && !AssetFileSource::acceptsURL(resource.url) &&
+        !LocalFileSource::acceptsURL(resource.url) && !MBTilesFileSource::acceptsURL(resource.url)) {
+        cachedResponse = memoryCache->get(resource);
+    }
 
-    impl->actor().invoke(&Impl::request, req.get(), resource, req->actor());
+    if (cachedResponse) {
+        req->actor().invoke(&FileSourceRequest::setResponse, *cachedResponse);
+        if (!resource.hasLoadingMethod(Resource::LoadingMethod::Network)) {
+            return std::move(req);
+        }
+    }
+
+    req->onCancel([fs = impl->actor(), req = req.get()] () { fs.invoke(&Impl::cancel, req); });
+    req->onPriorityChange([fs = impl->actor(), req = req.get()] (double priority) {
+        fs.invoke(&Impl::setPriority, req, priority);
+    });
+
+    if (cachedResponse) {
+        Resource revalidation = resource;
+        revalidation.loadingMethod = Resource::LoadingMethod::NetworkOnly;
+        revalidation.priorModified = cachedResponse->modified;
+        revalidation.priorExpires = cachedResponse->expires;
+        revalidation.priorEtag = cachedResponse->etag;
+        revalidation.priorData = cachedResponse->data;
+        revalidation.setPriority(Resource::Priority::Low);
+        impl->actor().invoke(&Impl::request, req.get(), std::move(revalidation), req->actor());
+    } else {
+        impl->actor().invoke(&Impl::request, req.get(), resource, req->actor());
+    }
 
     return std::move(req);
 }
@@ -343,6 +695,14 @@ void DefaultFileSource::setOfflineMapboxTileCountLimit(uint64_t limit) const {
     impl->actor().invoke(&Impl::setOfflineMapboxTileCountLimit, limit);
 }
 
+void DefaultFileSource::setMaximumConcurrentOfflineRequests(uint32_t maximum) {
+    impl->actor().invoke(&Impl::setMaximumConcurrentOfflineRequests, maximum);
+}
+
+void DefaultFileSource::setOfflineDownloadBatchSize(uint32_t size) {
+    impl->actor().invoke(&Impl::setOfflineDownloadBatchSize, size);
+}
+
 void DefaultFileSource::pause() {
     impl->pause();
 }
@@ -367,6 +727,26 @@ void DefaultFileSource::runPackDatabaseAutomatically(bool autopack) {
     impl->actor().invoke(&Impl::runPackDatabaseAutomatically, autopack);
 }
 
+void DefaultFileSource::setWriteAheadLogEnabled(bool enabled) {
+    impl->actor().invoke(&Impl::setWriteAheadLogEnabled, enabled);
+}
+
+void DefaultFileSource::setAmbientCacheWriteBatchSize(uint32_t size) {
+    impl->actor().invoke(&Impl::setAmbientCacheWriteBatchSize, size);
+}
+
+void DefaultFileSource::setMaximumMemoryCacheSize(uint64_t size) {
+    memoryCache->setMaximumSize(size);
+}
+
+uint64_t DefaultFileSource::getMemoryCacheHits() const {
+    return memoryCache->getHits();
+}
+
+uint64_t DefaultFileSource::getMemoryCacheMisses() const {
+    return memoryCache->getMisses();
+}
+
 void DefaultFileSource::invalidateAmbientCache(std::function<void (std::exception_ptr)> callback) {
     impl->actor().invoke(&Impl::invalidateAmbientCache, std::move(callback));
 }
@@ -379,6 +759,10 @@ void DefaultFileSource::setMaximumAmbientCacheSize(uint64_t size, std::function<
     impl->actor().invoke(&Impl::setMaximumAmbientCacheSize, size, std::move(callback));
 }
 
+void DefaultFileSource::setMaximumConcurrentRequestsPerHost(uint32_t maximumConcurrentRequestsPerHost_) {
+    impl->actor().invoke(&Impl::setMaximumConcurrentRequestsPerHost, maximumConcurrentRequestsPerHost_);
+}
+
 // For testing only:
 
 void DefaultFileSource::setOnlineStatus(const bool status) {
@@ -16,9 +16,11 @@
 #include <dlfcn.h>
 #include <queue>
 #include <map>
+#include <algorithm>
 #include <cassert>
 #include <cstring>
 #include <cstdio>
+#include <cstdlib>
 
 static void handleError(CURLMcode code) {
     if (code != CURLM_OK) {
@@ -85,6 +87,10 @@ private:
     optional<std::string> retryAfter;
     optional<std::string> xRateLimitReset;
 
+    // Value of the Content-Length header of the current response, used to
+    // allocate the data buffer once instead of growing it chunk by chunk.
+    optional<size_t> contentLength;
+
     CURL *handle = nullptr;
     curl_slist *headers = nullptr;
 
@@ -277,13 +283,20 @@ HTTPRequest::~HTTPRequest() {
 }
 
 // This function is called when we have new data for a request. We just append it to the string
-// containing the previous data.
+// containing the previous data. The string is passed on as the response data without copying it,
+// so when the length of the body is known, it's allocated in one go. For encoded responses, which
+// curl decodes for us, the length is only a lower bound.
 size_t HTTPRequest::writeCallback(void *const contents, const size_t size, const size_t nmemb, void *userp) {
     assert(userp);
     auto impl = reinterpret_cast<HTTPRequest *>(userp);
 
     if (!impl->data) {
         impl->data = std::make_shared<std::string>();
+        if (impl->contentLength) {
+            // Don't trust the header with arbitrarily large allocations.
+            constexpr size_t maximumReservation = 64 * 1024 * 1024;
+            impl->data->reserve(std::min(*impl->contentLength, maximumReservation));
+        }
     }
 
     impl->data->append((char *)contents, size * nmemb);
@@ -316,7 +329,13 @@ size_t HTTPRequest::headerCallback(char *const buffer, const size_t size, const
 
     const size_t length = size * nmemb;
     size_t begin = std::string::npos;
-    if ((begin = headerMatches("last-modified: ", buffer, length)) != std::string::npos) {
+    if (headerMatches("HTTP/", buffer, length) != std::string::npos) {
+        // Status line of a new response, e.g. after a redirect.
+        baton->contentLength = {};
+    } else if ((begin = headerMatches("content-length: ", buffer, length)) != std::string::npos) {
+        const std::string value { buffer + begin, length - begin - 2 }; // remove \r\n
+        baton->contentLength = size_t(std::strtoull(value.c_str(), nullptr, 10));
+    } else if ((begin = headerMatches("last-modified: ", buffer, length)) != std::string::npos) {
         // Always overwrite the modification date; We might already have a value here from the
         // Date header, but this one is more accurate.
         const std::string value { buffer + begin, length - begin - 2 }; // remove \r\n
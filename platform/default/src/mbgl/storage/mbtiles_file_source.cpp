@@ -0,0 +1,197 @@
+#include <mbgl/storage/mbtiles_file_source.hpp>
+#include <mbgl/storage/file_source_request.hpp>
+#include <mbgl/storage/response.hpp>
+#include <mbgl/storage/sqlite3.hpp>
+#include <mbgl/util/compression.hpp>
+#include <mbgl/util/io.hpp>
+#include <mbgl/util/thread.hpp>
+#include <mbgl/util/url.hpp>
+
+#include <rapidjson/stringbuffer.h>
+#include <rapidjson/writer.h>
+
+#include <cstdlib>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+const std::string mbtilesProtocol = "mbtiles://";
+
+// Tile sets are read through a memory map of up to this size, so that SQLite
+// hands out tile data from the mapping instead of copying it into its page
+// cache first.
+constexpr int64_t mmapSize = 1 << 30;
+
+bool isGzipped(const std::string& data) {
+    return data.size() > 2 && uint8_t(data[0]) == 0x1F && uint8_t(data[1]) == 0x8B;
+}
+
+// Tile packs usually contain gzipped vector tiles, which the tile parsers
+// can't read.
+std::shared_ptr<const std::string> tileData(std::string&& data, mbgl::util::CompressionPool& compressionPool) {
+    if (isGzipped(data)) {
+        return std::make_shared<std::string>(compressionPool.decompress(data));
+    }
+    return std::make_shared<std::string>(std::move(data));
+}
+
+std::vector<double> parseNumbers(const std::string& value) {
+    std::vector<double> result;
+    const char* begin = value.c_str();
+    char* end = nullptr;
+    while (true) {
+        const double number = std::strtod(begin, &end);
+        if (end == begin) {
+            break;
+        }
+        result.push_back(number);
+        begin = *end == ',' ? end + 1 : end;
+    }
+    return result;
+}
+
+} // namespace
+
+namespace mbgl {
+
+class MBTilesFileSource::Impl {
+public:
+    Impl(ActorRef<Impl>) {}
+
+    void request(const Resource& resource, ActorRef<FileSourceRequest> req) {
+        Response response;
+
+        if (!acceptsURL(resource.url)) {
+            response.error = std::make_unique<Response::Error>(Response::Error::Reason::Other,
+                                                               "Invalid MBTiles URL");
+        } else if (resource.kind == Resource::Kind::Tile && resource.tileData &&
+                   resource.tileData->urlTemplate.find('{') != std::string::npos) {
+            requestPyramidTile(path(resource.url), response);
+        } else {
+            try {
+                TileSet& tileSet = getTileSet(path(resource.url));
+                if (resource.kind == Resource::Kind::Tile && resource.tileData) {
+                    requestTile(tileSet, *resource.tileData, response);
+                } else {
+                    requestTileJSON(tileSet, resource.url, response);
+                }
+            } catch (const std::exception& ex) {
+                tileSets.erase(path(resource.url));
+                response.error = std::make_unique<Response::Error>(Response::Error::Reason::Other, ex.what());
+            }
+        }
+
+        req.invoke(&FileSourceRequest::setResponse, response);
+    }
+
+private:
+    struct TileSet {
+        TileSet(const std::string& path)
+            : db(mapbox::sqlite::Database::open(path, mapbox::sqlite::ReadOnly)) {
+            db.exec("PRAGMA mmap_size = " + std::to_string(mmapSize));
+            tileStatement = std::make_unique<mapbox::sqlite::Statement>(
+                db, "SELECT tile_data FROM tiles WHERE zoom_level = ?1 AND tile_column = ?2 AND tile_row = ?3");
+        }
+
+        mapbox::sqlite::Database db;
+        std::unique_ptr<mapbox::sqlite::Statement> tileStatement;
+    };
+
+    static std::string path(const std::string& url) {
+        return util::percentDecode(url.substr(mbtilesProtocol.size()));
+    }
+
+    TileSet& getTileSet(const std::string& path) {
+        auto it = tileSets.find(path);
+        if (it == tileSets.end()) {
+            it = tileSets.emplace(path, std::make_unique<TileSet>(path)).first;
+        }
+        return *it->second;
+    }
+
+    void requestPyramidTile(const std::string& path, Response& response) {
+        auto data = util::readFile(path);
+        if (!data) {
+            response.error = std::make_unique<Response::Error>(Response::Error::Reason::NotFound);
+        } else {
+            response.data = tileData(std::move(*data), compressionPool);
+        }
+    }
+
+    void requestTile(TileSet& tileSet, const Resource::TileData& tile, Response& response) {
+        mapbox::sqlite::Query query{ *tileSet.tileStatement };
+        // MBTiles rows are numbered from the bottom.
+        query.bind(1, tile.z);
+        query.bind(2, tile.x);
+        query.bind(3, int32_t((1 << tile.z) - 1 - tile.y));
+
+        if (!query.run()) {
+            response.noContent = true;
+            return;
+        }
+
+        response.data = tileData(query.get<std::string>(0), compressionPool);
+    }
+
+    static void requestTileJSON(TileSet& tileSet, const std::string& url, Response& response) {
+        mapbox::sqlite::Statement statement{ tileSet.db, "SELECT name, value FROM metadata" };
+        mapbox::sqlite::Query query{ statement };
+
+        rapidjson::StringBuffer buffer;
+        rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
+        writer.StartObject();
+        writer.Key("tilejson");
+        writer.String("2.2.0");
+        writer.Key("tiles");
+        writer.StartArray();
+        writer.String(url.c_str(), rapidjson::SizeType(url.size()));
+        writer.EndArray();
+
+        while (query.run()) {
+            const std::string name = query.get<std::string>(0);
+            const std::string value = query.get<std::string>(1);
+            if (name == "minzoom" || name == "maxzoom") {
+                writer.Key(name.c_str(), rapidjson::SizeType(name.size()));
+                writer.Int(std::atoi(value.c_str()));
+            } else if (name == "bounds" || name == "center") {
+                writer.Key(name.c_str(), rapidjson::SizeType(name.size()));
+                writer.StartArray();
+                for (double number : parseNumbers(value)) {
+                    writer.Double(number);
+                }
+                writer.EndArray();
+            } else if (name == "name" || name == "attribution" || name == "version") {
+                writer.Key(name.c_str(), rapidjson::SizeType(name.size()));
+                writer.String(value.c_str(), rapidjson::SizeType(value.size()));
+            }
+        }
+
+        writer.EndObject();
+        response.data = std::make_shared<std::string>(buffer.GetString(), buffer.GetSize());
+    }
+
+    std::unordered_map<std::string, std::unique_ptr<TileSet>> tileSets;
+    util::CompressionPool compressionPool;
+};
+
+MBTilesFileSource::MBTilesFileSource()
+    : impl(std::make_unique<util::Thread<Impl>>("MBTilesFileSource")) {
+}
+
+MBTilesFileSource::~MBTilesFileSource() = default;
+
+std::unique_ptr<AsyncRequest> MBTilesFileSource::request(const Resource& resource, Callback callback) {
+    auto req = std::make_unique<FileSourceRequest>(std::move(callback));
+
+    impl->actor().invoke(&Impl::request, resource, req->actor());
+
+    return std::move(req);
+}
+
+bool MBTilesFileSource::acceptsURL(const std::string& url) {
+    return 0 == url.rfind(mbtilesProtocol, 0);
+}
+
+} // namespace mbgl
@@ -10,11 +10,45 @@
 #include <mbgl/storage/offline_schema.hpp>
 #include <mbgl/storage/merge_sideloaded.hpp>
 
+#include <algorithm>
+
 
 namespace mbgl {
 
+namespace {
+
+// Each database has its own instance, which is only used on the database's
+// thread, and reuses its zlib streams.
+class ZlibCodec final : public OfflineDatabaseCodec {
+public:
+    uint8_t id() const override { return 1; }
+    std::string compress(const std::string& raw) const override { return pool.compress(raw); }
+    std::string decompress(const std::string& raw) const override { return pool.decompress(raw); }
+
+private:
+    mutable util::CompressionPool pool;
+};
+
+// Access times are tracked with this granularity, so that reading the same
+// resource repeatedly doesn't result in a write every time.
+constexpr Seconds accessTimeGranularity = Seconds(60);
+
+// Number of access times that are kept in memory before the next write
+// writes them out as well.
+constexpr std::size_t maximumPendingAccessTimes = 256;
+
+Timestamp accessTime() {
+    const Seconds time = util::now().time_since_epoch();
+    return Timestamp(time - time % accessTimeGranularity);
+}
+
+} // namespace
+
 OfflineDatabase::OfflineDatabase(std::string path_)
-    : path(std::move(path_)) {
+    : path(std::move(path_)),
+      compressionCodec(std::make_shared<ZlibCodec>()) {
+    codecs.emplace(compressionCodec->id(), compressionCodec);
+
     try {
         initialize();
     } catch (...) {
@@ -43,7 +77,7 @@ void OfflineDatabase::initialize() {
         // Newly created database, or old cache-only database; remove old table if it exists.
         removeOldCacheTable();
         createSchema();
-        return;
+        break;
     case 2:
         migrateToVersion3();
         // fall through
@@ -58,11 +92,16 @@ void OfflineDatabase::initialize() {
         // fall through
     case 6:
         // Happy path; we're done
-        return;
+        break;
     default:
         // Downgrade: delete the database and try to reinitialize.
         removeExisting();
         initialize();
+        return;
+    }
+
+    if (writeAheadLog) {
+        applyJournalMode();
     }
 }
 
@@ -74,8 +113,21 @@ void OfflineDatabase::changePath(const std::string& path_) {
 }
 
 void OfflineDatabase::cleanup() {
+    try {
+        flushAccessTimes();
+        commitBatch();
+    } catch (...) {
+        handleError("commit batched writes");
+    }
+
+    // Access times that couldn't be written belong to the database being
+    // closed.
+    pendingResourceAccessTimes.clear();
+    pendingTileAccessTimes.clear();
+
     // Deleting these SQLite objects may result in exceptions
     try {
+        batch.reset();
         statements.clear();
         db.reset();
     } catch (...) {
@@ -145,6 +197,10 @@ void OfflineDatabase::handleError(const char* action) {
 void OfflineDatabase::removeExisting() {
     Log::Warning(Event::Database, "Removing existing incompatible offline database");
 
+    batch.reset();
+    batchedWrites = 0;
+    pendingResourceAccessTimes.clear();
+    pendingTileAccessTimes.clear();
     statements.clear();
     db.reset();
 
@@ -198,6 +254,8 @@ void OfflineDatabase::migrateToVersion6() {
 
 void OfflineDatabase::vacuum() {
     assert(db);
+    // VACUUM can't run inside a transaction.
+    commitBatch();
     if (getPragma<int64_t>("PRAGMA auto_vacuum") != 2 /*INCREMENTAL*/) {
         db->exec("PRAGMA auto_vacuum = INCREMENTAL");
         db->exec("VACUUM");
@@ -206,6 +264,151 @@ void OfflineDatabase::vacuum() {
     }
 }
 
+void OfflineDatabase::applyJournalMode() {
+    assert(db);
+    commitBatch();
+    if (writeAheadLog) {
+        db->exec("PRAGMA journal_mode = WAL");
+        db->exec("PRAGMA synchronous = NORMAL");
+    } else {
+        db->exec("PRAGMA journal_mode = DELETE");
+        db->exec("PRAGMA synchronous = FULL");
+    }
+}
+
+void OfflineDatabase::setWriteAheadLogEnabled(bool enabled) try {
+    writeAheadLog = enabled;
+    if (db) {
+        applyJournalMode();
+    }
+} catch (...) {
+    handleError("change journal mode");
+}
+
+void OfflineDatabase::setWriteBatchSize(uint32_t size) {
+    writeBatchSize = std::max<uint32_t>(size, 1);
+    flush();
+}
+
+void OfflineDatabase::flush() try {
+    flushAccessTimes();
+    commitBatch();
+} catch (...) {
+    handleError("commit batched writes");
+}
+
+// Returns true if the write is part of a batch. Writes that aren't batched
+// are responsible for their own transaction.
+bool OfflineDatabase::beginBatchedWrite() {
+    if (writeBatchSize <= 1) {
+        return false;
+    }
+    if (!batch) {
+        assert(batchedWrites == 0);
+        if (!db) {
+            initialize();
+        }
+        batch = std::make_unique<mapbox::sqlite::Transaction>(*db, mapbox::sqlite::Transaction::Immediate);
+    }
+    return true;
+}
+
+void OfflineDatabase::endBatchedWrite() {
+    if (++batchedWrites >= writeBatchSize) {
+        commitBatch();
+    }
+}
+
+// Must be called before starting any other transaction, and before any write
+// that isn't part of the ambient cache batch. Otherwise, a batched write that
+// fails later on would roll back that write as well.
+void OfflineDatabase::commitBatch() {
+    if (batch) {
+        auto transaction = std::move(batch);
+        batchedWrites = 0;
+        transaction->commit();
+    }
+}
+
+// Writes the pending access times as part of the current transaction.
+void OfflineDatabase::updateAccessTimes() {
+    auto resources = std::move(pendingResourceAccessTimes);
+    auto tiles = std::move(pendingTileAccessTimes);
+    pendingResourceAccessTimes.clear();
+    pendingTileAccessTimes.clear();
+
+    try {
+        for (const auto& entry : resources) {
+            mapbox::sqlite::Query accessedQuery{ getStatement("UPDATE resources SET accessed = ?1 WHERE url = ?2") };
+            accessedQuery.bind(1, entry.second);
+            accessedQuery.bind(2, entry.first);
+            accessedQuery.run();
+        }
+
+        for (const auto& entry : tiles) {
+            // clang-format off
+            mapbox::sqlite::Query accessedQuery{ getStatement(
+                "UPDATE tiles "
+                "SET accessed       = ?1 "
+                "WHERE url_template = ?2 "
+                "  AND pixel_ratio  = ?3 "
+                "  AND x            = ?4 "
+                "  AND y            = ?5 "
+                "  AND z            = ?6 ") };
+            // clang-format on
+
+            accessedQuery.bind(1, entry.second);
+            accessedQuery.bind(2, std::get<0>(entry.first));
+            accessedQuery.bind(3, std::get<1>(entry.first));
+            accessedQuery.bind(4, std::get<2>(entry.first));
+            accessedQuery.bind(5, std::get<3>(entry.first));
+            accessedQuery.bind(6, std::get<4>(entry.first));
+            accessedQuery.run();
+        }
+    } catch (const mapbox::sqlite::Exception& ex) {
+        if (ex.code == mapbox::sqlite::ResultCode::NotADB || ex.code == mapbox::sqlite::ResultCode::Corrupt) {
+            throw;
+        }
+
+        // If we don't have any indication that the database is corrupt, continue as usual.
+        Log::Warning(Event::Database, static_cast<int>(ex.code), "Can't update timestamp: %s", ex.what());
+    }
+}
+
+// Writes the pending access times in a single transaction, or as part of the
+// current batch.
+void OfflineDatabase::flushAccessTimes() {
+    if (!db || (pendingResourceAccessTimes.empty() && pendingTileAccessTimes.empty())) {
+        return;
+    }
+
+    if (batch) {
+        updateAccessTimes();
+    } else {
+        mapbox::sqlite::Transaction transaction(*db, mapbox::sqlite::Transaction::Immediate);
+        updateAccessTimes();
+        transaction.commit();
+    }
+}
+
+void OfflineDatabase::setCompressionCodec(std::shared_ptr<const OfflineDatabaseCodec> codec) {
+    assert(codec && codec->id() != 0);
+    codecs[codec->id()] = codec;
+    compressionCodec = std::move(codec);
+}
+
+std::shared_ptr<const std::string> OfflineDatabase::decompress(std::string&& data, int codecID) const {
+    if (codecID == 0) {
+        return std::make_shared<std::string>(std::move(data));
+    }
+
+    auto it = codecs.find(codecID);
+    if (it == codecs.end()) {
+        throw std::runtime_error("Unknown compression codec " + util::toString(codecID));
+    }
+    return std::make_shared<std::string>(it->second->decompress(data));
+}
+
 mapbox::sqlite::Statement& OfflineDatabase::getStatement(const char* sql) {
     if (!db) {
         initialize();
@@ -222,6 +425,8 @@ optional<Response> OfflineDatabase::get(const Resource& resource) try {
         return nullopt;
     }
 
+    // Reads never take the write lock. The access time update performed by
+    // the lookup is deferred until the next write or flush().
     auto result = getInternal(resource);
     return result ? optional<Response>{ result->first } : nullopt;
 } catch (...) {
@@ -256,8 +461,29 @@ std::pair<bool, uint64_t> OfflineDatabase::put(const Resource& resource, const R
         return { false, 0 };
     }
 
+    // Pending access times are written along with the resource once there are
+    // enough of them, so that they don't need a transaction of their own.
+    const bool writeAccessTimes =
+        pendingResourceAccessTimes.size() + pendingTileAccessTimes.size() >= maximumPendingAccessTimes;
+
+    if (beginBatchedWrite()) {
+        // A failed write only rolls back to its own savepoint, so that the
+        // writes batched before it are still committed with the batch.
+        mapbox::sqlite::Savepoint savepoint(*db, "put");
+        auto result = putInternal(resource, response, true);
+        if (writeAccessTimes) {
+            updateAccessTimes();
+        }
+        savepoint.release();
+        endBatchedWrite();
+        return result;
+    }
+
     mapbox::sqlite::Transaction transaction(*db, mapbox::sqlite::Transaction::Immediate);
     auto result = putInternal(resource, response, true);
+    if (writeAccessTimes) {
+        updateAccessTimes();
+    }
     transaction.commit();
     return result;
 } catch (...) {
@@ -271,13 +497,15 @@ std::pair<bool, uint64_t> OfflineDatabase::putInternal(const Resource& resource,
     }
 
     std::string compressedData;
-    bool compressed = false;
+    uint8_t compression = 0;
     uint64_t size = 0;
 
     if (response.data) {
-        compressedData = util::compress(*response.data);
-        compressed = compressedData.size() < response.data->size();
-        size = compressed ? compressedData.size() : response.data->size();
+        compressedData = compressionCodec->compress(*response.data);
+        if (compressedData.size() < response.data->size()) {
+            compression = compressionCodec->id();
+        }
+        size = compression ? compressedData.size() : response.data->size();
     }
 
     if (evict_ && !evict(size)) {
@@ -290,38 +518,22 @@ std::pair<bool, uint64_t> OfflineDatabase::putInternal(const Resource& resource,
     if (resource.kind == Resource::Kind::Tile) {
         assert(resource.tileData);
         inserted = putTile(*resource.tileData, response,
-                compressed ? compressedData : response.data ? *response.data : "",
-                compressed);
+                compression ? compressedData : response.data ? *response.data : "",
+                compression);
     } else {
         inserted = putResource(resource, response,
-                compressed ? compressedData : response.data ? *response.data : "",
-                compressed);
+                compression ? compressedData : response.data ? *response.data : "",
+                compression);
     }
 
     return { inserted, size };
 }
 
 optional<std::pair<Response, uint64_t>> OfflineDatabase::getResource(const Resource& resource) {
-    // Update accessed timestamp used for LRU eviction.
-    try {
-        mapbox::sqlite::Query accessedQuery{ getStatement("UPDATE resources SET accessed = ?1 WHERE url = ?2") };
-        accessedQuery.bind(1, util::now());
-        accessedQuery.bind(2, resource.url);
-        accessedQuery.run();
-    } catch (const mapbox::sqlite::Exception& ex) {
-        if (ex.code == mapbox::sqlite::ResultCode::NotADB ||
-            ex.code == mapbox::sqlite::ResultCode::Corrupt) {
-            throw;
-        }
-
-        // If we don't have any indication that the database is corrupt, continue as usual.
-        Log::Warning(Event::Database, static_cast<int>(ex.code), "Can't update timestamp: %s", ex.what());
-    }
-
     // clang-format off
     mapbox::sqlite::Query query{ getStatement(
-        //        0      1            2            3       4      5
-        "SELECT etag, expires, must_revalidate, modified, data, compressed "
+        //        0      1            2            3       4      5           6
+        "SELECT etag, expires, must_revalidate, modified, data, compressed, accessed "
         "FROM resources "
         "WHERE url = ?") };
     // clang-format on
@@ -343,12 +555,16 @@ optional<std::pair<Response, uint64_t>> OfflineDatabase::getResource(const Resou
     auto data = query.get<optional<std::string>>(4);
     if (!data) {
         response.noContent = true;
-    } else if (query.get<bool>(5)) {
-        response.data = std::make_shared<std::string>(util::decompress(*data));
-        size = data->length();
     } else {
-        response.data = std::make_shared<std::string>(*data);
         size = data->length();
+        response.data = decompress(std::move(*data), query.get<int>(5));
+    }
+
+    // Record the accessed timestamp used for LRU eviction, unless the stored
+    // one is recent enough already.
+    const Timestamp accessed = accessTime();
+    if (query.get<Timestamp>(6) < accessed) {
+        pendingResourceAccessTimes[resource.url] = accessed;
     }
 
     return std::make_pair(response, size);
@@ -367,7 +583,7 @@ optional<int64_t> OfflineDatabase::hasResource(const Resource& resource) {
 bool OfflineDatabase::putResource(const Resource& resource,
                                   const Response& response,
                                   const std::string& data,
-                                  bool compressed) {
+                                  uint8_t compression) {
     if (response.notModified) {
         // clang-format off
         mapbox::sqlite::Query notModifiedQuery{ getStatement(
@@ -414,7 +630,7 @@ bool OfflineDatabase::putResource(const Resource& resource,
         updateQuery.bind(8, false);
     } else {
         updateQuery.bindBlob(7, data.data(), data.size(), false);
-        updateQuery.bind(8, compressed);
+        updateQuery.bind(8, compression);
     }
 
     updateQuery.run();
@@ -441,7 +657,7 @@ bool OfflineDatabase::putResource(const Resource& resource,
         insertQuery.bind(9, false);
     } else {
         insertQuery.bindBlob(8, data.data(), data.size(), false);
-        insertQuery.bind(9, compressed);
+        insertQuery.bind(9, compression);
     }
 
     insertQuery.run();
@@ -450,39 +666,10 @@ bool OfflineDatabase::putResource(const Resource& resource,
 }
 
 optional<std::pair<Response, uint64_t>> OfflineDatabase::getTile(const Resource::TileData& tile) {
-    // Update accessed timestamp used for LRU eviction.
-    try {
-        // clang-format off
-        mapbox::sqlite::Query accessedQuery{ getStatement(
-            "UPDATE tiles "
-            "SET accessed       = ?1 "
-            "WHERE url_template = ?2 "
-            "  AND pixel_ratio  = ?3 "
-            "  AND x            = ?4 "
-            "  AND y            = ?5 "
-            "  AND z            = ?6 ") };
-        // clang-format on
-
-        accessedQuery.bind(1, util::now());
-        accessedQuery.bind(2, tile.urlTemplate);
-        accessedQuery.bind(3, tile.pixelRatio);
-        accessedQuery.bind(4, tile.x);
-        accessedQuery.bind(5, tile.y);
-        accessedQuery.bind(6, tile.z);
-        accessedQuery.run();
-    } catch (const mapbox::sqlite::Exception& ex) {
-        if (ex.code == mapbox::sqlite::ResultCode::NotADB || ex.code == mapbox::sqlite::ResultCode::Corrupt) {
-            throw;
-        }
-
-        // If we don't have any indication that the database is corrupt, continue as usual.
-        Log::Warning(Event::Database, static_cast<int>(ex.code), "Can't update timestamp: %s", ex.what());
-    }
-
     // clang-format off
     mapbox::sqlite::Query query{ getStatement(
-        //        0      1           2,            3,      4,      5
-        "SELECT etag, expires, must_revalidate, modified, data, compressed "
+        //        0      1           2,            3,      4,      5,          6
+        "SELECT etag, expires, must_revalidate, modified, data, compressed, accessed "
         "FROM tiles "
         "WHERE url_template = ?1 "
         "  AND pixel_ratio  = ?2 "
@@ -512,12 +699,16 @@ optional<std::pair<Response, uint64_t>> OfflineDatabase::getTile(const Resource:
     optional<std::string> data = query.get<optional<std::string>>(4);
     if (!data) {
         response.noContent = true;
-    } else if (query.get<bool>(5)) {
-        response.data = std::make_shared<std::string>(util::decompress(*data));
-        size = data->length();
     } else {
-        response.data = std::make_shared<std::string>(*data);
         size = data->length();
+        response.data = decompress(std::move(*data), query.get<int>(5));
+    }
+
+    // Record the accessed timestamp used for LRU eviction, unless the stored
+    // one is recent enough already.
+    const Timestamp accessed = accessTime();
+    if (query.get<Timestamp>(6) < accessed) {
+        pendingTileAccessTimes[TileKey{ tile.urlTemplate, tile.pixelRatio, tile.x, tile.y, tile.z }] = accessed;
     }
 
     return std::make_pair(response, size);
@@ -551,7 +742,7 @@ optional<int64_t> OfflineDatabase::hasTile(const Resource::TileData& tile) {
 bool OfflineDatabase::putTile(const Resource::TileData& tile,
                               const Response& response,
                               const std::string& data,
-                              bool compressed) {
+                              uint8_t compression) {
     if (response.notModified) {
         // clang-format off
         mapbox::sqlite::Query notModifiedQuery{ getStatement(
@@ -613,7 +804,7 @@ bool OfflineDatabase::putTile(const Resource::TileData& tile,
         updateQuery.bind(7, false);
     } else {
         updateQuery.bindBlob(6, data.data(), data.size(), false);
-        updateQuery.bind(7, compressed);
+        updateQuery.bind(7, compression);
     }
 
     updateQuery.run();
@@ -643,7 +834,7 @@ bool OfflineDatabase::putTile(const Resource::TileData& tile,
         insertQuery.bind(12, false);
     } else {
         insertQuery.bindBlob(11, data.data(), data.size(), false);
-        insertQuery.bind(12, compressed);
+        insertQuery.bind(12, compression);
     }
 
     insertQuery.run();
@@ -652,6 +843,7 @@ bool OfflineDatabase::putTile(const Resource::TileData& tile,
 }
 
 std::exception_ptr OfflineDatabase::invalidateAmbientCache() try {
+    commitBatch();
     // clang-format off
     mapbox::sqlite::Query tileQuery{ getStatement(
         "UPDATE tiles "
@@ -683,6 +875,7 @@ std::exception_ptr OfflineDatabase::invalidateAmbientCache() try {
 }
 
 std::exception_ptr OfflineDatabase::clearAmbientCache() try {
+    commitBatch();
     // clang-format off
     mapbox::sqlite::Query tileQuery{ getStatement(
         "DELETE FROM tiles "
@@ -714,6 +907,7 @@ std::exception_ptr OfflineDatabase::clearAmbientCache() try {
 }
 
 std::exception_ptr OfflineDatabase::invalidateRegion(int64_t regionID) try {
+    commitBatch();
     {
         // clang-format off
         mapbox::sqlite::Query tileQuery{ getStatement(
@@ -776,6 +970,7 @@ expected<OfflineRegions, std::exception_ptr> OfflineDatabase::listRegions() try
 expected<OfflineRegion, std::exception_ptr>
 OfflineDatabase::createRegion(const OfflineRegionDefinition& definition,
                               const OfflineRegionMetadata& metadata) try {
+    commitBatch();
     // clang-format off
     mapbox::sqlite::Query query{ getStatement(
         "INSERT INTO regions (definition, description) "
@@ -794,6 +989,9 @@ OfflineDatabase::createRegion(const OfflineRegionDefinition& definition,
 expected<OfflineRegions, std::exception_ptr>
 OfflineDatabase::mergeDatabase(const std::string& sideDatabasePath) {
     try {
+        // Databases can't be attached within a transaction.
+        commitBatch();
+
         // clang-format off
         mapbox::sqlite::Query query{ getStatement("ATTACH DATABASE ?1 AS side") };
         // clang-format on
@@ -869,6 +1067,7 @@ OfflineDatabase::mergeDatabase(const std::string& sideDatabasePath) {
 
 expected<OfflineRegionMetadata, std::exception_ptr>
 OfflineDatabase::updateMetadata(const int64_t regionID, const OfflineRegionMetadata& metadata) try {
+    commitBatch();
     // clang-format off
     mapbox::sqlite::Query query{ getStatement(
                                   "UPDATE regions SET description = ?1 "
@@ -885,6 +1084,7 @@ OfflineDatabase::updateMetadata(const int64_t regionID, const OfflineRegionMetad
 }
 
 std::exception_ptr OfflineDatabase::deleteRegion(OfflineRegion&& region) try {
+    commitBatch();
     {
         mapbox::sqlite::Query query{ getStatement("DELETE FROM regions WHERE id = ?") };
         query.bind(1, region.getID());
@@ -923,6 +1123,7 @@ uint64_t OfflineDatabase::putRegionResource(int64_t regionID,
     if (!db) {
         initialize();
     }
+    commitBatch();
     mapbox::sqlite::Transaction transaction(*db);
     auto size = putRegionResourceInternal(regionID, resource, response);
     transaction.commit();
@@ -932,12 +1133,13 @@ uint64_t OfflineDatabase::putRegionResource(int64_t regionID,
     return 0;
 }
 
-void OfflineDatabase::putRegionResources(int64_t regionID,
-                                         const std::list<std::tuple<Resource, Response>>& resources,
-                                         OfflineRegionStatus& status) try {
+std::vector<uint64_t> OfflineDatabase::putRegionResources(int64_t regionID,
+                                                          const std::list<std::tuple<Resource, Response>>& resources,
+                                                          OfflineRegionStatus& status) try {
     if (!db) {
         initialize();
     }
+    commitBatch();
     mapbox::sqlite::Transaction transaction(*db);
 
     // Accumulate all statistics locally first before adding them to the OfflineRegionStatus object
@@ -947,12 +1149,16 @@ void OfflineDatabase::putRegionResources(int64_t regionID,
     uint64_t completedTileCount = 0;
     uint64_t completedTileSize = 0;
 
+    std::vector<uint64_t> sizes;
+    sizes.reserve(resources.size());
+
     for (const auto& elem : resources) {
         const auto& resource = std::get<0>(elem);
         const auto& response = std::get<1>(elem);
 
         try {
             uint64_t resourceSize = putRegionResourceInternal(regionID, resource, response);
+            sizes.push_back(resourceSize);
             completedResourceCount++;
             completedResourceSize += resourceSize;
             if (resource.kind == Resource::Kind::Tile) {
@@ -973,8 +1179,70 @@ void OfflineDatabase::putRegionResources(int64_t regionID,
     status.completedResourceSize += completedResourceSize;
     status.completedTileCount += completedTileCount;
     status.completedTileSize += completedTileSize;
+
+    return sizes;
 } catch (...) {
     handleError("write region resources");
+    return {};
+}
+
+// The checkpoint table isn't part of the versioned schema: databases without
+// it remain compatible in both directions, and it is created the first time a
+// checkpoint is accessed. Checkpoints are removed together with their region.
+void OfflineDatabase::createCheckpointTable() {
+    // clang-format off
+    db->exec(
+        "CREATE TABLE IF NOT EXISTS region_download_checkpoints ("
+        "    region_id INTEGER NOT NULL REFERENCES regions(id) ON DELETE CASCADE,"
+        "    key TEXT NOT NULL,"
+        "    count INTEGER NOT NULL,"
+        "    size INTEGER NOT NULL,"
+        "    UNIQUE (region_id, key)"
+        ")");
+    // clang-format on
+}
+
+std::pair<uint64_t, uint64_t> OfflineDatabase::getRegionDownloadCheckpoint(int64_t regionID, const std::string& key) try {
+    if (!db) {
+        initialize();
+    }
+    createCheckpointTable();
+
+    mapbox::sqlite::Query query{ getStatement(
+        "SELECT count, size FROM region_download_checkpoints WHERE region_id = ?1 AND key = ?2") };
+    query.bind(1, regionID);
+    query.bind(2, key);
+
+    if (!query.run()) {
+        return { 0, 0 };
+    }
+
+    return { static_cast<uint64_t>(query.get<int64_t>(0)), static_cast<uint64_t>(query.get<int64_t>(1)) };
+} catch (...) {
+    handleError("read region download checkpoint");
+    return { 0, 0 };
+}
+
+void OfflineDatabase::putRegionDownloadCheckpoint(int64_t regionID, const std::string& key,
+                                                  uint64_t count, uint64_t size) try {
+    if (!db) {
+        initialize();
+    }
+    commitBatch();
+    createCheckpointTable();
+
+    // clang-format off
+    mapbox::sqlite::Query query{ getStatement(
+        "REPLACE INTO region_download_checkpoints (region_id, key, count, size) "
+        "VALUES (?1, ?2, ?3, ?4)") };
+    // clang-format on
+    query.bind(1, regionID);
+    query.bind(2, key);
+    query.bind(3, int64_t(count));
+    query.bind(4, int64_t(size));
+    query.run();
+} catch (...) {
+    handleError("write region download checkpoint");
 }
 
 uint64_t OfflineDatabase::putRegionResourceInternal(int64_t regionID, const Resource& resource, const Response& response) {
@@ -1158,6 +1426,10 @@ bool OfflineDatabase::evict(uint64_t neededFreeSize) {
     // The addition of pageSize is a fudge factor to account for non `data` column
     // size, and because pages can get fragmented on the database.
     while (usedSize() + neededFreeSize + pageSize > maximumAmbientCacheSize) {
+        // Make sure the least recently used entries are determined from
+        // up-to-date access times.
+        updateAccessTimes();
+
         // clang-format off
         mapbox::sqlite::Query accessedQuery{ getStatement(
             "SELECT max(accessed) "
@@ -1228,6 +1500,7 @@ std::exception_ptr OfflineDatabase::setMaximumAmbientCacheSize(uint64_t size) {
     uint64_t previousMaximumAmbientCacheSize = maximumAmbientCacheSize;
 
     try {
+        commitBatch();
         maximumAmbientCacheSize = size;
 
         uint64_t databaseSize = getPragma<int64_t>("PRAGMA page_size")
@@ -1291,17 +1564,20 @@ bool OfflineDatabase::exceedsOfflineMapboxTileCountLimit(const Resource& resourc
         && offlineMapboxTileCountLimitExceeded();
 }
 
-void OfflineDatabase::markUsedResources(int64_t regionID, const std::list<Resource>& resources) try {
+bool OfflineDatabase::markUsedResources(int64_t regionID, const std::list<Resource>& resources) try {
     if (!db) {
         initialize();
     }
+    commitBatch();
     mapbox::sqlite::Transaction transaction(*db);
     for (const auto& resource : resources) {
         markUsed(regionID, resource);
     }
     transaction.commit();
+    return true;
 } catch (...) {
     handleError("mark resources as used");
+    return false;
 }
 
 std::exception_ptr OfflineDatabase::pack() try {
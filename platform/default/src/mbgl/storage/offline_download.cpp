@@ -16,14 +16,16 @@
 #include <mbgl/util/i18n.hpp>
 #include <mbgl/util/mapbox.hpp>
 #include <mbgl/util/run_loop.hpp>
+#include <mbgl/util/string.hpp>
 #include <mbgl/util/tile_cover.hpp>
 #include <mbgl/util/tileset.hpp>
 
+#include <limits>
 #include <set>
 
 namespace {
 
-const size_t kResourcesBatchSize = 64;
+const size_t kResourcesBatchSize = 256;
 const size_t kMarkBatchSize = 200;
 
 } // namespace
@@ -47,27 +49,11 @@ Range<uint8_t> coveringZoomRange(const RegionDefinition& definition,
     return { static_cast<uint8_t>(minZ), static_cast<uint8_t>(maxZ) };
 }
 
-template <class Geometry, class Fn>
-void tileCover(const Geometry& geometry, uint8_t z, Fn&& fn) {
-    util::TileCover cover(geometry, z);
-    while (cover.hasNext()) {
-        fn(cover.next()->canonical);
-    }
-}
-
-
-template <class Fn>
-void tileCover(const OfflineRegionDefinition& definition, style::SourceType type,
-               uint16_t tileSize, const Range<uint8_t>& zoomRange, Fn&& fn) {
-    const Range<uint8_t> clampedZoomRange =
-            definition.match([&](auto& reg) { return coveringZoomRange(reg, type, tileSize, zoomRange); });
-
-    for (uint8_t z = clampedZoomRange.min; z <= clampedZoomRange.max; z++) {
-        definition.match(
-                [&](const OfflineTilePyramidRegionDefinition& reg){ tileCover(reg.bounds, z, fn); },
-                [&](const OfflineGeometryRegionDefinition& reg){ tileCover(reg.geometry, z, fn); }
-        );
-    }
+std::unique_ptr<util::TileCover> tileCover(const OfflineRegionDefinition& definition, uint8_t z) {
+    return definition.match(
+            [&](const OfflineTilePyramidRegionDefinition& reg){ return std::make_unique<util::TileCover>(reg.bounds, z); },
+            [&](const OfflineGeometryRegionDefinition& reg){ return std::make_unique<util::TileCover>(reg.geometry, z); }
+    );
 }
 
 uint64_t tileCount(const OfflineRegionDefinition& definition, style::SourceType type,
@@ -96,7 +82,8 @@ OfflineDownload::OfflineDownload(int64_t id_,
     : id(id_),
       definition(definition_),
       offlineDatabase(offlineDatabase_),
-      onlineFileSource(onlineFileSource_) {
+      onlineFileSource(onlineFileSource_),
+      batchSize(kResourcesBatchSize) {
     setObserver(nullptr);
 }
 
@@ -122,6 +109,17 @@ void OfflineDownload::setState(OfflineRegionDownloadState state) {
     observer->statusChanged(status);
 }
 
+void OfflineDownload::setMaximumConcurrentRequests(uint32_t maximumConcurrentRequests_) {
+    maximumConcurrentRequests = maximumConcurrentRequests_;
+    if (status.downloadState == OfflineRegionDownloadState::Active) {
+        continueDownload();
+    }
+}
+
+void OfflineDownload::setBatchSize(uint32_t batchSize_) {
+    batchSize = std::max(batchSize_, 1u);
+}
+
 OfflineRegionStatus OfflineDownload::getStatus() const {
     if (status.downloadState == OfflineRegionDownloadState::Active) {
         return status;
@@ -361,7 +359,7 @@ void OfflineDownload::activateDownload() {
    the first few errors is fruitless anyway.
 */
 void OfflineDownload::continueDownload() {
-    if (resourcesRemaining.empty() && status.complete()) {
+    if (resourcesRemaining.empty() && tileQueues.empty() && status.complete()) {
         markPendingUsedResources();
         setState(OfflineRegionDownloadState::Inactive);
         return;
@@ -369,16 +367,38 @@ void OfflineDownload::continueDownload() {
 
     if (resourcesToBeMarkedAsUsed.size() >= kMarkBatchSize) markPendingUsedResources();
 
-    while (!resourcesRemaining.empty() && requests.size() < onlineFileSource.getMaximumConcurrentRequests()) {
-        ensureResource(std::move(resourcesRemaining.front()));
-        resourcesRemaining.pop_front();
+    const uint32_t maximumRequests = maximumConcurrentRequests ? *maximumConcurrentRequests
+                                                               : onlineFileSource.getMaximumConcurrentRequests();
+    while (requests.size() < maximumRequests) {
+        if (!resourcesRemaining.empty()) {
+            QueuedResource next = std::move(resourcesRemaining.front());
+            resourcesRemaining.pop_front();
+            ensureResource(std::move(next.resource), {}, next.position);
+        } else if (optional<QueuedResource> tile = nextTile()) {
+            ensureResource(std::move(tile->resource), {}, tile->position);
+        } else {
+            break;
+        }
     }
 }
 
 void OfflineDownload::deactivateDownload() {
     requiredSourceURLs.clear();
     resourcesRemaining.clear();
+    tileQueues.clear();
     requests.clear();
+
+    // Keep what was downloaded so far, and where to resume.
+    try {
+        flushBuffer();
+    } catch (const MapboxTileLimitExceededException&) {
+        // The region is full; the remaining resources are discarded.
+    }
+    buffer.clear();
+    bufferPositions.clear();
+    markPendingUsedResources();
+    saveCheckpoints();
+    checkpoints.clear();
 }
 
 void OfflineDownload::queueResource(Resource&& resource) {
@@ -388,32 +408,149 @@ void OfflineDownload::queueResource(Resource&& resource) {
     if (resource.kind == mbgl::Resource::Kind::Tile) {
         status.requiredTileCount++;
     }
-    resourcesRemaining.push_front(std::move(resource));
+    resourcesRemaining.push_front({ std::move(resource), {} });
 }
 
 void OfflineDownload::queueTiles(SourceType type, uint16_t tileSize, const Tileset& tileset) {
-    tileCover(definition, type, tileSize, tileset.zoomRange, [&](const auto& tile) {
-        status.requiredResourceCount++;
-        status.requiredTileCount++;
+    // The tile cover, and therefore the order of the tiles, depends on all of these.
+    checkpoints.emplace_back();
+    Checkpoint& checkpoint = checkpoints.back();
+    checkpoint.key = tileset.tiles[0] + "\n" + util::toString(uint8_t(type)) + "/" + util::toString(tileSize) + "/" +
+                     util::toString(tileset.zoomRange.min) + "/" + util::toString(tileset.zoomRange.max);
+    std::tie(checkpoint.count, checkpoint.size) = offlineDatabase.getRegionDownloadCheckpoint(id, checkpoint.key);
+    checkpoint.saved = checkpoint.count;
+
+    const Range<uint8_t> zoomRange =
+            definition.match([&](auto& reg) { return coveringZoomRange(reg, type, tileSize, tileset.zoomRange); });
+
+    uint64_t count = 0;
+    for (uint8_t z = zoomRange.min; z <= zoomRange.max; z++) {
+        count += tileCover(definition, z)->skip(std::numeric_limits<uint64_t>::max());
+    }
 
-        auto tileResource = Resource::tile(
-                tileset.tiles[0], definition.match([](auto& def) { return def.pixelRatio; }),
-                tile.x, tile.y, tile.z, tileset.scheme);
+    status.requiredResourceCount += count;
+    status.requiredTileCount += count;
 
-        tileResource.setPriority(Resource::Priority::Low);
-        tileResource.setUsage(Resource::Usage::Offline);
+    if (checkpoint.count > count) {
+        checkpoint.count = checkpoint.size = 0;
+    }
 
-        resourcesRemaining.push_back(std::move(tileResource));
-    });
+    status.completedResourceCount += checkpoint.count;
+    status.completedResourceSize += checkpoint.size;
+    status.completedTileCount += checkpoint.count;
+    status.completedTileSize += checkpoint.size;
+
+    tileQueues.push_back({ tileset, zoomRange, zoomRange.min, nullptr, &checkpoint });
+    TileQueue& queue = tileQueues.back();
+
+    // Skip the tiles before the checkpoint, a row span at a time.
+    while (checkpoint.queued < checkpoint.count && prepareTiles(queue)) {
+        checkpoint.queued += queue.cover->skip(checkpoint.count - checkpoint.queued);
+    }
+
+    if (!prepareTiles(queue)) {
+        tileQueues.pop_back();
+    }
+}
+
+// Returns whether the queue has another tile, moving on to the tile cover of
+// the next zoom level when the current one is exhausted.
+bool OfflineDownload::prepareTiles(TileQueue& queue) {
+    while (!queue.cover || !queue.cover->hasNext()) {
+        if (queue.zoom > queue.zoomRange.max) {
+            return false;
+        }
+        queue.cover = tileCover(definition, queue.zoom++);
+    }
+    return true;
+}
+
+optional<OfflineDownload::QueuedResource> OfflineDownload::nextTile() {
+    if (tileQueues.empty()) {
+        return {};
+    }
+
+    TileQueue& queue = tileQueues.front();
+    const CanonicalTileID tile = queue.cover->next()->canonical;
+
+    auto tileResource = Resource::tile(
+            queue.tileset.tiles[0], definition.match([](auto& def) { return def.pixelRatio; }),
+            tile.x, tile.y, tile.z, queue.tileset.scheme);
+
+    tileResource.setPriority(Resource::Priority::Low);
+    tileResource.setUsage(Resource::Usage::Offline);
+
+    QueuedResource result { std::move(tileResource), CheckpointPosition { queue.checkpoint, queue.checkpoint->queued++ } };
+
+    // Drop exhausted queues right away, so that an empty list means that all tiles were requested.
+    if (!prepareTiles(queue)) {
+        tileQueues.pop_front();
+    }
+
+    return result;
 }
 
 void OfflineDownload::markPendingUsedResources() {
-    offlineDatabase.markUsedResources(id, resourcesToBeMarkedAsUsed);
+    if (resourcesToBeMarkedAsUsed.empty()) {
+        return;
+    }
+
+    if (offlineDatabase.markUsedResources(id, resourcesToBeMarkedAsUsed)) {
+        for (const auto& used : usedPositions) {
+            markStored(used.first, used.second);
+        }
+    }
     resourcesToBeMarkedAsUsed.clear();
+    usedPositions.clear();
+    saveCheckpoints();
+}
+
+void OfflineDownload::flushBuffer() {
+    if (buffer.empty()) {
+        return;
+    }
+
+    const std::vector<uint64_t> sizes = offlineDatabase.putRegionResources(id, buffer, status);
+    if (sizes.size() == buffer.size()) {
+        auto size = sizes.begin();
+        for (const auto& position : bufferPositions) {
+            markStored(position, *size++);
+        }
+    }
+
+    buffer.clear();
+    bufferPositions.clear();
+    saveCheckpoints();
+}
+
+void OfflineDownload::markStored(const optional<CheckpointPosition>& position, uint64_t size) {
+    if (!position) {
+        return;
+    }
+
+    // Tiles complete out of order; the checkpoint only covers an uninterrupted sequence.
+    Checkpoint& checkpoint = *position->checkpoint;
+    checkpoint.stored.emplace(position->index, size);
+    auto it = checkpoint.stored.begin();
+    while (it != checkpoint.stored.end() && it->first == checkpoint.count) {
+        checkpoint.count++;
+        checkpoint.size += it->second;
+        it = checkpoint.stored.erase(it);
+    }
+}
+
+void OfflineDownload::saveCheckpoints() {
+    for (auto& checkpoint : checkpoints) {
+        if (checkpoint.count != checkpoint.saved) {
+            offlineDatabase.putRegionDownloadCheckpoint(id, checkpoint.key, checkpoint.count, checkpoint.size);
+            checkpoint.saved = checkpoint.count;
+        }
+    }
 }
 
 void OfflineDownload::ensureResource(Resource&& resource,
-                                     std::function<void(Response)> callback) {
+                                     std::function<void(Response)> callback,
+                                     optional<CheckpointPosition> position) {
     assert(resource.priority == Resource::Priority::Low);
     assert(resource.usage == Resource::Usage::Offline);
 
@@ -433,7 +570,12 @@ void OfflineDownload::ensureResource(Resource&& resource,
                 }
             }
 
-            if (result) resourcesToBeMarkedAsUsed.emplace_back(resource);
+            if (result) {
+                resourcesToBeMarkedAsUsed.emplace_back(resource);
+                if (position) {
+                    usedPositions.emplace_back(*position, *result);
+                }
+            }
             return result;
         };
 
@@ -472,17 +614,20 @@ void OfflineDownload::ensureResource(Resource&& resource,
 
             // Queue up for batched insertion
             buffer.emplace_back(resource, onlineResponse);
+            bufferPositions.emplace_back(position);
 
             // Flush buffer periodically
-            if (buffer.size() == kResourcesBatchSize || resourcesRemaining.empty()) {
+            if (buffer.size() >= batchSize || (resourcesRemaining.empty() && tileQueues.empty())) {
                 try {
-                    offlineDatabase.putRegionResources(id, buffer, status);
+                    flushBuffer();
                 } catch (const MapboxTileLimitExceededException&) {
+                    // Don't store the partially committed batch again when deactivating.
+                    buffer.clear();
+                    bufferPositions.clear();
                     onMapboxTileCountLimitExceeded();
                     return;
                 }
 
-                buffer.clear();
                 observer->statusChanged(status);
             }
 
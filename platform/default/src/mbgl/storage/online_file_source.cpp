@@ -16,10 +16,12 @@
 #include <mbgl/util/run_loop.hpp>
 #include <mbgl/util/timer.hpp>
 #include <mbgl/util/http_timeout.hpp>
+#include <mbgl/util/url.hpp>
 
 #include <algorithm>
 #include <cassert>
-#include <list>
+#include <set>
+#include <tuple>
 #include <unordered_set>
 #include <unordered_map>
 
@@ -40,6 +42,7 @@ public:
     void completed(Response);
 
     void setTransformedURL(const std::string&& url);
+    void setPriority(double) override;
     ActorRef<OnlineFileRequest> actor();
 
     OnlineFileSource::Impl& impl;
@@ -60,6 +63,11 @@ public:
     uint32_t failedRequests = 0;
     Response::Error::Reason failedRequestReason = Response::Error::Reason::Success;
     optional<Timestamp> retryAfter;
+
+    // Host name the request is counted against while it is active, and the
+    // order in which it was queued, which breaks ties between pending requests.
+    std::string host;
+    uint64_t sequence = 0;
 };
 
 class OnlineFileSource::Impl {
@@ -91,22 +99,29 @@ public:
 
     void remove(OnlineFileRequest* request) {
         allRequests.erase(request);
-        if (activeRequests.erase(request)) {
-            activatePendingRequest();
+        if (deactivateRequest(request)) {
+            activatePendingRequests();
         } else {
             pendingRequests.remove(request);
         }
     }
 
+    void setPriority(OnlineFileRequest* request, double order) {
+        pendingRequests.reorder(request, order);
+    }
+
     void activateOrQueueRequest(OnlineFileRequest* request) {
         assert(allRequests.find(request) != allRequests.end());
         assert(activeRequests.find(request) == activeRequests.end());
         assert(!request->request);
 
-        if (activeRequests.size() >= getMaximumConcurrentRequests()) {
-            queueRequest(request);
-        } else {
+        const util::URL url(request->resource.url);
+        request->host = request->resource.url.substr(url.domain.first, url.domain.second);
+
+        if (canActivate(request)) {
             activateRequest(request);
+        } else {
+            queueRequest(request);
         }
     }
 
@@ -116,13 +131,14 @@ public:
 
     void activateRequest(OnlineFileRequest* request) {
         auto callback = [=](Response response) {
-            activeRequests.erase(request);
+            deactivateRequest(request);
             request->request.reset();
             request->completed(response);
-            activatePendingRequest();
+            activatePendingRequests();
         };
 
         activeRequests.insert(request);
+        activeRequestsPerHost[request->host]++;
 
         if (online) {
             request->request = httpFileSource.request(request->resource, callback);
@@ -135,11 +151,16 @@ public:
 
     }
 
-    void activatePendingRequest() {
+    void activatePendingRequests() {
+        while (activeRequests.size() < maximumConcurrentRequests) {
+            auto request = pendingRequests.pop([this](const OnlineFileRequest* pending) {
+                return canActivate(pending);
+            });
 
-        auto request = pendingRequests.pop();
+            if (!request) {
+                break;
+            }
 
-        if (request) {
             activateRequest(*request);
         }
     }
@@ -171,7 +192,42 @@ public:
         maximumConcurrentRequests = maximumConcurrentRequests_;
     }
 
+    uint32_t getMaximumConcurrentRequestsPerHost() const {
+        return maximumConcurrentRequestsPerHost;
+    }
+
+    void setMaximumConcurrentRequestsPerHost(uint32_t maximumConcurrentRequestsPerHost_) {
+        maximumConcurrentRequestsPerHost = maximumConcurrentRequestsPerHost_;
+    }
+
 private:
+    bool canActivate(const OnlineFileRequest* request) const {
+        if (activeRequests.size() >= maximumConcurrentRequests) {
+            return false;
+        }
+
+        if (maximumConcurrentRequestsPerHost) {
+            auto it = activeRequestsPerHost.find(request->host);
+            return it == activeRequestsPerHost.end() || it->second < maximumConcurrentRequestsPerHost;
+        }
+
+        return true;
+    }
+
+    // Returns true if the request was active.
+    bool deactivateRequest(OnlineFileRequest* request) {
+        if (!activeRequests.erase(request)) {
+            return false;
+        }
+
+        auto it = activeRequestsPerHost.find(request->host);
+        assert(it != activeRequestsPerHost.end());
+        if (--it->second == 0) {
+            activeRequestsPerHost.erase(it);
+        }
+
+        return true;
+    }
 
     void networkIsReachableAgain() {
         // Notify regular priority requests.
@@ -189,67 +245,77 @@ private:
         }
     }
 
-    // Using Pending Requests as an priority queue which processes
-    // file requests in a FIFO manner but prefers regular requests
-    // over offline requests with a low priority such that low priority
-    // requests do not throttle regular requests.
-    //
-    // The order of a queue is therefore:
+    // Resources that other resources depend on, or that block rendering of
+    // the whole map, are loaded before the rest.
+    static uint8_t kindPriority(Resource::Kind kind) {
+        switch (kind) {
+        case Resource::Kind::Style: return 0;
+        case Resource::Kind::Source: return 1;
+        case Resource::Kind::Glyphs: return 2;
+        case Resource::Kind::SpriteJSON:
+        case Resource::Kind::SpriteImage: return 3;
+        case Resource::Kind::Unknown:
+        case Resource::Kind::Image: return 4;
+        case Resource::Kind::Tile: return 5;
+        }
+        return 4;
+    }
+
+    // Pending requests are ordered by their priority, so that low priority
+    // requests do not throttle regular requests, then by their kind, then by
+    // Resource::order, which tiles update while they wait. Requests that
+    // compare equal are processed in a FIFO manner.
     //
-    // hi0 -- hi1 -- hi2 -- hi3 -- lo0 -- lo1 --lo2
-    //                              ^
-    //                              firstLowPriorityRequest
+    // Requests can't change their position while they're in the queue, so
+    // they must be removed and reinserted when their order changes.
 
     struct PendingRequests {
-        PendingRequests() : queue(), firstLowPriorityRequest(queue.begin()) {}
+        struct Compare {
+            bool operator()(const OnlineFileRequest* lhs, const OnlineFileRequest* rhs) const {
+                return std::make_tuple(lhs->resource.priority, kindPriority(lhs->resource.kind),
+                                       lhs->resource.order, lhs->sequence, lhs) <
+                       std::make_tuple(rhs->resource.priority, kindPriority(rhs->resource.kind),
+                                       rhs->resource.order, rhs->sequence, rhs);
+            }
+        };
 
-        std::list<OnlineFileRequest*> queue;
-        std::list<OnlineFileRequest*>::iterator firstLowPriorityRequest;
+        std::set<OnlineFileRequest*, Compare> queue;
+        uint64_t nextSequence = 0;
 
-        void remove(const OnlineFileRequest* request) {
-            auto it = std::find(queue.begin(), queue.end(), request);
-            if (it != queue.end()) {
-                if (it == firstLowPriorityRequest) {
-                    firstLowPriorityRequest++;
-                }
-                queue.erase(it);
-            }
+        void remove(OnlineFileRequest* request) {
+            queue.erase(request);
         }
 
         void insert(OnlineFileRequest* request) {
-            if (request->resource.priority == Resource::Priority::Regular) {
-                firstLowPriorityRequest = queue.insert(firstLowPriorityRequest, request);
-                firstLowPriorityRequest++;
-            }
-            else {
-                if (firstLowPriorityRequest == queue.end()) {
-                    firstLowPriorityRequest = queue.insert(queue.end(), request);
-                }
-                else {
-                    queue.insert(queue.end(), request);
-                }
-            }
+            request->sequence = nextSequence++;
+            queue.insert(request);
         }
 
-
-        optional<OnlineFileRequest*> pop() {
-            if (queue.empty()) {
-                return optional<OnlineFileRequest*>();
+        void reorder(OnlineFileRequest* request, double order) {
+            if (queue.erase(request)) {
+                request->resource.order = order;
+                queue.insert(request);
+            } else {
+                request->resource.order = order;
             }
+        }
 
-            if (queue.begin() == firstLowPriorityRequest) {
-                firstLowPriorityRequest++;
+        // Removes and returns the first request that satisfies the predicate.
+        template <typename Predicate>
+        optional<OnlineFileRequest*> pop(Predicate&& predicate) {
+            for (auto it = queue.begin(); it != queue.end(); ++it) {
+                if (predicate(*it)) {
+                    OnlineFileRequest* next = *it;
+                    queue.erase(it);
+                    return next;
+                }
             }
-
-            OnlineFileRequest* next = queue.front();
-            queue.pop_front();
-            return optional<OnlineFileRequest*>(next);
+            return {};
         }
 
         bool contains(OnlineFileRequest* request) const {
-            return (std::find(queue.begin(), queue.end(), request) != queue.end());
+            return queue.find(request) != queue.end();
         }
-
     };
 
     optional<ActorRef<ResourceTransform>> resourceTransform;
@@ -263,16 +329,19 @@ private:
      * 4. Back to #1
      *
      * Requests in any state are in `allRequests`. Requests in the pending state are in
-     * `pendingRequests`. Requests in the active state are in `activeRequests`.
+     * `pendingRequests`. Requests in the active state are in `activeRequests`, and are
+     * counted in `activeRequestsPerHost`.
      */
     std::unordered_set<OnlineFileRequest*> allRequests;
 
     PendingRequests pendingRequests;
 
     std::unordered_set<OnlineFileRequest*> activeRequests;
+    std::unordered_map<std::string, uint32_t> activeRequestsPerHost;
 
     bool online = true;
     uint32_t maximumConcurrentRequests;
+    uint32_t maximumConcurrentRequestsPerHost = 0;
     HTTPFileSource httpFileSource;
     util::AsyncTask reachability { std::bind(&Impl::networkIsReachableAgain, this) };
 };
@@ -474,6 +543,10 @@ void OnlineFileRequest::setTransformedURL(const std::string&& url) {
     schedule();
 }
 
+void OnlineFileRequest::setPriority(double order) {
+    impl.setPriority(this, order);
+}
+
 ActorRef<OnlineFileRequest> OnlineFileRequest::actor() {
     if (!mailbox) {
         // Lazy constructed because this can be costly and
@@ -492,6 +565,14 @@ uint32_t OnlineFileSource::getMaximumConcurrentRequests() const {
     return impl->getMaximumConcurrentRequests();
 }
 
+void OnlineFileSource::setMaximumConcurrentRequestsPerHost(uint32_t maximumConcurrentRequestsPerHost_) {
+    impl->setMaximumConcurrentRequestsPerHost(maximumConcurrentRequestsPerHost_);
+}
+
+uint32_t OnlineFileSource::getMaximumConcurrentRequestsPerHost() const {
+    return impl->getMaximumConcurrentRequestsPerHost();
+}
+
 
 // For testing only:
 
@@ -6,9 +6,11 @@
 #include <zlib.h>
 #endif
 
+#include <algorithm>
 #include <cstdio>
 #include <cstring>
 #include <stdexcept>
+#include <vector>
 
 // Check zlib library version.
 const static bool zlibVersionCheck __attribute__((unused)) = []() {
@@ -31,74 +33,210 @@ namespace util {
 // cause a link error.
 #undef compress
 
-std::string compress(const std::string &raw) {
-    z_stream deflate_stream;
-    memset(&deflate_stream, 0, sizeof(deflate_stream));
+namespace {
 
-    // TODO: reuse z_streams
-    if (deflateInit(&deflate_stream, Z_DEFAULT_COMPRESSION) != Z_OK) {
-        throw std::runtime_error("failed to initialize deflate");
+// Output grows by at least this many bytes at a time.
+constexpr std::size_t minimumChunkSize = 16384;
+
+// Runs |process| until it stops producing output, writing directly into the
+// spare capacity of |out|, which grows geometrically.
+template <typename Process>
+int pump(z_stream& stream, std::string& out, Process process) {
+    std::size_t used = out.size();
+    int code;
+    do {
+        const std::size_t chunk = std::max(out.capacity() - used, std::max(used, minimumChunkSize));
+        out.resize(used + chunk);
+        stream.next_out = reinterpret_cast<Bytef*>(&out[used]);
+        stream.avail_out = uInt(chunk);
+        code = process();
+        used += chunk - stream.avail_out;
+    } while (code == Z_OK && stream.avail_out == 0);
+    out.resize(used);
+    return code;
+}
+
+template <typename Stream>
+std::unique_ptr<Stream> acquire(std::vector<std::unique_ptr<Stream>>& streams) {
+    if (streams.empty()) {
+        return std::make_unique<Stream>();
     }
+    std::unique_ptr<Stream> stream = std::move(streams.back());
+    streams.pop_back();
+    return stream;
+}
 
-    deflate_stream.next_in = (Bytef *)raw.data();
-    deflate_stream.avail_in = uInt(raw.size());
+template <typename Stream>
+void release(std::vector<std::unique_ptr<Stream>>& streams, std::unique_ptr<Stream> stream) {
+    if (stream->reset()) {
+        streams.push_back(std::move(stream));
+    }
+}
 
-    std::string result;
-    char out[16384];
+} // namespace
 
-    int code;
-    do {
-        deflate_stream.next_out = reinterpret_cast<Bytef *>(out);
-        deflate_stream.avail_out = sizeof(out);
-        code = deflate(&deflate_stream, Z_FINISH);
-        if (result.size() < deflate_stream.total_out) {
-            // append the block to the output string
-            result.append(out, deflate_stream.total_out - result.size());
+class Compressor::Stream {
+public:
+    Stream() {
+        memset(&stream, 0, sizeof(stream));
+        if (deflateInit(&stream, Z_DEFAULT_COMPRESSION) != Z_OK) {
+            throw std::runtime_error("failed to initialize deflate");
         }
-    } while (code == Z_OK);
+    }
 
-    deflateEnd(&deflate_stream);
+    ~Stream() { deflateEnd(&stream); }
 
-    if (code != Z_STREAM_END) {
-        throw std::runtime_error(deflate_stream.msg);
+    bool reset() { return deflateReset(&stream) == Z_OK; }
+
+    z_stream stream;
+};
+
+class Decompressor::Stream {
+public:
+    Stream() {
+        memset(&stream, 0, sizeof(stream));
+        // Accept both zlib and gzip headers.
+        if (inflateInit2(&stream, MAX_WBITS + 32) != Z_OK) {
+            throw std::runtime_error("failed to initialize inflate");
+        }
     }
 
-    return result;
+    ~Stream() { inflateEnd(&stream); }
+
+    bool reset() { return inflateReset(&stream) == Z_OK; }
+
+    z_stream stream;
+};
+
+Compressor::Compressor() : stream(std::make_unique<Stream>()) {
 }
 
-std::string decompress(const std::string &raw) {
-    z_stream inflate_stream;
-    memset(&inflate_stream, 0, sizeof(inflate_stream));
+Compressor::Compressor(CompressionPool& pool_)
+    : pool(&pool_), stream(acquire(pool_.compressors)) {
+}
 
-    // TODO: reuse z_streams
-    if (inflateInit(&inflate_stream) != Z_OK) {
-        throw std::runtime_error("failed to initialize inflate");
+Compressor::~Compressor() {
+    if (pool) {
+        release(pool->compressors, std::move(stream));
     }
+}
 
-    inflate_stream.next_in = (Bytef *)raw.data();
-    inflate_stream.avail_in = uInt(raw.size());
+void Compressor::write(const char* data, std::size_t size, std::string& out) {
+    z_stream& z = stream->stream;
+    z.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data));
+    z.avail_in = uInt(size);
+
+    // Reserve the worst case output size up front.
+    out.reserve(out.size() + deflateBound(&z, uLong(size)));
+    while (z.avail_in > 0) {
+        const int code = pump(z, out, [&] { return deflate(&z, Z_NO_FLUSH); });
+        if (code != Z_OK && code != Z_BUF_ERROR) {
+            throw std::runtime_error(z.msg ? z.msg : "compression error");
+        }
+    }
+}
 
-    std::string result;
-    char out[15384];
+void Compressor::finish(std::string& out) {
+    z_stream& z = stream->stream;
+    z.next_in = nullptr;
+    z.avail_in = 0;
 
     int code;
     do {
-        inflate_stream.next_out = reinterpret_cast<Bytef *>(out);
-        inflate_stream.avail_out = sizeof(out);
-        code = inflate(&inflate_stream, 0);
-        // result.append(out, sizeof(out) - inflate_stream.avail_out);
-        if (result.size() < inflate_stream.total_out) {
-            result.append(out, inflate_stream.total_out - result.size());
-        }
+        code = pump(z, out, [&] { return deflate(&z, Z_FINISH); });
     } while (code == Z_OK);
 
-    inflateEnd(&inflate_stream);
+    const char* message = z.msg;
+    deflateReset(&z);
 
     if (code != Z_STREAM_END) {
-        throw std::runtime_error(inflate_stream.msg ? inflate_stream.msg : "decompression error");
+        throw std::runtime_error(message ? message : "compression error");
+    }
+}
+
+Decompressor::Decompressor() : stream(std::make_unique<Stream>()) {
+}
+
+Decompressor::Decompressor(CompressionPool& pool_)
+    : pool(&pool_), stream(acquire(pool_.decompressors)) {
+}
+
+Decompressor::~Decompressor() {
+    if (pool) {
+        release(pool->decompressors, std::move(stream));
+    }
+}
+
+void Decompressor::write(const char* data, std::size_t size, std::string& out) {
+    z_stream& z = stream->stream;
+    z.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data));
+    z.avail_in = uInt(size);
+
+    while (z.avail_in > 0 && !ended) {
+        const int code = pump(z, out, [&] { return inflate(&z, Z_NO_FLUSH); });
+        if (code == Z_STREAM_END) {
+            ended = true;
+        } else if (code != Z_OK && code != Z_BUF_ERROR) {
+            const char* message = z.msg;
+            inflateReset(&z);
+            throw std::runtime_error(message ? message : "decompression error");
+        }
     }
+}
+
+void Decompressor::finish() {
+    const bool complete = ended;
+    ended = false;
+    inflateReset(&stream->stream);
+
+    if (!complete) {
+        throw std::runtime_error("decompression error");
+    }
+}
+
+namespace {
 
+std::string compressWith(Compressor& compressor, const std::string& raw) {
+    std::string result;
+    compressor.write(raw.data(), raw.size(), result);
+    compressor.finish(result);
     return result;
 }
+
+std::string decompressWith(Decompressor& decompressor, const std::string& raw) {
+    std::string result;
+    // Compressed tiles and resources typically expand to a few times their size.
+    result.reserve(std::max(raw.size() * 3, minimumChunkSize));
+    decompressor.write(raw.data(), raw.size(), result);
+    decompressor.finish();
+    return result;
+}
+
+} // namespace
+
+CompressionPool::CompressionPool() = default;
+
+CompressionPool::~CompressionPool() = default;
+
+std::string CompressionPool::compress(const std::string& raw) {
+    Compressor compressor(*this);
+    return compressWith(compressor, raw);
+}
+
+std::string CompressionPool::decompress(const std::string& raw) {
+    Decompressor decompressor(*this);
+    return decompressWith(decompressor, raw);
+}
+
+std::string compress(const std::string& raw) {
+    Compressor compressor;
+    return compressWith(compressor, raw);
+}
+
+std::string decompress(const std::string& raw) {
+    Decompressor decompressor;
+    return decompressWith(decompressor, raw);
+}
+
 } // namespace util
 } // namespace mbgl
@@ -463,5 +463,31 @@ void Transaction::rollback() {
     dbImpl.exec("ROLLBACK TRANSACTION");
 }
 
+Savepoint::Savepoint(Database& db_, const char* name_)
+    : dbImpl(*db_.impl), name(name_) {
+    dbImpl.exec("SAVEPOINT " + name);
+}
+
+Savepoint::~Savepoint() {
+    if (needRollback) {
+        try {
+            rollback();
+        } catch (...) {
+            // Ignore failed rollbacks in destructor.
+        }
+    }
+}
+
+void Savepoint::release() {
+    needRollback = false;
+    dbImpl.exec("RELEASE " + name);
+}
+
+void Savepoint::rollback() {
+    needRollback = false;
+    dbImpl.exec("ROLLBACK TO " + name);
+    dbImpl.exec("RELEASE " + name);
+}
+
 } // namespace sqlite
 } // namespace mapbox
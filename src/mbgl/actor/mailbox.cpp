@@ -27,7 +27,7 @@ void Mailbox::open(Scheduler& scheduler_) {
     }
     
     if (!queue.empty()) {
-        (*scheduler)->schedule(makeClosure(shared_from_this()));
+        scheduleReceive();
     }
 }
 
@@ -45,6 +45,22 @@ void Mailbox::close() {
 
 bool Mailbox::isOpen() const { return bool(scheduler); }
 
+void Mailbox::setPriority(double priority_) {
+    priority = priority_;
+    prioritized = true;
+}
+
+void Mailbox::scheduleReceive() {
+    if (prioritized) {
+        // The priority lives as long as the mailbox itself; once the mailbox is
+        // gone the scheduled closure is a no-op anyway.
+        std::shared_ptr<const TaskPriority> taskPriority(shared_from_this(), &priority);
+        (*scheduler)->scheduleWithPriority(makeClosure(shared_from_this()), taskPriority);
+    } else {
+        (*scheduler)->schedule(makeClosure(shared_from_this()));
+    }
+}
+
 
 void Mailbox::push(std::unique_ptr<Message> message) {
     std::lock_guard<std::mutex> pushingLock(pushingMutex);
@@ -57,7 +73,7 @@ void Mailbox::push(std::unique_ptr<Message> message) {
     bool wasEmpty = queue.empty();
     queue.push(std::move(message));
     if (wasEmpty && scheduler) {
-        (*scheduler)->schedule(makeClosure(shared_from_this()));
+        scheduleReceive();
     }
 }
 
@@ -84,7 +100,7 @@ void Mailbox::receive() {
     (*message)();
 
     if (!wasEmpty) {
-        (*scheduler)->schedule(makeClosure(shared_from_this()));
+        scheduleReceive();
     }
 }
 
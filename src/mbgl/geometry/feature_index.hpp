@@ -76,6 +76,12 @@ public:
 
     void setBucketLayerIDs(const std::string& bucketLeaderID, const std::vector<std::string>& layerIDs);
 
+    // Approximate number of bytes used by the spatial index and the tile data,
+    // including the features decoded from it.
+    std::size_t getMemoryUsage() const {
+        return grid.getMemoryUsage() + (tileData ? tileData->getMemoryUsage() : 0);
+    }
+
     std::unordered_map<std::string, std::vector<Feature>> lookupSymbolFeatures(
         const std::vector<IndexedSubfeature>& symbolFeatures,
         const RenderedQueryOptions& options,
@@ -2,6 +2,7 @@
 
 #include <memory>
 #include <cassert>
+#include <cstdint>
 
 namespace mbgl {
 namespace gfx {
@@ -21,6 +22,10 @@ public:
 
     std::size_t elements;
 
+    std::size_t bytes() const {
+        return elements * sizeof(uint16_t);
+    }
+
     template <typename T = IndexBufferResource>
     T& getResource() const {
         assert(resource);
@@ -20,6 +20,10 @@ public:
         v.resize(v.size() + n, val);
     }
 
+    void reserve(std::size_t n) {
+        v.reserve(n);
+    }
+
     Vertex& at(std::size_t n) {
         assert(n < v.size());
         return v.at(n);
@@ -5,6 +5,7 @@
 #include <mbgl/renderer/render_layer.hpp>
 #include <mbgl/style/expression/image.hpp>
 #include <mbgl/style/layer_properties.hpp>
+#include <mbgl/util/monotonic_arena.hpp>
 
 namespace mbgl {
 
@@ -20,7 +21,7 @@ using PatternLayerMap = std::map<std::string, PatternDependency>;
 class PatternFeature  {
 public:
     const uint32_t i;
-    std::unique_ptr<GeometryTileFeature> feature;
+    const GeometryTileFeature* feature;
     PatternLayerMap patterns;
 };
 
@@ -63,8 +64,8 @@ public:
 
         const size_t featureCount = sourceLayer->featureCount();
         for (size_t i = 0; i < featureCount; ++i) {
-            auto feature = sourceLayer->getFeature(i);
-            if (!leaderLayerProperties->layerImpl().filter(style::expression::EvaluationContext { this->zoom, feature.get() }))
+            const GeometryTileFeature* feature = sourceLayer->getTemporaryFeature(i, arena);
+            if (!leaderLayerProperties->layerImpl().filter(style::expression::EvaluationContext { this->zoom, feature }))
                 continue;
 
             PatternLayerMap patternDependencyMap;
@@ -98,7 +99,7 @@ public:
                     }
                 }
             }
-            features.push_back({static_cast<uint32_t>(i), std::move(feature), patternDependencyMap});
+            features.push_back({static_cast<uint32_t>(i), feature, patternDependencyMap});
         }
     };
 
@@ -112,13 +113,15 @@ public:
         auto bucket = std::make_shared<BucketType>(layout, layerPropertiesMap, zoom, overscaling);
         for (auto & patternFeature : features) {
             const auto i = patternFeature.i;
-            std::unique_ptr<GeometryTileFeature> feature = std::move(patternFeature.feature);
+            const GeometryTileFeature& feature = *patternFeature.feature;
             const PatternLayerMap& patterns = patternFeature.patterns;
-            const GeometryCollection& geometries = feature->getGeometries();
+            const GeometryCollection& geometries = feature.getGeometries();
 
-            bucket->addFeature(*feature, geometries, patternPositions, patterns, i);
+            bucket->addFeature(feature, geometries, patternPositions, patterns, i);
             featureIndex->insert(geometries, i, sourceLayerID, bucketLeaderID);
         }
+        bucket->finishFeatures();
+        features.clear();
         if (bucket->hasData()) {
             for (const auto& pair : layerPropertiesMap) {
                 renderData.emplace(pair.first, LayerRenderData {bucket, pair.second});
@@ -131,6 +134,8 @@ private:
     std::string bucketLeaderID;
 
     const std::unique_ptr<GeometryTileLayer> sourceLayer;
+    // Owns the features read from the source layer until the bucket is created.
+    util::MonotonicArena arena;
     std::vector<PatternFeature> features;
     PossiblyEvaluatedLayoutPropertiesType layout;
 
@@ -12,23 +12,29 @@ namespace mbgl {
 
 class SymbolFeature : public GeometryTileFeature {
 public:
-    SymbolFeature(std::unique_ptr<GeometryTileFeature> feature_) :
-        feature(std::move(feature_)),
-        geometry(feature->getGeometries().clone()) // we need a mutable copy of the geometry for mergeLines()
+    // `feature_` is owned by the layout, and outlives the symbol feature. Only
+    // features that are passed to mergeLines() need a mutable copy of their
+    // geometry; the others read the geometry of `feature_`.
+    SymbolFeature(const GeometryTileFeature& feature_, bool copyGeometry) :
+        feature(&feature_),
+        geometry(copyGeometry ? feature->getGeometries().clone() : GeometryCollection()),
+        ownsGeometry(copyGeometry)
     {}
     
     FeatureType getType() const override { return feature->getType(); }
     optional<Value> getValue(const std::string& key) const override { return feature->getValue(key); };
+    optional<Value> getPropertyValue(const FeaturePropertyKey& key) const override { return feature->getPropertyValue(key); };
     const PropertyMap& getProperties() const override { return feature->getProperties(); };
     FeatureIdentifier getID() const override { return feature->getID(); };
-    const GeometryCollection& getGeometries() const override { return geometry; };
+    const GeometryCollection& getGeometries() const override { return ownsGeometry ? geometry : feature->getGeometries(); };
 
     friend bool operator < (const SymbolFeature& lhs, const SymbolFeature& rhs) {
         return lhs.sortKey <  rhs.sortKey;
     }
 
-    std::unique_ptr<GeometryTileFeature> feature;
+    const GeometryTileFeature* feature;
     GeometryCollection geometry;
+    bool ownsGeometry;
     optional<TaggedString> formattedText;
     optional<style::expression::Image> icon;
     float sortKey = 0.0f;
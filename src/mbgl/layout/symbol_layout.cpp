@@ -128,14 +128,16 @@ SymbolLayout::SymbolLayout(const BucketParameters& parameters,
         layerPaintProperties.emplace(layer->baseImpl->id, layer);
     }
 
+    const bool isLinePlacement = layout->get<SymbolPlacement>() == SymbolPlacementType::Line;
+
     // Determine glyph dependencies
     const size_t featureCount = sourceLayer->featureCount();
     for (size_t i = 0; i < featureCount; ++i) {
-        auto feature = sourceLayer->getFeature(i);
-        if (!leader.filter(expression::EvaluationContext { this->zoom, feature.get() }))
+        const GeometryTileFeature* feature = sourceLayer->getTemporaryFeature(i, arena);
+        if (!leader.filter(expression::EvaluationContext { this->zoom, feature }))
             continue;
 
-        SymbolFeature ft(std::move(feature));
+        SymbolFeature ft(*feature, isLinePlacement);
 
         ft.index = i;
 
@@ -202,7 +204,7 @@ SymbolLayout::SymbolLayout(const BucketParameters& parameters,
         }
     }
 
-    if (layout->get<SymbolPlacement>() == SymbolPlacementType::Line) {
+    if (isLinePlacement) {
         util::mergeLines(features);
     }
 }
@@ -349,7 +351,7 @@ void SymbolLayout::prepareSymbols(const GlyphMap& glyphMap,
 
     for (auto it = features.begin(); it != features.end(); ++it) {
         auto& feature = *it;
-        if (feature.geometry.empty()) continue;
+        if (feature.getGeometries().empty()) continue;
 
         ShapedTextOrientations shapedTextOrientations;
         optional<PositionedIcon> shapedIcon;
@@ -608,7 +610,7 @@ void SymbolLayout::addFeature(const std::size_t layoutFeatureIndex,
     const auto& type = feature.getType();
 
     if (layout->get<SymbolPlacement>() == SymbolPlacementType::Line) {
-        auto clippedLines = util::clipLines(feature.geometry, 0, 0, util::EXTENT, util::EXTENT);
+        auto clippedLines = util::clipLines(feature.getGeometries(), 0, 0, util::EXTENT, util::EXTENT);
         for (auto& line : clippedLines) {
             Anchors anchors = getAnchors(line,
                                          symbolSpacing,
@@ -630,7 +632,7 @@ void SymbolLayout::addFeature(const std::size_t layoutFeatureIndex,
     } else if (layout->get<SymbolPlacement>() == SymbolPlacementType::LineCenter) {
         // No clipping, multiple lines per feature are allowed
         // "lines" with only one point are ignored as in clipLines
-        for (const auto& line : feature.geometry) {
+        for (const auto& line : feature.getGeometries()) {
             if (line.size() > 1) {
                 optional<Anchor> anchor = getCenterAnchor(line,
                                                           textMaxAngle,
@@ -646,7 +648,7 @@ void SymbolLayout::addFeature(const std::size_t layoutFeatureIndex,
             }
         }
     } else if (type == FeatureType::Polygon) {
-        for (const auto& polygon : classifyRings(feature.geometry)) {
+        for (const auto& polygon : classifyRings(feature.getGeometries())) {
             Polygon<double> poly;
             for (const auto& ring : polygon) {
                 LinearRing<double> r;
@@ -662,12 +664,12 @@ void SymbolLayout::addFeature(const std::size_t layoutFeatureIndex,
             addSymbolInstance(anchor, createSymbolInstanceSharedData(polygon[0]));
         }
     } else if (type == FeatureType::LineString) {
-        for (const auto& line : feature.geometry) {
+        for (const auto& line : feature.getGeometries()) {
             Anchor anchor(line[0].x, line[0].y, 0, minScale);
             addSymbolInstance(anchor, createSymbolInstanceSharedData(line));
         }
     } else if (type == FeatureType::Point) {
-        for (const auto& points : feature.geometry) {
+        for (const auto& points : feature.getGeometries()) {
             for (const auto& point : points) {
                 Anchor anchor(point.x, point.y, 0, minScale);
                 addSymbolInstance(anchor, createSymbolInstanceSharedData({point}));
@@ -767,8 +769,8 @@ void SymbolLayout::createBucket(const ImagePositions&, std::unique_ptr<FeatureIn
             }
 
             for (auto& pair : bucket->paintProperties) {
-                pair.second.iconBinders.populateVertexVectors(feature, iconBuffer.vertices.elements(),
-                                                              symbolInstance.dataFeatureIndex, {}, {});
+                pair.second.iconBinders.queueVertexVectors(feature, iconBuffer.vertices.elements(),
+                                                           symbolInstance.dataFeatureIndex, {}, {});
             }
         }
 
@@ -801,6 +803,12 @@ void SymbolLayout::createBucket(const ImagePositions&, std::unique_ptr<FeatureIn
         symbolInstance.releaseSharedData();
     }
 
+    // Icon paint properties are evaluated for all symbols at once, while text paint
+    // properties were evaluated per formatted section above.
+    for (auto& pair : bucket->paintProperties) {
+        pair.second.iconBinders.populateQueuedVertexVectors();
+    }
+
     if (showCollisionBoxes) {
         addToDebugBuffers(*bucket);
     }
@@ -7,6 +7,7 @@
 #include <mbgl/layout/symbol_instance.hpp>
 #include <mbgl/text/bidi.hpp>
 #include <mbgl/renderer/buckets/symbol_bucket.hpp>
+#include <mbgl/util/monotonic_arena.hpp>
 
 #include <memory>
 #include <map>
@@ -99,6 +100,9 @@ private:
     // Stores the layer so that we can hold on to GeometryTileFeature instances in SymbolFeature,
     // which may reference data from this object.
     const std::unique_ptr<GeometryTileLayer> sourceLayer;
+    // Owns the features read from the source layer, which are referenced by
+    // `features` until the bucket is created.
+    util::MonotonicArena arena;
     const float overscaling;
     const float zoom;
     const MapMode mode;
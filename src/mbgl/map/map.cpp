@@ -333,6 +333,8 @@ MapOptions Map::getMapOptions() const {
         .withConstrainMode(impl->transform.getConstrainMode())
         .withViewportMode(impl->transform.getViewportMode())
         .withCrossSourceCollisions(impl->crossSourceCollisions)
+        .withParallelTileParsing(impl->parallelTileParsing)
+        .withTileCacheMemoryLimit(impl->tileCacheMemoryLimit)
         .withNorthOrientation(impl->transform.getNorthOrientation())
         .withSize(impl->transform.getState().getSize())
         .withPixelRatio(impl->pixelRatio));
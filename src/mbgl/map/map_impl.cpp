@@ -17,6 +17,8 @@ Map::Impl::Impl(RendererFrontend& frontend_,
           mode(mapOptions.mapMode()),
           pixelRatio(mapOptions.pixelRatio()),
           crossSourceCollisions(mapOptions.crossSourceCollisions()),
+          parallelTileParsing(mapOptions.parallelTileParsing()),
+          tileCacheMemoryLimit(mapOptions.tileCacheMemoryLimit()),
           fileSource(std::move(fileSource_)),
           style(std::make_unique<style::Style>(*fileSource, pixelRatio)),
           annotationManager(*style) {
@@ -66,7 +68,9 @@ void Map::Impl::onUpdate() {
         fileSource,
         prefetchZoomDelta,
         bool(stillImageRequest),
-        crossSourceCollisions
+        crossSourceCollisions,
+        parallelTileParsing,
+        tileCacheMemoryLimit
     };
 
     rendererFrontend.update(std::make_shared<UpdateParameters>(std::move(params)));
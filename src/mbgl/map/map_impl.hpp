@@ -59,6 +59,8 @@ public:
     const MapMode mode;
     const float pixelRatio;
     const bool crossSourceCollisions;
+    const bool parallelTileParsing;
+    const std::size_t tileCacheMemoryLimit;
 
     MapDebugOptions debugOptions { MapDebugOptions::NoDebug };
 
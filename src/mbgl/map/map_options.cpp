@@ -9,6 +9,8 @@ public:
     ViewportMode viewportMode = ViewportMode::Default;
     NorthOrientation orientation = NorthOrientation::Upwards;
     bool crossSourceCollisions = true;
+    bool parallelTileParsing = false;
+    std::size_t tileCacheMemoryLimit = 0;
     Size size = { 64, 64 };
     float pixelRatio = 1.0;
 };
@@ -54,6 +56,24 @@ bool MapOptions::crossSourceCollisions() const {
     return impl_->crossSourceCollisions;
 }
 
+MapOptions& MapOptions::withParallelTileParsing(bool enableParallelParsing) {
+    impl_->parallelTileParsing = enableParallelParsing;
+    return *this;
+}
+
+bool MapOptions::parallelTileParsing() const {
+    return impl_->parallelTileParsing;
+}
+
+MapOptions& MapOptions::withTileCacheMemoryLimit(std::size_t bytes) {
+    impl_->tileCacheMemoryLimit = bytes;
+    return *this;
+}
+
+std::size_t MapOptions::tileCacheMemoryLimit() const {
+    return impl_->tileCacheMemoryLimit;
+}
+
 MapOptions& MapOptions::withNorthOrientation(NorthOrientation orientation) {
     impl_->orientation = orientation;
     return *this;
@@ -35,6 +35,11 @@ public:
     virtual void addFeature(const GeometryTileFeature&, const GeometryCollection&, const ImagePositions&,
                             const PatternLayerMap&, std::size_t){};
 
+    // Called once all features were added. Paint property values of the added
+    // features may be evaluated here in one batch, so the features passed to
+    // addFeature() must stay alive until this is called.
+    virtual void finishFeatures() {}
+
     virtual void update(const FeatureStates&, const GeometryTileLayer&, const std::string&, const ImagePositions&) {}
 
     // As long as this bucket has a Prepare render pass, this function is getting called. Typically,
@@ -43,6 +48,10 @@ public:
 
     virtual bool hasData() const = 0;
 
+    // Approximate number of bytes held by the bucket's vertex, index and image
+    // data, whether it still lives in client memory or has been uploaded.
+    virtual std::size_t getMemoryUsage() const { return 0; }
+
     virtual float getQueryRadius(const RenderLayer&) const {
         return 0;
     };
@@ -59,6 +68,9 @@ public:
     virtual std::pair<uint32_t, bool> registerAtCrossTileIndex(CrossTileSymbolLayerIndex&, const OverscaledTileID&, uint32_t&) {
         return std::make_pair(0u, false);
     }
+    // Returns the id identifying this bucket instance during placement; `0` for
+    // buckets that aren't placed.
+    virtual uint32_t getBucketInstanceId() const { return 0; }
     // Places this bucket to the given placement.
     virtual void place(Placement&, const BucketPlacementParameters&, std::set<uint32_t>&) {}
     virtual void updateVertices(
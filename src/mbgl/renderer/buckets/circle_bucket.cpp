@@ -41,6 +41,11 @@ bool CircleBucket::hasData() const {
     return !segments.empty();
 }
 
+std::size_t CircleBucket::getMemoryUsage() const {
+    return vertices.bytes() + triangles.bytes() + (vertexBuffer ? vertexBuffer->bytes() : 0) +
+           (indexBuffer ? indexBuffer->bytes() : 0);
+}
+
 void CircleBucket::addFeature(const GeometryTileFeature& feature, const GeometryCollection& geometry,
                               const ImagePositions&, const PatternLayerMap&, std::size_t featureIndex) {
     constexpr const uint16_t vertexLength = 4;
@@ -90,7 +95,13 @@ void CircleBucket::addFeature(const GeometryTileFeature& feature, const Geometry
     }
 
     for (auto& pair : paintPropertyBinders) {
-        pair.second.populateVertexVectors(feature, vertices.elements(), featureIndex, {}, {});
+        pair.second.queueVertexVectors(feature, vertices.elements(), featureIndex, {}, {});
+    }
+}
+
+void CircleBucket::finishFeatures() {
+    for (auto& pair : paintPropertyBinders) {
+        pair.second.populateQueuedVertexVectors();
     }
 }
 
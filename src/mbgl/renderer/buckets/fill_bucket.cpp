@@ -113,13 +113,19 @@ void FillBucket::addFeature(const GeometryTileFeature& feature, const GeometryCo
     for (auto& pair : paintPropertyBinders) {
         const auto it = patternDependencies.find(pair.first);
         if (it != patternDependencies.end()){
-            pair.second.populateVertexVectors(feature, vertices.elements(), index, patternPositions, it->second);
+            pair.second.queueVertexVectors(feature, vertices.elements(), index, patternPositions, it->second);
         } else {
-            pair.second.populateVertexVectors(feature, vertices.elements(), index, patternPositions, {});
+            pair.second.queueVertexVectors(feature, vertices.elements(), index, patternPositions, {});
         }
     }
 }
 
+void FillBucket::finishFeatures() {
+    for (auto& pair : paintPropertyBinders) {
+        pair.second.populateQueuedVertexVectors();
+    }
+}
+
 void FillBucket::upload(gfx::UploadPass& uploadPass) {
     if (!uploaded) {
         vertexBuffer = uploadPass.createVertexBuffer(std::move(vertices));
@@ -139,6 +145,11 @@ bool FillBucket::hasData() const {
     return !triangleSegments.empty() || !lineSegments.empty();
 }
 
+std::size_t FillBucket::getMemoryUsage() const {
+    return vertices.bytes() + lines.bytes() + triangles.bytes() + (vertexBuffer ? vertexBuffer->bytes() : 0) +
+           (lineIndexBuffer ? lineIndexBuffer->bytes() : 0) + (triangleIndexBuffer ? triangleIndexBuffer->bytes() : 0);
+}
+
 float FillBucket::getQueryRadius(const RenderLayer& layer) const {
     const auto& evaluated = getEvaluated<FillLayerProperties>(layer.evaluatedProperties);
     const std::array<float, 2>& translate = evaluated.get<FillTranslate>();
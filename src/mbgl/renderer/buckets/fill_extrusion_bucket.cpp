@@ -157,13 +157,19 @@ void FillExtrusionBucket::addFeature(const GeometryTileFeature& feature, const G
     for (auto& pair : paintPropertyBinders) {
         const auto it = patternDependencies.find(pair.first);
         if (it != patternDependencies.end()){
-            pair.second.populateVertexVectors(feature, vertices.elements(), index, patternPositions, it->second);
+            pair.second.queueVertexVectors(feature, vertices.elements(), index, patternPositions, it->second);
         } else {
-            pair.second.populateVertexVectors(feature, vertices.elements(), index, patternPositions, {});
+            pair.second.queueVertexVectors(feature, vertices.elements(), index, patternPositions, {});
         }
     }
 }
 
+void FillExtrusionBucket::finishFeatures() {
+    for (auto& pair : paintPropertyBinders) {
+        pair.second.populateQueuedVertexVectors();
+    }
+}
+
 void FillExtrusionBucket::upload(gfx::UploadPass& uploadPass) {
     if (!uploaded) {
         vertexBuffer = uploadPass.createVertexBuffer(std::move(vertices));
@@ -181,6 +187,11 @@ bool FillExtrusionBucket::hasData() const {
     return !triangleSegments.empty();
 }
 
+std::size_t FillExtrusionBucket::getMemoryUsage() const {
+    return vertices.bytes() + triangles.bytes() + (vertexBuffer ? vertexBuffer->bytes() : 0) +
+           (indexBuffer ? indexBuffer->bytes() : 0);
+}
+
 float FillExtrusionBucket::getQueryRadius(const RenderLayer& layer) const {
     const auto& evaluated = getEvaluated<FillExtrusionLayerProperties>(layer.evaluatedProperties);
     const std::array<float, 2>& translate = evaluated.get<FillExtrusionTranslate>();
@@ -26,8 +26,10 @@ public:
 
     void addFeature(const GeometryTileFeature&, const GeometryCollection&, const mbgl::ImagePositions&,
                     const PatternLayerMap&, std::size_t) override;
+    void finishFeatures() override;
 
     bool hasData() const override;
+    std::size_t getMemoryUsage() const override;
 
     void upload(gfx::UploadPass&) override;
 
@@ -39,6 +39,11 @@ bool HeatmapBucket::hasData() const {
     return !segments.empty();
 }
 
+std::size_t HeatmapBucket::getMemoryUsage() const {
+    return vertices.bytes() + triangles.bytes() + (vertexBuffer ? vertexBuffer->bytes() : 0) +
+           (indexBuffer ? indexBuffer->bytes() : 0);
+}
+
 void HeatmapBucket::addFeature(const GeometryTileFeature& feature, const GeometryCollection& geometry,
                                const ImagePositions&, const PatternLayerMap&, std::size_t featureIndex) {
     constexpr const uint16_t vertexLength = 4;
@@ -87,7 +92,13 @@ void HeatmapBucket::addFeature(const GeometryTileFeature& feature, const Geometr
     }
 
     for (auto& pair : paintPropertyBinders) {
-        pair.second.populateVertexVectors(feature, vertices.elements(), featureIndex, {}, {});
+        pair.second.queueVertexVectors(feature, vertices.elements(), featureIndex, {}, {});
+    }
+}
+
+void HeatmapBucket::finishFeatures() {
+    for (auto& pair : paintPropertyBinders) {
+        pair.second.populateQueuedVertexVectors();
     }
 }
 
@@ -20,7 +20,9 @@ public:
 
     void addFeature(const GeometryTileFeature&, const GeometryCollection&, const ImagePositions&,
                     const PatternLayerMap&, std::size_t) override;
+    void finishFeatures() override;
     bool hasData() const override;
+    std::size_t getMemoryUsage() const override;
 
     void upload(gfx::UploadPass&) override;
 
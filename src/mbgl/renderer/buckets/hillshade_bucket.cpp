@@ -114,5 +114,11 @@ bool HillshadeBucket::hasData() const {
     return demdata.getImage()->valid();
 }
 
+std::size_t HillshadeBucket::getMemoryUsage() const {
+    return demdata.getImage()->bytes() + vertices.bytes() + indices.bytes() +
+           (vertexBuffer ? vertexBuffer->bytes() : 0) + (indexBuffer ? indexBuffer->bytes() : 0) +
+           (dem ? dem->size.area() * 4 : 0) + (texture ? texture->size.area() * 4 : 0);
+}
+
 
 } // namespace mbgl
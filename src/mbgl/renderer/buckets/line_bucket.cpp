@@ -37,13 +37,19 @@ void LineBucket::addFeature(const GeometryTileFeature& feature, const GeometryCo
     for (auto& pair : paintPropertyBinders) {
         const auto it = patternDependencies.find(pair.first);
         if (it != patternDependencies.end()){
-            pair.second.populateVertexVectors(feature, vertices.elements(), index, patternPositions, it->second);
+            pair.second.queueVertexVectors(feature, vertices.elements(), index, patternPositions, it->second);
         } else {
-            pair.second.populateVertexVectors(feature, vertices.elements(), index, patternPositions, {});
+            pair.second.queueVertexVectors(feature, vertices.elements(), index, patternPositions, {});
         }
     }
 }
 
+void LineBucket::finishFeatures() {
+    for (auto& pair : paintPropertyBinders) {
+        pair.second.populateQueuedVertexVectors();
+    }
+}
+
 /*
  * Sharp corners cause dashed lines to tilt because the distance along the line
  * is the same at both the inner and outer corners. To improve the appearance of
@@ -528,6 +534,11 @@ bool LineBucket::hasData() const {
     return !segments.empty();
 }
 
+std::size_t LineBucket::getMemoryUsage() const {
+    return vertices.bytes() + triangles.bytes() + (vertexBuffer ? vertexBuffer->bytes() : 0) +
+           (indexBuffer ? indexBuffer->bytes() : 0);
+}
+
 template <class Property>
 static float get(const LinePaintProperties::PossiblyEvaluated& evaluated, const std::string& id, const std::map<std::string, LineProgram::Binders>& paintPropertyBinders) {
     auto it = paintPropertyBinders.find(id);
@@ -172,6 +172,34 @@ bool SymbolBucket::hasData() const {
            hasTextCollisionBoxData() || hasIconCollisionCircleData() || hasTextCollisionCircleData();
 }
 
+namespace {
+
+template <class BufferType>
+std::size_t getBufferMemoryUsage(const BufferType& buffer) {
+    return buffer.vertices.bytes() + buffer.dynamicVertices.bytes() +
+           (buffer.vertexBuffer ? buffer.vertexBuffer->bytes() : 0) +
+           (buffer.dynamicVertexBuffer ? buffer.dynamicVertexBuffer->bytes() : 0) +
+           (buffer.indexBuffer ? buffer.indexBuffer->bytes() : 0);
+}
+
+} // namespace
+
+std::size_t SymbolBucket::getMemoryUsage() const {
+    std::size_t bytes = symbolInstances.size() * sizeof(SymbolInstance);
+    for (const Buffer* buffer : {&text, &icon, &sdfIcon}) {
+        bytes += getBufferMemoryUsage(*buffer) + buffer->opacityVertices.bytes() + buffer->triangles.bytes() +
+                 (buffer->opacityVertexBuffer ? buffer->opacityVertexBuffer->bytes() : 0) +
+                 buffer->placedSymbols.size() * sizeof(PlacedSymbol);
+    }
+    for (const CollisionBoxBuffer* buffer : {iconCollisionBox.get(), textCollisionBox.get()}) {
+        if (buffer) bytes += getBufferMemoryUsage(*buffer) + buffer->lines.bytes();
+    }
+    for (const CollisionCircleBuffer* buffer : {iconCollisionCircle.get(), textCollisionCircle.get()}) {
+        if (buffer) bytes += getBufferMemoryUsage(*buffer) + buffer->triangles.bytes();
+    }
+    return bytes;
+}
+
 bool SymbolBucket::hasTextData() const {
     return !text.segments.empty();
 }
@@ -81,7 +81,9 @@ public:
 
     void upload(gfx::UploadPass&) override;
     bool hasData() const override;
+    std::size_t getMemoryUsage() const override;
     std::pair<uint32_t, bool> registerAtCrossTileIndex(CrossTileSymbolLayerIndex&, const OverscaledTileID&, uint32_t& maxCrossTileID) override;
+    uint32_t getBucketInstanceId() const override { return bucketInstanceId; }
     void place(Placement&, const BucketPlacementParameters&, std::set<uint32_t>&) override;
     void updateVertices(
         const Placement&, bool updateOpacities, const TransformState&, const RenderTile&, std::set<uint32_t>&) override;
@@ -111,8 +113,9 @@ public:
     bool dynamicUploaded : 1;
     bool sortUploaded : 1;
     bool iconsInText : 1;
-    // Set and used by placement.
-    mutable bool justReloaded : 1;
+    // Set and used by placement. Not a bit field, as placement may run on a
+    // worker while the other flags are written on the render thread.
+    mutable bool justReloaded;
     bool hasVariablePlacement : 1;
 
     std::vector<SymbolInstance> symbolInstances;
@@ -1,7 +1,9 @@
 #include <mbgl/renderer/image_atlas.hpp>
 #include <mbgl/renderer/image_manager.hpp>
 
-#include <mapbox/shelf-pack.hpp>
+#include <algorithm>
+#include <cassert>
+#include <tuple>
 
 namespace mbgl {
 
@@ -18,39 +20,6 @@ ImagePosition::ImagePosition(const mapbox::Bin& bin, const style::Image::Impl& i
       version(version_) {
 }
 
-const mapbox::Bin& _packImage(mapbox::ShelfPack& pack, const style::Image::Impl& image, ImageAtlas& resultImage, ImageType imageType) {
-    const mapbox::Bin& bin = *pack.packOne(-1,
-        image.image.size.width + 2 * padding,
-        image.image.size.height + 2 * padding);
-
-    resultImage.image.resize({
-        static_cast<uint32_t>(pack.width()),
-        static_cast<uint32_t>(pack.height())
-    });
-
-    PremultipliedImage::copy(image.image,
-                             resultImage.image,
-                             { 0, 0 },
-                             {
-                                bin.x + padding,
-                                bin.y + padding
-                             },
-                             image.image.size);
-    uint32_t x = bin.x + padding,
-            y = bin.y + padding,
-            w = image.image.size.width,
-            h = image.image.size.height;
-
-    if (imageType == ImageType::Pattern) {
-            // Add 1 pixel wrapped padding on each side of the image.
-        PremultipliedImage::copy(image.image, resultImage.image, { 0, h - 1 }, { x, y - 1 }, { w, 1 }); // T
-        PremultipliedImage::copy(image.image, resultImage.image, { 0,     0 }, { x, y + h }, { w, 1 }); // B
-        PremultipliedImage::copy(image.image, resultImage.image, { w - 1, 0 }, { x - 1, y }, { 1, h }); // L
-        PremultipliedImage::copy(image.image, resultImage.image, { 0,     0 }, { x + w, y }, { 1, h }); // R
-    }
-    return bin;
-}
-
 namespace {
 
 void populateImagePatches(
@@ -68,7 +37,7 @@ void populateImagePatches(
             auto updatedImage = imageManager.getSharedImage(name);
             if (updatedImage == nullptr) continue;
 
-            patches.emplace_back(*updatedImage, position.textureRect);
+            patches.emplace_back(*updatedImage, position.textureRect, version);
             position.version = version;
         }
     }
@@ -83,36 +52,188 @@ std::vector<ImagePatch> ImageAtlas::getImagePatchesAndUpdateVersions(const Image
     return imagePatches;
 }
 
-ImageAtlas makeImageAtlas(const ImageMap& icons, const ImageMap& patterns, const std::unordered_map<std::string, uint32_t>& versionMap) {
-    ImageAtlas result;
+namespace {
+
+void copyImage(const style::Image::Impl& source, ImageType type, const mapbox::Bin& bin, PremultipliedImage& target) {
+    const uint32_t x = bin.x + padding,
+                   y = bin.y + padding,
+                   w = source.image.size.width,
+                   h = source.image.size.height;
+
+    PremultipliedImage::copy(source.image, target, { 0, 0 }, { x, y }, source.image.size);
 
+    if (type == ImageType::Pattern) {
+        // Add 1 pixel wrapped padding on each side of the image.
+        PremultipliedImage::copy(source.image, target, { 0, h - 1 }, { x, y - 1 }, { w, 1 }); // T
+        PremultipliedImage::copy(source.image, target, { 0,     0 }, { x, y + h }, { w, 1 }); // B
+        PremultipliedImage::copy(source.image, target, { w - 1, 0 }, { x - 1, y }, { 1, h }); // L
+        PremultipliedImage::copy(source.image, target, { 0,     0 }, { x + w, y }, { 1, h }); // R
+    }
+}
+
+// Copies the images of a tile that doesn't fit into the shared atlas into a
+// separate image, and points the positions at it.
+PremultipliedImage makeOwnImage(const ImageMap& icons, const ImageMap& patterns,
+                                const ImageVersionMap& versionMap, ImageAtlas& result) {
     mapbox::ShelfPack::ShelfPackOptions options;
     options.autoResize = true;
     mapbox::ShelfPack pack(0, 0, options);
 
+    std::vector<std::tuple<const style::Image::Impl*, ImageType, const mapbox::Bin*>> packedImages;
+    auto packImage = [&](const style::Image::Impl& image, ImageType type, ImagePositions& positions) {
+        const mapbox::Bin& bin = *pack.packOne(-1,
+            image.image.size.width + 2 * padding,
+            image.image.size.height + 2 * padding);
+        packedImages.emplace_back(&image, type, &bin);
+        auto versionIt = versionMap.find(image.id);
+        const uint32_t version = versionIt != versionMap.end() ? versionIt->second : 0;
+        positions.erase(image.id);
+        positions.emplace(image.id, ImagePosition { bin, image, version });
+    };
+
     for (const auto& entry : icons) {
-        const style::Image::Impl& image = *entry.second;
-        const mapbox::Bin& bin = _packImage(pack, image, result, ImageType::Icon);
-        auto it = versionMap.find(entry.first);
-        auto version = it != versionMap.end() ? it->second : 0;
-        result.iconPositions.emplace(image.id, ImagePosition { bin, image, version });
+        packImage(*entry.second, ImageType::Icon, result.iconPositions);
     }
-
     for (const auto& entry : patterns) {
-        const style::Image::Impl& image = *entry.second;
-        const mapbox::Bin& bin = _packImage(pack, image, result, ImageType::Pattern);
-        auto it = versionMap.find(entry.first);
-        auto version = it != versionMap.end() ? it->second : 0;
-        result.patternPositions.emplace(image.id, ImagePosition { bin, image, version });
+        packImage(*entry.second, ImageType::Pattern, result.patternPositions);
     }
 
     pack.shrink();
-    result.image.resize({
-        static_cast<uint32_t>(pack.width()),
-        static_cast<uint32_t>(pack.height())
-    });
+    PremultipliedImage image({ static_cast<uint32_t>(pack.width()), static_cast<uint32_t>(pack.height()) });
+    for (const auto& packedImage : packedImages) {
+        copyImage(*std::get<0>(packedImage), std::get<1>(packedImage), *std::get<2>(packedImage), image);
+    }
+    return image;
+}
+
+} // namespace
+
+SharedImageAtlas::SharedImageAtlas(Size maximumSize_)
+    : ShelfAtlas(maximumSize_) {
+}
+
+SharedImageAtlas::~SharedImageAtlas() = default;
+
+SharedImageAtlas::Entry* SharedImageAtlas::findEntry(const std::string& id, ImageType type, Size size) {
+    auto it = entries.find(id);
+    if (it == entries.end()) {
+        return nullptr;
+    }
+    for (Entry& entry : it->second) {
+        if (entry.type == type && entry.size == size) {
+            return &entry;
+        }
+    }
+    return nullptr;
+}
+
+ImageAtlas SharedImageAtlas::addImages(const ImageMap& icons, const ImageMap& patterns, const ImageVersionMap& versionMap) {
+    ImageAtlas result;
+    std::vector<int32_t> referencedBinIDs;
+    // Images whose pixels have to be written once the image has its final size.
+    std::vector<std::tuple<const style::Image::Impl*, ImageType, int32_t>> writes;
+    bool full = false;
+
+    std::unique_lock<std::mutex> lock(mutex);
+
+    auto addImage = [&](const style::Image::Impl& image, ImageType type, ImagePositions& positions) {
+        if (full) {
+            return;
+        }
+        auto versionIt = versionMap.find(image.id);
+        uint32_t version = versionIt != versionMap.end() ? versionIt->second : 0;
+
+        mapbox::Bin* bin = nullptr;
+        if (Entry* entry = findEntry(image.id, type, image.image.size)) {
+            bin = &ref(entry->binID);
+            if (version > entry->version) {
+                entry->version = version;
+                writes.emplace_back(&image, type, entry->binID);
+            }
+            version = entry->version;
+        } else {
+            bin = add(image.image.size.width + 2 * padding, image.image.size.height + 2 * padding);
+            if (!bin) {
+                full = true;
+                return;
+            }
+            entries[image.id].push_back(Entry { bin->id, type, image.image.size, version });
+            idsByBinID.emplace(bin->id, image.id);
+            writes.emplace_back(&image, type, bin->id);
+        }
+
+        referencedBinIDs.push_back(bin->id);
+        positions.emplace(image.id, ImagePosition { *bin, image, version });
+    };
+
+    for (const auto& entry : icons) {
+        addImage(*entry.second, ImageType::Icon, result.iconPositions);
+    }
+    for (const auto& entry : patterns) {
+        addImage(*entry.second, ImageType::Pattern, result.patternPositions);
+    }
+
+    resizeImage();
+    for (const auto& write : writes) {
+        writeImage(*std::get<0>(write), std::get<1>(write), getBin(std::get<2>(write)));
+    }
 
+    if (full) {
+        // Newer versions of shared images written above are kept.
+        releaseLocked(referencedBinIDs);
+        lock.unlock();
+        result.reference = ImageAtlasReference(makeOwnImage(icons, patterns, versionMap, result));
+        return result;
+    }
+
+    result.reference = makeReference(std::move(referencedBinIDs));
     return result;
 }
 
+void SharedImageAtlas::updateImage(const style::Image::Impl& updated, uint32_t version) {
+    std::lock_guard<std::mutex> lock(mutex);
+
+    auto it = entries.find(updated.id);
+    if (it == entries.end()) {
+        return;
+    }
+    for (Entry& entry : it->second) {
+        if (entry.size == updated.image.size && entry.version < version) {
+            entry.version = version;
+            writeImage(updated, entry.type, getBin(entry.binID));
+        }
+    }
+}
+
+void SharedImageAtlas::removeImage(const std::string& id) {
+    std::lock_guard<std::mutex> lock(mutex);
+    entries.erase(id);
+}
+
+void SharedImageAtlas::writeImage(const style::Image::Impl& source, ImageType type, const mapbox::Bin& bin) {
+    clearBin(bin);
+    copyImage(source, type, bin, image);
+}
+
+void SharedImageAtlas::evict(int32_t binID) {
+    auto idIt = idsByBinID.find(binID);
+    assert(idIt != idsByBinID.end());
+    auto entriesIt = entries.find(idIt->second);
+    if (entriesIt != entries.end()) {
+        auto& imageEntries = entriesIt->second;
+        imageEntries.erase(std::remove_if(imageEntries.begin(), imageEntries.end(),
+                                          [&](const Entry& entry) { return entry.binID == binID; }),
+                           imageEntries.end());
+        if (imageEntries.empty()) {
+            entries.erase(entriesIt);
+        }
+    }
+    idsByBinID.erase(idIt);
+}
+
+std::size_t SharedImageAtlas::getImageCount() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return idsByBinID.size();
+}
+
 } // namespace mbgl
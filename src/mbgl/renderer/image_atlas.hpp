@@ -1,19 +1,15 @@
 #pragma once
 
+#include <mbgl/renderer/shelf_atlas.hpp>
 #include <mbgl/style/image_impl.hpp>
 #include <mbgl/util/rect.hpp>
 
-#include <mapbox/shelf-pack.hpp>
-
 #include <array>
+#include <unordered_map>
+#include <vector>
 
 namespace mbgl {
 
-namespace gfx {
-class UploadPass;
-class Texture;
-} // namespace gfx
-
 class ImageManager;
 
 class ImagePosition {
@@ -65,22 +61,70 @@ using ImagePositions = std::map<std::string, ImagePosition>;
 class ImagePatch {
 public:
     ImagePatch(Immutable<style::Image::Impl> image_,
-               const Rect<uint16_t>& textureRect_)
+               const Rect<uint16_t>& textureRect_,
+               uint32_t version_)
         : image(std::move(image_))
-        , textureRect(textureRect_) {}
+        , textureRect(textureRect_)
+        , version(version_) {}
     Immutable<style::Image::Impl> image;
     Rect<uint16_t> textureRect;
+    uint32_t version;
 };
 
+// Keeps the images of a tile in the shared atlas.
+using ImageAtlasReference = ShelfAtlasReference<PremultipliedImage>;
+
+// The positions of a tile's icons and patterns in the shared atlas.
 class ImageAtlas {
 public:
-    PremultipliedImage image;
     ImagePositions iconPositions;
     ImagePositions patternPositions;
+    ImageAtlasReference reference;
 
     std::vector<ImagePatch> getImagePatchesAndUpdateVersions(const ImageManager&);
 };
 
-ImageAtlas makeImageAtlas(const ImageMap&, const ImageMap&, const std::unordered_map<std::string, uint32_t>& versionMap);
+// Icons and patterns of the style, packed into a single image that is shared by
+// the tiles instead of being copied into an atlas for each of them. Tile workers
+// add the images they use, which are counted per tile referencing them. Images
+// updated in place are patched at their existing position.
+class SharedImageAtlas : public ShelfAtlas<PremultipliedImage> {
+public:
+    explicit SharedImageAtlas(Size maximumSize = { 2048, 2048 });
+    ~SharedImageAtlas() override;
+
+    // Adds the images that aren't in the atlas yet, and returns the positions of
+    // all of them. If they don't all fit into the atlas, none of them is added,
+    // and they are packed into an image owned by the returned reference instead.
+    ImageAtlas addImages(const ImageMap& icons, const ImageMap& patterns, const ImageVersionMap&);
+
+    // Replaces the pixels of an image with a newer version of the same size.
+    void updateImage(const style::Image::Impl&, uint32_t version);
+
+    // Stops sharing the packed copies of an image that was removed or resized,
+    // whose version numbers start over. Tiles referencing them keep them until
+    // they are laid out again.
+    void removeImage(const std::string& id);
+
+    std::size_t getImageCount() const;
+
+private:
+    void evict(int32_t binID) override;
+
+    struct Entry {
+        int32_t binID;
+        ImageType type;
+        Size size;
+        uint32_t version;
+    };
+
+    Entry* findEntry(const std::string& id, ImageType, Size);
+    void writeImage(const style::Image::Impl&, ImageType, const mapbox::Bin&);
+
+    // An image may be packed once as an icon and once as a pattern, and once
+    // more for each size it had while tiles were using it.
+    std::unordered_map<std::string, std::vector<Entry>> entries;
+    std::unordered_map<int32_t, std::string> idsByBinID;
+};
 
 } // namespace mbgl
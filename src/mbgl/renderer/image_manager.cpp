@@ -10,7 +10,9 @@ namespace mbgl {
 
 static ImageManagerObserver nullObserver;
 
-ImageManager::ImageManager() = default;
+ImageManager::ImageManager()
+    : atlas(std::make_shared<SharedImageAtlas>()) {
+}
 
 ImageManager::~ImageManager() = default;
 
@@ -62,6 +64,7 @@ bool ImageManager::updateImage(Immutable<style::Image::Impl> image_) {
             requestedImagesCacheSize += diff;
         }
         updatedImageVersions.erase(image_->id);
+        atlas->removeImage(image_->id);
     } else {
         updatedImageVersions[image_->id]++;
     }
@@ -84,6 +87,7 @@ void ImageManager::removeImage(const std::string& id) {
     images.erase(it);
     availableImages.erase(id);
     updatedImageVersions.erase(id);
+    atlas->removeImage(id);
 }
 
 const style::Image::Impl* ImageManager::getImage(const std::string& id) const {
@@ -258,8 +262,20 @@ void ImageManager::notify(ImageRequestor& requestor, const ImageRequestPair& pai
     requestor.onImagesAvailable(std::move(iconMap), std::move(patternMap), std::move(versionMap), pair.second);
 }
 
+void ImageManager::uploadAtlas(gfx::UploadPass& uploadPass) {
+    atlas->upload(uploadPass, atlasTexture);
+}
+
+const gfx::Texture& ImageManager::getAtlasTexture() const {
+    assert(atlasTexture);
+    return *atlasTexture;
+}
+
 void ImageManager::dumpDebugLogs() const {
     Log::Info(Event::General, "ImageManager::loaded: %d", loaded);
+    const Size size = atlas->getSize();
+    Log::Info(Event::General, "ImageManager::atlas: %ux%u, %zu images, %zu bytes",
+              size.width, size.height, atlas->getImageCount(), atlas->getMemoryUsage());
 }
 
 ImageRequestor::ImageRequestor(ImageManager& imageManager_) : imageManager(imageManager_) {
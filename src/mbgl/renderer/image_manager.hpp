@@ -1,9 +1,11 @@
 #pragma once
 
+#include <mbgl/renderer/image_atlas.hpp>
 #include <mbgl/style/image_impl.hpp>
 #include <mbgl/util/immutable.hpp>
 
 #include <map>
+#include <memory>
 #include <string>
 
 namespace mbgl {
@@ -49,6 +51,12 @@ public:
     void reduceMemoryUseIfCacheSizeExceedsLimit();
     const std::set<std::string>& getAvailableImages() const;
 
+    // The atlas shared by all tiles. Workers add the images they use to it, and
+    // the texture is updated on the render thread.
+    const std::shared_ptr<SharedImageAtlas>& getAtlas() const { return atlas; }
+    void uploadAtlas(gfx::UploadPass&);
+    const gfx::Texture& getAtlasTexture() const;
+
     ImageVersionMap updatedImageVersions;
 
 private:
@@ -67,6 +75,11 @@ private:
     std::set<std::string> availableImages;
 
     ImageManagerObserver* observer = nullptr;
+
+    std::shared_ptr<SharedImageAtlas> atlas;
+    // Owned here rather than by the atlas, which may be kept alive by workers
+    // and must not release GPU resources off the render thread.
+    optional<gfx::Texture> atlasTexture;
 };
 
 class ImageRequestor {
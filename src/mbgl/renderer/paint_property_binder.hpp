@@ -15,6 +15,7 @@
 #include <mbgl/util/indexed_tuple.hpp>
 #include <mbgl/layout/pattern_layout.hpp>
 
+#include <algorithm>
 #include <bitset>
 
 namespace mbgl {
@@ -28,6 +29,29 @@ struct FeatureVertexRange {
 
 using FeatureVertexRangeMap = std::map<std::string, std::vector<FeatureVertexRange>>;
 
+// Features whose paint property values are evaluated together, along with the
+// vertex ranges the values are written to. The ranges are contiguous.
+class QueuedFeatures {
+public:
+    void push(const GeometryTileFeature& feature, std::size_t index, std::size_t start, std::size_t length) {
+        if (!ranges.empty()) {
+            start = ranges.back().end;
+        }
+        features.push_back(&feature);
+        ranges.push_back({ index, start, std::max(start, length) });
+    }
+
+    bool empty() const { return features.empty(); }
+
+    void clear() {
+        features.clear();
+        ranges.clear();
+    }
+
+    std::vector<const GeometryTileFeature*> features;
+    std::vector<FeatureVertexRange> ranges;
+};
+
 /*
    ZoomInterpolatedAttribute<Attr> is a 'compound' attribute, representing two values of the
    the base attribute Attr.  These two values are provided to the shader to allow interpolation
@@ -109,6 +133,17 @@ public:
                                       const ImagePositions&, const optional<PatternDependency>&,
                                       const style::expression::Value&) = 0;
 
+    // Like populateVertexVector(), but binders evaluating expressions may defer the
+    // evaluation until populateQueuedVertexVectors() is called, and then evaluate
+    // all queued features in one batch. The feature must stay alive until then.
+    virtual void queueVertexVector(const GeometryTileFeature& feature, std::size_t length, std::size_t index,
+                                   const ImagePositions& patternPositions,
+                                   const optional<PatternDependency>& patternDependencies) {
+        populateVertexVector(feature, length, index, patternPositions, patternDependencies, {});
+    }
+
+    virtual void populateQueuedVertexVectors() {}
+
     virtual void updateVertexVectors(const FeatureStates&, const GeometryTileLayer&, const ImagePositions&) {}
 
     virtual void updateVertexVector(std::size_t, std::size_t, const GeometryTileFeature&, const FeatureState&) = 0;
@@ -208,6 +243,7 @@ public:
                               const ImagePositions&, const optional<PatternDependency>&,
                               const style::expression::Value& formattedSection) override {
         using style::expression::EvaluationContext;
+        populateQueuedVertexVectors();
         auto evaluated = expression.evaluate(EvaluationContext(&feature).withFormattedSection(&formattedSection), defaultValue);
         this->statistics.add(evaluated);
         auto value = attributeValue(evaluated);
@@ -221,6 +257,31 @@ public:
         }
     }
 
+    void queueVertexVector(const GeometryTileFeature& feature, std::size_t length, std::size_t index,
+                           const ImagePositions&, const optional<PatternDependency>&) override {
+        queuedFeatures.push(feature, index, vertexVector.elements(), length);
+    }
+
+    void populateQueuedVertexVectors() override {
+        if (queuedFeatures.empty()) {
+            return;
+        }
+
+        expression.evaluate(nullopt, queuedFeatures.features, defaultValue, evaluatedValues);
+
+        vertexVector.reserve(queuedFeatures.ranges.back().end);
+        for (std::size_t i = 0; i < evaluatedValues.size(); ++i) {
+            const FeatureVertexRange& range = queuedFeatures.ranges[i];
+            this->statistics.add(evaluatedValues[i]);
+            vertexVector.extend(range.end - range.start, BaseVertex { attributeValue(evaluatedValues[i]) });
+            optional<std::string> idStr = featureIDtoString(queuedFeatures.features[i]->getID());
+            if (idStr) {
+                featureMap[*idStr].emplace_back(range);
+            }
+        }
+        queuedFeatures.clear();
+    }
+
     void updateVertexVectors(const FeatureStates& states, const GeometryTileLayer& layer,
                              const ImagePositions&) override {
         for (const auto& it : states) {
@@ -251,6 +312,7 @@ public:
     }
 
     void upload(gfx::UploadPass& uploadPass) override {
+        assert(queuedFeatures.empty());
         vertexBuffer = uploadPass.createVertexBuffer(std::move(vertexVector));
     }
 
@@ -283,6 +345,8 @@ private:
     gfx::VertexVector<BaseVertex> vertexVector;
     optional<gfx::VertexBuffer<BaseVertex>> vertexBuffer;
     FeatureVertexRangeMap featureMap;
+    QueuedFeatures queuedFeatures;
+    std::vector<T> evaluatedValues;
 };
 
 template <class T, class A>
@@ -303,6 +367,7 @@ public:
                               const ImagePositions&, const optional<PatternDependency>&,
                               const style::expression::Value& formattedSection) override {
         using style::expression::EvaluationContext;
+        populateQueuedVertexVectors();
         Range<T> range = {
                 expression.evaluate(EvaluationContext(zoomRange.min, &feature).withFormattedSection(&formattedSection), defaultValue),
                 expression.evaluate(EvaluationContext(zoomRange.max, &feature).withFormattedSection(&formattedSection), defaultValue),
@@ -322,6 +387,36 @@ public:
         }
     }
 
+    void queueVertexVector(const GeometryTileFeature& feature, std::size_t length, std::size_t index,
+                           const ImagePositions&, const optional<PatternDependency>&) override {
+        queuedFeatures.push(feature, index, vertexVector.elements(), length);
+    }
+
+    void populateQueuedVertexVectors() override {
+        if (queuedFeatures.empty()) {
+            return;
+        }
+
+        expression.evaluate(zoomRange.min, queuedFeatures.features, defaultValue, evaluatedMinValues);
+        expression.evaluate(zoomRange.max, queuedFeatures.features, defaultValue, evaluatedMaxValues);
+
+        vertexVector.reserve(queuedFeatures.ranges.back().end);
+        for (std::size_t i = 0; i < evaluatedMinValues.size(); ++i) {
+            const FeatureVertexRange& range = queuedFeatures.ranges[i];
+            this->statistics.add(evaluatedMinValues[i]);
+            this->statistics.add(evaluatedMaxValues[i]);
+            AttributeValue value = zoomInterpolatedAttributeValue(
+                attributeValue(evaluatedMinValues[i]),
+                attributeValue(evaluatedMaxValues[i]));
+            vertexVector.extend(range.end - range.start, Vertex { value });
+            optional<std::string> idStr = featureIDtoString(queuedFeatures.features[i]->getID());
+            if (idStr) {
+                featureMap[*idStr].emplace_back(range);
+            }
+        }
+        queuedFeatures.clear();
+    }
+
     void updateVertexVectors(const FeatureStates& states, const GeometryTileLayer& layer,
                              const ImagePositions&) override {
         for (const auto& it : states) {
@@ -356,6 +451,7 @@ public:
     }
 
     void upload(gfx::UploadPass& uploadPass) override {
+        assert(queuedFeatures.empty());
         vertexBuffer = uploadPass.createVertexBuffer(std::move(vertexVector));
     }
 
@@ -392,6 +488,9 @@ private:
     gfx::VertexVector<Vertex> vertexVector;
     optional<gfx::VertexBuffer<Vertex>> vertexBuffer;
     FeatureVertexRangeMap featureMap;
+    QueuedFeatures queuedFeatures;
+    std::vector<T> evaluatedMinValues;
+    std::vector<T> evaluatedMaxValues;
 };
 
 template <class T, class A1, class A2>
@@ -598,6 +697,19 @@ public:
                        0)...});
     }
 
+    // See PaintPropertyBinder::queueVertexVector().
+    void queueVertexVectors(const GeometryTileFeature& feature, std::size_t length, std::size_t index,
+                            const ImagePositions& patternPositions,
+                            const optional<PatternDependency>& patternDependencies) {
+        util::ignore({(binders.template get<Ps>()->queueVertexVector(feature, length, index, patternPositions,
+                                                                     patternDependencies),
+                       0)...});
+    }
+
+    void populateQueuedVertexVectors() {
+        util::ignore({(binders.template get<Ps>()->populateQueuedVertexVectors(), 0)...});
+    }
+
     void updateVertexVectors(const FeatureStates& states, const GeometryTileLayer& layer,
                              const ImagePositions& imagePositions) {
         util::ignore({(binders.template get<Ps>()->updateVertexVectors(states, layer, imagePositions), 0)...});
@@ -135,6 +135,25 @@ void RenderOrchestrator::setObserver(RendererObserver* observer_) {
     observer = observer_ ? observer_ : &nullObserver();
 }
 
+void RenderOrchestrator::setSymbolPlacementTimeBudget(optional<Duration> budget) {
+    placementTimeBudget = std::move(budget);
+}
+
+void RenderOrchestrator::setBackgroundSymbolPlacement(bool enabled) {
+    backgroundPlacementEnabled = enabled;
+}
+
+void RenderOrchestrator::commitPlacement(Mutable<Placement> placement,
+                                         const std::set<std::string>& usedSymbolLayers,
+                                         const UpdateParameters& updateParameters) {
+    placement->commit(updateParameters.timePoint, updateParameters.transformState.getZoom());
+    crossTileSymbolIndex.pruneUnusedLayers(usedSymbolLayers);
+    for (const auto& entry : renderSources) {
+        entry.second->updateFadingTiles();
+    }
+    placementController.setPlacement(std::move(placement));
+}
+
 std::unique_ptr<RenderTree> RenderOrchestrator::createRenderTree(const UpdateParameters& updateParameters) {
     const bool isMapModeContinuous = updateParameters.mode == MapMode::Continuous;
     if (!isMapModeContinuous) {
@@ -170,7 +189,9 @@ std::unique_ptr<RenderTree> RenderOrchestrator::createRenderTree(const UpdatePar
         updateParameters.annotationManager,
         *imageManager,
         *glyphManager,
-        updateParameters.prefetchZoomDelta
+        updateParameters.prefetchZoomDelta,
+        updateParameters.parallelTileParsing,
+        updateParameters.tileCacheMemoryLimit
     };
 
     glyphManager->setURL(updateParameters.glyphURL);
@@ -378,11 +399,27 @@ std::unique_ptr<RenderTree> RenderOrchestrator::createRenderTree(const UpdatePar
     // Symbol placement.
     bool symbolBucketsChanged = false;
     if (isMapModeContinuous) {
+        renderTreeParameters->placementChanged = false;
+        // A placement computed in the background is committed in the first frame after it's done.
+        if (backgroundPlacement && backgroundPlacement->isDone()) {
+            std::set<std::string> usedSymbolLayers;
+            for (const auto& layer : backgroundPlacement->getLayers()) {
+                usedSymbolLayers.insert(layer.layerID);
+            }
+            commitPlacement(backgroundPlacement->finish(), usedSymbolLayers, updateParameters);
+            backgroundPlacement.reset();
+            renderTreeParameters->placementChanged = true;
+        }
+
         bool symbolBucketsAdded = false;
-        for (auto it = layersNeedPlacement.crbegin(); it != layersNeedPlacement.crend(); ++it) {
-            auto result = crossTileSymbolIndex.addLayer(*it, updateParameters.transformState.getLatLng().longitude());
-            symbolBucketsAdded = symbolBucketsAdded || (result & CrossTileSymbolIndex::AddLayerResult::BucketsAdded);
-            symbolBucketsChanged = symbolBucketsChanged || (result != CrossTileSymbolIndex::AddLayerResult::NoChanges);
+        // The cross tile symbol index writes the cross tile IDs of the symbols, so it isn't
+        // updated while a background placement reads them.
+        if (!backgroundPlacement) {
+            for (auto it = layersNeedPlacement.crbegin(); it != layersNeedPlacement.crend(); ++it) {
+                auto result = crossTileSymbolIndex.addLayer(*it, updateParameters.transformState.getLatLng().longitude());
+                symbolBucketsAdded = symbolBucketsAdded || (result & CrossTileSymbolIndex::AddLayerResult::BucketsAdded);
+                symbolBucketsChanged = symbolBucketsChanged || (result != CrossTileSymbolIndex::AddLayerResult::NoChanges);
+            }
         }
         // We want new symbols to show up faster, however simple setting `placementChanged` to `true` would
         // initiate placement too often as new buckets ususally come from several rendered tiles in a row within
@@ -390,37 +427,64 @@ std::unique_ptr<RenderTree> RenderOrchestrator::createRenderTree(const UpdatePar
         // tiles.
         optional<Duration> maximumPlacementUpdatePeriod;
         if (symbolBucketsAdded) maximumPlacementUpdatePeriod = optional<Duration>(Milliseconds(30));
-        renderTreeParameters->placementChanged = !placementController.placementIsRecent(
+        const bool placementIsRecent = placementController.placementIsRecent(
             updateParameters.timePoint, updateParameters.transformState.getZoom(), maximumPlacementUpdatePeriod);
-        symbolBucketsChanged |= renderTreeParameters->placementChanged;
 
-        std::set<std::string> usedSymbolLayers;
-        if (renderTreeParameters->placementChanged) {
+        // A placement that ran out of time in a previous frame, or that is computed in the background,
+        // is finished before a new one is started.
+        if (!pauseablePlacement && !backgroundPlacement && !placementIsRecent) {
             Mutable<Placement> placement = makeMutable<Placement>(updateParameters.transformState,
                                                                   updateParameters.mode,
                                                                   updateParameters.transitionOptions,
                                                                   updateParameters.crossSourceCollisions,
                                                                   placementController.getPlacement());
-
-            for (auto it = layersNeedPlacement.crbegin(); it != layersNeedPlacement.crend(); ++it) {
-                const RenderLayer& layer = *it;
-                usedSymbolLayers.insert(layer.getID());
-                placement->placeLayer(layer, renderTreeParameters->transformParams.projMatrix, updateParameters.debugOptions & MapDebugOptions::Collision);
+            const bool showCollisionBoxes = updateParameters.debugOptions & MapDebugOptions::Collision;
+            if (backgroundPlacementEnabled) {
+                std::vector<LayerPlacementSnapshot> layers;
+                layers.reserve(layersNeedPlacement.size());
+                for (auto it = layersNeedPlacement.crbegin(); it != layersNeedPlacement.crend(); ++it) {
+                    layers.emplace_back(*it);
+                }
+                backgroundPlacement = std::make_unique<BackgroundPlacement>(
+                    std::move(placement), std::move(layers), renderTreeParameters->transformParams.projMatrix,
+                    showCollisionBoxes);
+            } else {
+                pauseablePlacement = std::make_unique<PauseablePlacement>(
+                    std::move(placement), renderTreeParameters->transformParams.projMatrix, showCollisionBoxes);
             }
+        }
 
-            placement->commit(updateParameters.timePoint, updateParameters.transformState.getZoom());
-            crossTileSymbolIndex.pruneUnusedLayers(usedSymbolLayers);
-            for (const auto& entry : renderSources) {
-                entry.second->updateFadingTiles();
+        if (pauseablePlacement) {
+            std::vector<std::reference_wrapper<const RenderLayer>> layers(layersNeedPlacement.crbegin(),
+                                                                          layersNeedPlacement.crend());
+            const TimePoint deadline = placementTimeBudget ? Clock::now() + *placementTimeBudget : TimePoint::max();
+            const bool placementDone = pauseablePlacement->continuePlacement(layers, [&] {
+                return placementTimeBudget && Clock::now() >= deadline;
+            });
+
+            if (placementDone) {
+                std::set<std::string> usedSymbolLayers;
+                for (const RenderLayer& layer : layers) {
+                    usedSymbolLayers.insert(layer.getID());
+                }
+                commitPlacement(pauseablePlacement->finish(), usedSymbolLayers, updateParameters);
+                pauseablePlacement.reset();
+                renderTreeParameters->placementChanged = true;
+            } else {
+                placementController.setPlacementStale();
+                observer->onSymbolPlacementDeferred(pauseablePlacement->getRemainingBuckets());
             }
-            placementController.setPlacement(std::move(placement));
-        } else {
+        } else if (!renderTreeParameters->placementChanged) {
             placementController.setPlacementStale();
         }
+        symbolBucketsChanged |= renderTreeParameters->placementChanged;
         renderTreeParameters->symbolFadeChange =
             placementController.getPlacement()->symbolFadeChange(updateParameters.timePoint);
-        renderTreeParameters->needsRepaint = hasTransitions(updateParameters.timePoint);
+        renderTreeParameters->needsRepaint =
+            pauseablePlacement || backgroundPlacement || hasTransitions(updateParameters.timePoint);
     } else {
+        pauseablePlacement.reset();
+        backgroundPlacement.reset();
         crossTileSymbolIndex.reset();
         renderTreeParameters->placementChanged = symbolBucketsChanged = !layersNeedPlacement.empty();
         if (renderTreeParameters->placementChanged) {
@@ -641,6 +705,7 @@ void RenderOrchestrator::dumpDebugLogs() {
     }
 
     imageManager->dumpDebugLogs();
+    glyphManager->dumpDebugLogs();
 }
 
 RenderLayer* RenderOrchestrator::getRenderLayer(const std::string& id) {
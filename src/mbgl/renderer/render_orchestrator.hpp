@@ -14,6 +14,7 @@
 #include <mbgl/text/placement.hpp>
 
 #include <memory>
+#include <set>
 #include <string>
 #include <vector>
 
@@ -51,6 +52,8 @@ public:
     };
     // TODO: Introduce RenderOrchestratorObserver.
     void setObserver(RendererObserver*);
+    void setSymbolPlacementTimeBudget(optional<Duration>);
+    void setBackgroundSymbolPlacement(bool);
 
     std::unique_ptr<RenderTree> createRenderTree(const UpdateParameters&);
 
@@ -80,6 +83,8 @@ private:
     bool isLoaded() const;
     bool hasTransitions(TimePoint) const;
 
+    void commitPlacement(Mutable<Placement>, const std::set<std::string>& usedSymbolLayers, const UpdateParameters&);
+
     RenderSource* getRenderSource(const std::string& id) const;
 
           RenderLayer* getRenderLayer(const std::string& id);
@@ -123,6 +128,10 @@ private:
 
     CrossTileSymbolIndex crossTileSymbolIndex;
     PlacementController placementController;
+    std::unique_ptr<PauseablePlacement> pauseablePlacement;
+    optional<Duration> placementTimeBudget;
+    std::unique_ptr<BackgroundPlacement> backgroundPlacement;
+    bool backgroundPlacementEnabled = false;
 
     const bool backgroundLayerAsColor;
     bool contextLost = false;
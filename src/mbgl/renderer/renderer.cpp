@@ -120,6 +120,14 @@ void Renderer::removeFeatureState(const std::string& sourceID, const optional<st
     impl->orchestrator.removeFeatureState(sourceID, sourceLayerID, featureID, stateKey);
 }
 
+void Renderer::setSymbolPlacementTimeBudget(optional<Duration> budget) {
+    impl->orchestrator.setSymbolPlacementTimeBudget(std::move(budget));
+}
+
+void Renderer::setBackgroundSymbolPlacement(bool enabled) {
+    impl->orchestrator.setBackgroundSymbolPlacement(enabled);
+}
+
 void Renderer::dumpDebugLogs() {
     impl->orchestrator.dumpDebugLogs();
 }
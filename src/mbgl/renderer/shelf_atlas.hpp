@@ -0,0 +1,231 @@
+#pragma once
+
+#include <mbgl/gfx/texture.hpp>
+#include <mbgl/gfx/upload_pass.hpp>
+#include <mbgl/util/optional.hpp>
+#include <mbgl/util/rect.hpp>
+#include <mbgl/util/shelf_pack.hpp>
+
+#include <mapbox/shelf-pack.hpp>
+
+#include <cassert>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace mbgl {
+
+template <class Image>
+class ShelfAtlas;
+
+// Keeps the bins of a layout in a shared atlas. When the last reference to a
+// bin is released, its space is freed and may be reused by other layouts.
+template <class Image>
+class ShelfAtlasReference {
+public:
+    ShelfAtlasReference() = default;
+    ShelfAtlasReference(std::shared_ptr<ShelfAtlas<Image>> atlas_, std::vector<int32_t> binIDs_)
+        : atlas(std::move(atlas_)), binIDs(std::move(binIDs_)) {
+    }
+
+    // For a layout that didn't fit into the shared atlas, and was packed into an
+    // image of its own instead.
+    explicit ShelfAtlasReference(Image ownImage_)
+        : ownImage(std::move(ownImage_)), ownAtlas(true) {
+    }
+
+    ShelfAtlasReference(ShelfAtlasReference&& other) noexcept
+        : atlas(std::move(other.atlas)),
+          binIDs(std::move(other.binIDs)),
+          ownImage(std::move(other.ownImage)),
+          ownAtlas(other.ownAtlas) {
+        other.reset();
+    }
+
+    ShelfAtlasReference& operator=(ShelfAtlasReference&& other) noexcept {
+        if (this != &other) {
+            release();
+            atlas = std::move(other.atlas);
+            binIDs = std::move(other.binIDs);
+            ownImage = std::move(other.ownImage);
+            ownAtlas = other.ownAtlas;
+            other.reset();
+        }
+        return *this;
+    }
+
+    ~ShelfAtlasReference() {
+        release();
+    }
+
+    // Whether the positions refer to the layout's own image rather than to the
+    // shared atlas.
+    bool hasOwnImage() const { return ownAtlas; }
+
+    // Hands over the layout's own image to be uploaded. Returns nothing once it
+    // has been taken.
+    optional<Image> takeOwnImage() {
+        optional<Image> result = std::move(ownImage);
+        ownImage = nullopt;
+        return result;
+    }
+
+    std::size_t getMemoryUsage() const {
+        return ownImage ? ownImage->bytes() : 0;
+    }
+
+private:
+    void release() {
+        if (atlas) {
+            atlas->release(binIDs);
+        }
+        reset();
+    }
+
+    void reset() {
+        atlas.reset();
+        binIDs.clear();
+        ownImage = nullopt;
+        ownAtlas = false;
+    }
+
+    std::shared_ptr<ShelfAtlas<Image>> atlas;
+    std::vector<int32_t> binIDs;
+    optional<Image> ownImage;
+    bool ownAtlas = false;
+};
+
+// An image shared by the tiles, with its contents packed into reference counted
+// bins. Subclasses map their contents to bins, and hold `mutex` while adding or
+// writing bins. Written regions are copied to the texture on the render thread.
+// The image doesn't grow beyond `maximumSize`, so that it fits into a texture.
+template <class Image>
+class ShelfAtlas : public std::enable_shared_from_this<ShelfAtlas<Image>> {
+public:
+    explicit ShelfAtlas(Size maximumSize_)
+        : maximumSize(maximumSize_),
+          pack(0, 0, packOptions()) {
+    }
+
+    virtual ~ShelfAtlas() = default;
+
+    // Creates the texture, or patches it with the regions written since the last call.
+    void upload(gfx::UploadPass& uploadPass, optional<gfx::Texture>& texture) {
+        std::lock_guard<std::mutex> lock(mutex);
+
+        if (!texture) {
+            texture = uploadPass.createTexture(image);
+        } else if (resized) {
+            uploadPass.updateTexture(*texture, image);
+        } else {
+            for (const auto& rect : dirtyRects) {
+                Image patch({ rect.w, rect.h });
+                Image::copy(image, patch, { rect.x, rect.y }, { 0, 0 }, patch.size);
+                uploadPass.updateTextureSub(*texture, patch, rect.x, rect.y);
+            }
+        }
+
+        resized = false;
+        dirtyRects.clear();
+    }
+
+    Size getSize() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return image.size;
+    }
+
+    std::size_t getMemoryUsage() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return image.bytes();
+    }
+
+protected:
+    // Adds a reference to an existing bin.
+    mapbox::Bin& ref(int32_t binID) {
+        mapbox::Bin* bin = pack.getBin(binID);
+        assert(bin);
+        pack.ref(*bin);
+        return *bin;
+    }
+
+    // Packs a new bin, referenced once. Returns nullptr if the atlas is full.
+    mapbox::Bin* add(int32_t width, int32_t height) {
+        return util::packWithinSize(pack, nextBinID++, width, height, maximumSize);
+    }
+
+    const mapbox::Bin& getBin(int32_t binID) {
+        const mapbox::Bin* bin = pack.getBin(binID);
+        assert(bin);
+        return *bin;
+    }
+
+    // Grows the image to the size of the pack. Called once after adding bins,
+    // rather than after each of them.
+    void resizeImage() {
+        const Size packSize { static_cast<uint32_t>(pack.width()), static_cast<uint32_t>(pack.height()) };
+        if (image.size != packSize) {
+            image.resize(packSize);
+            resized = true;
+        }
+    }
+
+    // Clears a bin before its pixels are written to `image`, since a bin freed
+    // by an eviction still holds the old pixels, and marks it for upload.
+    void clearBin(const mapbox::Bin& bin) {
+        Image::clear(image,
+                     { static_cast<uint32_t>(bin.x), static_cast<uint32_t>(bin.y) },
+                     { static_cast<uint32_t>(bin.w), static_cast<uint32_t>(bin.h) });
+        dirtyRects.emplace_back(static_cast<uint16_t>(bin.x),
+                                static_cast<uint16_t>(bin.y),
+                                static_cast<uint16_t>(bin.w),
+                                static_cast<uint16_t>(bin.h));
+    }
+
+    ShelfAtlasReference<Image> makeReference(std::vector<int32_t> binIDs) {
+        return { this->shared_from_this(), std::move(binIDs) };
+    }
+
+    // Drops a reference to each of the bins. Also used to give back the bins
+    // taken by a layout that turned out not to fit.
+    void releaseLocked(const std::vector<int32_t>& binIDs) {
+        for (const int32_t binID : binIDs) {
+            mapbox::Bin* bin = pack.getBin(binID);
+            assert(bin);
+            if (bin && pack.unref(*bin) == 0) {
+                evict(binID);
+            }
+        }
+    }
+
+    // Called when nothing references a bin anymore, so that its contents are
+    // forgotten and the bin can be reused.
+    virtual void evict(int32_t binID) = 0;
+
+    mutable std::mutex mutex;
+    Image image;
+
+private:
+    friend class ShelfAtlasReference<Image>;
+
+    void release(const std::vector<int32_t>& binIDs) {
+        std::lock_guard<std::mutex> lock(mutex);
+        releaseLocked(binIDs);
+    }
+
+    static mapbox::ShelfPack::ShelfPackOptions packOptions() {
+        mapbox::ShelfPack::ShelfPackOptions options;
+        // The atlas is grown by util::packWithinSize() instead, up to its maximum size.
+        options.autoResize = false;
+        return options;
+    }
+
+    const Size maximumSize;
+    mapbox::ShelfPack pack;
+    int32_t nextBinID = 0;
+
+    // Regions of `image` that have to be copied to the texture.
+    std::vector<Rect<uint16_t>> dirtyRects;
+    bool resized = false;
+};
+
+} // namespace mbgl
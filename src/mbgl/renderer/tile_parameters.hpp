@@ -23,6 +23,8 @@ public:
     ImageManager& imageManager;
     GlyphManager& glyphManager;
     const uint8_t prefetchZoomDelta;
+    const bool parallelTileParsing;
+    const std::size_t tileCacheMemoryLimit;
 };
 
 } // namespace mbgl
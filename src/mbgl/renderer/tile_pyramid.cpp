@@ -5,6 +5,7 @@
 #include <mbgl/renderer/query.hpp>
 #include <mbgl/map/transform.hpp>
 #include <mbgl/math/clamp.hpp>
+#include <mbgl/util/tile_coordinate.hpp>
 #include <mbgl/util/tile_cover.hpp>
 #include <mbgl/util/tile_range.hpp>
 #include <mbgl/util/enum.hpp>
@@ -23,6 +24,21 @@ using namespace style;
 
 static TileObserver nullObserver;
 
+// Tiles at the ideal zoom level are processed first, ordered by their distance
+// (in tiles) from the center of the viewport. Tiles at other zoom levels, i.e.
+// parents and children standing in for ideal tiles and prefetched tiles, follow
+// level by level.
+static double tilePriority(const OverscaledTileID& tileID, const TileCoordinate& center, int32_t idealZoom) {
+    constexpr double zoomLevelStride = 1e6;
+
+    const TileCoordinate tileCenter = center.zoomTo(tileID.canonical.z);
+    const double dx = tileID.canonical.x + tileID.wrap * double(1u << tileID.canonical.z) + 0.5 - tileCenter.p.x;
+    const double dy = tileID.canonical.y + 0.5 - tileCenter.p.y;
+    const int32_t zoomDelta = std::abs(int32_t(tileID.overscaledZ) - idealZoom);
+
+    return zoomDelta * zoomLevelStride + std::sqrt(dx * dx + dy * dy);
+}
+
 TilePyramid::TilePyramid()
     : observer(&nullObserver) {
 }
@@ -198,6 +214,7 @@ void TilePyramid::update(const std::vector<Immutable<style::LayerProperties>>& l
             (parameters.transformState.getMaxZoom() - parameters.transformState.getMinZoom() + 1) *
             0.5;
         cache.setSize(conservativeCacheSize);
+        cache.setMaximumMemoryUsage(parameters.tileCacheMemoryLimit);
     }
 
     // Remove stale tiles. This goes through the (sorted!) tiles map and retain set in lockstep
@@ -221,8 +238,10 @@ void TilePyramid::update(const std::vector<Immutable<style::LayerProperties>>& l
         }
     }
 
+    const auto center = TileCoordinate::fromLatLng(0, parameters.transformState.getLatLng());
     for (auto& pair : tiles) {
         pair.second->setShowCollisionBoxes(parameters.debugOptions & MapDebugOptions::Collision);
+        pair.second->setPriority(tilePriority(pair.first, center, tileZoom));
     }
 
     // Initialize renderable tiles and update the contained layer render data.
@@ -366,6 +385,7 @@ void TilePyramid::dumpDebugLogs() const {
     for (const auto& pair : tiles) {
         pair.second->dumpDebugLogs();
     }
+    Log::Info(Event::General, "TilePyramid::cacheMemoryUsage: %zu bytes", cache.getMemoryUsage());
 }
 
 void TilePyramid::clearAll() {
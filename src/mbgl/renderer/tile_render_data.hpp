@@ -18,8 +18,13 @@ class SourcePrepareParameters;
 
 class TileAtlasTextures {
 public:    
-    optional<gfx::Texture> glyph;
-    optional<gfx::Texture> icon;
+    // The textures of the glyph and image atlases shared by all tiles, or of
+    // the tile's own atlases if its glyphs or images didn't fit into the shared ones.
+    const gfx::Texture* glyph = nullptr;
+    const gfx::Texture* icon = nullptr;
+
+    optional<gfx::Texture> ownGlyph;
+    optional<gfx::Texture> ownIcon;
 };
 
 class TileRenderData {
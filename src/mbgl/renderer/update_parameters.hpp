@@ -42,6 +42,10 @@ public:
     const bool stillImageRequest;
     
     const bool crossSourceCollisions;
+
+    const bool parallelTileParsing;
+
+    const std::size_t tileCacheMemoryLimit;
 };
 
 } // namespace mbgl
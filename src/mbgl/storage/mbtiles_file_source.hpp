@@ -0,0 +1,32 @@
+#pragma once
+
+#include <mbgl/storage/file_source.hpp>
+
+namespace mbgl {
+
+namespace util {
+template <typename T> class Thread;
+} // namespace util
+
+// Serves tiles straight from local tile packs, without importing them into the
+// offline database first. A URL of the form mbtiles:///path/to/tiles.mbtiles
+// refers to an MBTiles file: tiles are looked up by their coordinates, and any
+// other request returns a TileJSON document describing the tile set. A tile URL
+// template that contains tokens, like mbtiles:///path/to/tiles/{z}/{x}/{y}.pbf,
+// refers to a directory tile pyramid instead.
+class MBTilesFileSource : public FileSource {
+public:
+    MBTilesFileSource();
+    ~MBTilesFileSource() override;
+
+    std::unique_ptr<AsyncRequest> request(const Resource&, Callback) override;
+
+    static bool acceptsURL(const std::string& url);
+
+private:
+    class Impl;
+
+    std::unique_ptr<util::Thread<Impl>> impl;
+};
+
+} // namespace mbgl
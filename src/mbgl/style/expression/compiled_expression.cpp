@@ -0,0 +1,441 @@
+#include <mbgl/style/expression/compiled_expression.hpp>
+#include <mbgl/style/expression/interpolate.hpp>
+#include <mbgl/style/expression/literal.hpp>
+#include <mbgl/style/expression/step.hpp>
+#include <mbgl/style/expression/value.hpp>
+#include <mbgl/tile/geometry_tile_data.hpp>
+#include <mbgl/util/interpolate.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace mbgl {
+namespace style {
+namespace expression {
+
+namespace {
+
+using Program = CompiledFilter::Program;
+using NumberProgram = CompiledNumber::Program;
+
+Program compileFilter(const Expression&);
+NumberProgram compileNumber(const Expression&);
+
+std::vector<const Expression*> getChildren(const Expression& expression) {
+    std::vector<const Expression*> children;
+    expression.eachChild([&](const Expression& child) { children.push_back(&child); });
+    return children;
+}
+
+optional<Value> getLiteral(const Expression& expression) {
+    if (expression.getKind() != Kind::Literal) {
+        return nullopt;
+    }
+    return static_cast<const Literal&>(expression).getValue();
+}
+
+optional<std::string> getLiteralString(const Expression& expression) {
+    const optional<Value> value = getLiteral(expression);
+    if (!value || !value->is<std::string>()) {
+        return nullopt;
+    }
+    return value->get<std::string>();
+}
+
+// Returns the key of a ["get", key] expression with a literal key.
+optional<std::string> getPropertyKey(const Expression& expression) {
+    if (expression.getKind() != Kind::CompoundExpression || expression.getOperator() != "get") {
+        return nullopt;
+    }
+    const auto children = getChildren(expression);
+    if (children.size() != 1) {
+        return nullopt;
+    }
+    return getLiteralString(*children[0]);
+}
+
+optional<FeatureType> getFeatureType(const std::string& type) {
+    if (type == "Point") return FeatureType::Point;
+    if (type == "LineString") return FeatureType::LineString;
+    if (type == "Polygon") return FeatureType::Polygon;
+    if (type == "Unknown") return FeatureType::Unknown;
+    return nullopt;
+}
+
+// Same as `value == toExpressionValue(property)`, without converting the property.
+bool equals(const Value& value, const mbgl::Value& property) {
+    return property.match(
+        [&](const std::string& string) { return value.is<std::string>() && value.get<std::string>() == string; },
+        [&](bool boolean) { return value.is<bool>() && value.get<bool>() == boolean; },
+        [&](double number) { return value.is<double>() && value.get<double>() == number; },
+        [&](uint64_t number) { return value.is<double>() && value.get<double>() == static_cast<double>(number); },
+        [&](int64_t number) { return value.is<double>() && value.get<double>() == static_cast<double>(number); },
+        [&](const auto&) { return value == ValueConverter<mbgl::Value>::toExpressionValue(property); });
+}
+
+optional<double> toDouble(const mbgl::Value& property) {
+    return property.match(
+        [](double value) { return optional<double>(value); },
+        [](uint64_t value) { return optional<double>(static_cast<double>(value)); },
+        [](int64_t value) { return optional<double>(static_cast<double>(value)); },
+        [](const auto&) { return optional<double>(); });
+}
+
+// ["filter-<", key, value] and friends, which compare the property with the literal
+// value if both are numbers or both are strings.
+template <class Compare>
+Program compileLegacyOrdering(const std::vector<const Expression*>& args) {
+    if (args.size() != 2) return {};
+    const optional<std::string> key = getLiteralString(*args[0]);
+    const optional<Value> value = getLiteral(*args[1]);
+    if (!key || !value) return {};
+
+    FeaturePropertyKey propertyKey(*key);
+    if (value->is<double>()) {
+        const double number = value->get<double>();
+        return [propertyKey, number](const EvaluationContext& context) -> optional<bool> {
+            assert(context.feature);
+            const optional<mbgl::Value> property = context.feature->getPropertyValue(propertyKey);
+            const optional<double> lhs = property ? toDouble(*property) : nullopt;
+            return lhs ? Compare()(*lhs, number) : false;
+        };
+    } else if (value->is<std::string>()) {
+        const std::string string = value->get<std::string>();
+        return [propertyKey, string](const EvaluationContext& context) -> optional<bool> {
+            assert(context.feature);
+            const optional<mbgl::Value> property = context.feature->getPropertyValue(propertyKey);
+            return property && property->is<std::string>() ? Compare()(property->get<std::string>(), string) : false;
+        };
+    }
+    return {};
+}
+
+Program compileCompoundExpression(const Expression& expression, const std::string& op) {
+    const auto args = getChildren(expression);
+
+    if (op == "!" && args.size() == 1) {
+        Program input = compileFilter(*args[0]);
+        return [input](const EvaluationContext& context) -> optional<bool> {
+            const optional<bool> result = input(context);
+            return result ? optional<bool>(!*result) : nullopt;
+        };
+    }
+
+    if ((op == "has" || op == "filter-has") && args.size() == 1) {
+        const optional<std::string> key = getLiteralString(*args[0]);
+        if (!key) return {};
+        FeaturePropertyKey propertyKey(*key);
+        return [propertyKey](const EvaluationContext& context) -> optional<bool> {
+            if (!context.feature) return nullopt;
+            return bool(context.feature->getPropertyValue(propertyKey));
+        };
+    }
+
+    if (op == "filter-==" && args.size() == 2) {
+        const optional<std::string> key = getLiteralString(*args[0]);
+        const optional<Value> value = getLiteral(*args[1]);
+        if (!key || !value) return {};
+        FeaturePropertyKey propertyKey(*key);
+        return [propertyKey, value](const EvaluationContext& context) -> optional<bool> {
+            assert(context.feature);
+            const optional<mbgl::Value> property = context.feature->getPropertyValue(propertyKey);
+            return property ? equals(*value, *property) : false;
+        };
+    }
+
+    if (op == "filter-in" && args.size() >= 2) {
+        const optional<std::string> key = getLiteralString(*args[0]);
+        if (!key) return {};
+        std::vector<Value> values;
+        for (std::size_t i = 1; i < args.size(); ++i) {
+            optional<Value> value = getLiteral(*args[i]);
+            if (!value) return {};
+            values.push_back(std::move(*value));
+        }
+        FeaturePropertyKey propertyKey(*key);
+        return [propertyKey, values](const EvaluationContext& context) -> optional<bool> {
+            assert(context.feature);
+            const optional<mbgl::Value> property = context.feature->getPropertyValue(propertyKey);
+            if (!property) return false;
+            return std::any_of(values.begin(), values.end(), [&](const Value& value) { return equals(value, *property); });
+        };
+    }
+
+    if (op == "filter-type-==" || op == "filter-type-in") {
+        // Names that aren't feature types never match.
+        std::vector<FeatureType> types;
+        for (const Expression* arg : args) {
+            const optional<std::string> name = getLiteralString(*arg);
+            if (!name) return {};
+            if (const optional<FeatureType> type = getFeatureType(*name)) {
+                types.push_back(*type);
+            }
+        }
+        return [types](const EvaluationContext& context) -> optional<bool> {
+            if (!context.feature) return false;
+            return std::find(types.begin(), types.end(), context.feature->getType()) != types.end();
+        };
+    }
+
+    if (op == "filter-<") return compileLegacyOrdering<std::less<>>(args);
+    if (op == "filter->") return compileLegacyOrdering<std::greater<>>(args);
+    if (op == "filter-<=") return compileLegacyOrdering<std::less_equal<>>(args);
+    if (op == "filter->=") return compileLegacyOrdering<std::greater_equal<>>(args);
+
+    return {};
+}
+
+// ["==", ["get", key], value] and ["!=", ["get", key], value], in either order.
+Program compileComparison(const Expression& expression, const std::string& op) {
+    if (op != "==" && op != "!=") return {};
+    const auto args = getChildren(expression);
+    if (args.size() != 2) return {};
+
+    optional<std::string> key = getPropertyKey(*args[0]);
+    optional<Value> value = getLiteral(*args[1]);
+    if (!key || !value) {
+        key = getPropertyKey(*args[1]);
+        value = getLiteral(*args[0]);
+    }
+    if (!key || !value) return {};
+
+    FeaturePropertyKey propertyKey(*key);
+    const bool negate = op == "!=";
+    return [propertyKey, value, negate](const EvaluationContext& context) -> optional<bool> {
+        if (!context.feature) return nullopt;
+        const optional<mbgl::Value> property = context.feature->getPropertyValue(propertyKey);
+        // ["get", key] evaluates to null for missing properties.
+        const bool equal = property ? equals(*value, *property) : value->is<NullValue>();
+        return equal != negate;
+    };
+}
+
+Program compileFilter(const Expression& expression) {
+    Program program;
+
+    switch (expression.getKind()) {
+    case Kind::Literal: {
+        const Value value = static_cast<const Literal&>(expression).getValue();
+        if (value.is<bool>()) {
+            const bool result = value.get<bool>();
+            program = [result](const EvaluationContext&) -> optional<bool> { return result; };
+        }
+        break;
+    }
+    case Kind::All:
+    case Kind::Any: {
+        std::vector<Program> inputs;
+        expression.eachChild([&](const Expression& child) { inputs.push_back(compileFilter(child)); });
+        // Stops at the first input evaluating to `shortCircuit`, or raising an error.
+        const bool shortCircuit = expression.getKind() == Kind::Any;
+        program = [inputs, shortCircuit](const EvaluationContext& context) -> optional<bool> {
+            for (const Program& input : inputs) {
+                const optional<bool> result = input(context);
+                if (!result || *result == shortCircuit) return result;
+            }
+            return !shortCircuit;
+        };
+        break;
+    }
+    case Kind::CompoundExpression:
+        program = compileCompoundExpression(expression, expression.getOperator());
+        break;
+    case Kind::Comparison:
+        program = compileComparison(expression, expression.getOperator());
+        break;
+    default:
+        break;
+    }
+
+    if (!program) {
+        program = [&expression](const EvaluationContext& context) -> optional<bool> {
+            const EvaluationResult result = expression.evaluate(context);
+            if (!result) return nullopt;
+            return fromExpressionValue<bool>(*result);
+        };
+    }
+    return program;
+}
+
+// ["number", input, ...] with inputs that are ["get", key] or literals, which
+// evaluates to the first input that is a number.
+NumberProgram compileNumberAssertion(const Expression& expression) {
+    struct Input {
+        optional<FeaturePropertyKey> key;
+        optional<double> number;
+    };
+    std::vector<Input> inputs;
+    for (const Expression* child : getChildren(expression)) {
+        if (const optional<std::string> key = getPropertyKey(*child)) {
+            inputs.push_back({ FeaturePropertyKey(*key), nullopt });
+        } else if (const optional<Value> value = getLiteral(*child)) {
+            inputs.push_back({ nullopt, value->is<double>() ? optional<double>(value->get<double>()) : nullopt });
+        } else {
+            return {};
+        }
+    }
+
+    return [inputs](const EvaluationContext& context) -> optional<double> {
+        for (const Input& input : inputs) {
+            if (input.key) {
+                if (!context.feature) return nullopt;
+                const optional<mbgl::Value> property = context.feature->getPropertyValue(*input.key);
+                const optional<double> number = property ? toDouble(*property) : nullopt;
+                if (number) return number;
+            } else if (input.number) {
+                return input.number;
+            }
+        }
+        return nullopt;
+    };
+}
+
+// The stop inputs of an interpolate or step expression, and their compiled outputs.
+struct NumberStops {
+    std::vector<double> inputs;
+    std::vector<NumberProgram> outputs;
+
+    // Index of the first stop whose input is greater than `x`.
+    std::size_t upperBound(float x) const {
+        return std::upper_bound(inputs.begin(), inputs.end(), x) - inputs.begin();
+    }
+};
+
+template <class Curve>
+NumberStops compileStops(const Curve& curve) {
+    NumberStops stops;
+    curve.eachStop([&](double input, const Expression& output) {
+        stops.inputs.push_back(input);
+        stops.outputs.push_back(compileNumber(output));
+    });
+    return stops;
+}
+
+// Same as InterpolateImpl<double>::evaluate, which also rounds the input to a float.
+NumberProgram compileInterpolate(const Interpolate& interpolate) {
+    NumberProgram input = compileNumber(*interpolate.getInput());
+    NumberStops stops = compileStops(interpolate);
+    if (stops.inputs.empty()) return {};
+
+    return [&interpolate, input, stops](const EvaluationContext& context) -> optional<double> {
+        const optional<double> evaluatedInput = input(context);
+        if (!evaluatedInput) return nullopt;
+        const float x = *evaluatedInput;
+        if (std::isnan(x)) return nullopt;
+
+        const std::size_t i = stops.upperBound(x);
+        if (i == stops.inputs.size()) return stops.outputs.back()(context);
+        if (i == 0) return stops.outputs.front()(context);
+
+        const float t = interpolate.interpolationFactor({ stops.inputs[i - 1], stops.inputs[i] }, x);
+        if (t == 0.0f) return stops.outputs[i - 1](context);
+        if (t == 1.0f) return stops.outputs[i](context);
+
+        const optional<double> lower = stops.outputs[i - 1](context);
+        if (!lower) return nullopt;
+        const optional<double> upper = stops.outputs[i](context);
+        if (!upper) return nullopt;
+        return util::interpolate(*lower, *upper, t);
+    };
+}
+
+NumberProgram compileStep(const Step& step) {
+    NumberProgram input = compileNumber(*step.getInput());
+    NumberStops stops = compileStops(step);
+    if (stops.inputs.empty()) return {};
+
+    return [input, stops](const EvaluationContext& context) -> optional<double> {
+        const optional<double> evaluatedInput = input(context);
+        if (!evaluatedInput) return nullopt;
+        const float x = *evaluatedInput;
+        if (std::isnan(x)) return nullopt;
+
+        const std::size_t i = stops.upperBound(x);
+        return stops.outputs[i == 0 ? 0 : i - 1](context);
+    };
+}
+
+NumberProgram compileCase(const Expression& expression) {
+    const auto children = getChildren(expression);
+    std::vector<std::pair<Program, NumberProgram>> branches;
+    for (std::size_t i = 0; i + 1 < children.size(); i += 2) {
+        branches.emplace_back(compileFilter(*children[i]), compileNumber(*children[i + 1]));
+    }
+    NumberProgram otherwise = compileNumber(*children.back());
+
+    return [branches, otherwise](const EvaluationContext& context) -> optional<double> {
+        for (const auto& branch : branches) {
+            const optional<bool> test = branch.first(context);
+            if (!test) return nullopt;
+            if (*test) return branch.second(context);
+        }
+        return otherwise(context);
+    };
+}
+
+NumberProgram compileNumber(const Expression& expression) {
+    NumberProgram program;
+
+    switch (expression.getKind()) {
+    case Kind::Literal: {
+        const Value value = static_cast<const Literal&>(expression).getValue();
+        if (value.is<double>()) {
+            const double result = value.get<double>();
+            program = [result](const EvaluationContext&) -> optional<double> { return result; };
+        }
+        break;
+    }
+    case Kind::CompoundExpression:
+        if (expression.getOperator() == "zoom") {
+            program = [](const EvaluationContext& context) -> optional<double> {
+                return context.zoom ? optional<double>(*context.zoom) : nullopt;
+            };
+        }
+        break;
+    case Kind::Assertion:
+        if (expression.getType() == type::Number) {
+            program = compileNumberAssertion(expression);
+        }
+        break;
+    case Kind::Interpolate:
+        program = compileInterpolate(static_cast<const Interpolate&>(expression));
+        break;
+    case Kind::Step:
+        program = compileStep(static_cast<const Step&>(expression));
+        break;
+    case Kind::Case:
+        program = compileCase(expression);
+        break;
+    default:
+        break;
+    }
+
+    if (!program) {
+        program = [&expression](const EvaluationContext& context) -> optional<double> {
+            const EvaluationResult result = expression.evaluate(context);
+            if (!result || !result->is<double>()) return nullopt;
+            return result->get<double>();
+        };
+    }
+    return program;
+}
+
+} // namespace
+
+CompiledFilter::CompiledFilter(std::shared_ptr<const Expression> expression_)
+    : expression(std::move(expression_)),
+      program(compileFilter(*expression)) {
+}
+
+CompiledNumber::CompiledNumber(std::shared_ptr<const Expression> expression_)
+    : expression(std::move(expression_)),
+      program(compileNumber(*expression)) {
+    assert(expression->getType() == type::Number);
+}
+
+} // namespace expression
+} // namespace style
+} // namespace mbgl
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <mbgl/style/expression/expression.hpp>
+#include <mbgl/util/optional.hpp>
+
+#include <functional>
+#include <memory>
+
+namespace mbgl {
+namespace style {
+namespace expression {
+
+// An expression lowered into a tree of closures that return their result as a
+// T, or nullopt if the evaluation raised an error.
+template <class T>
+using CompiledProgram = std::function<optional<T>(const EvaluationContext&)>;
+
+// A filter expression lowered into a tree of closures. Boolean operators, the
+// legacy filter operators and equality comparisons of a feature property with a
+// literal are evaluated without going through EvaluationResult, and with the
+// property keys resolved once at compile time. Any other subexpression is
+// evaluated as an expression.
+class CompiledFilter {
+public:
+    explicit CompiledFilter(std::shared_ptr<const Expression>);
+
+    // Returns nullopt if the evaluation raised an error.
+    optional<bool> operator()(const EvaluationContext& context) const {
+        return program(context);
+    }
+
+    using Program = CompiledProgram<bool>;
+
+private:
+    // Owns the expression nodes referenced by the fallback closures.
+    std::shared_ptr<const Expression> expression;
+    Program program;
+};
+
+// A number-typed expression, such as a data-driven paint or layout property,
+// lowered the same way. Number literals, ["zoom"], ["number", ["get", key]],
+// interpolate, step and case are evaluated directly, and case conditions are
+// compiled like filters.
+class CompiledNumber {
+public:
+    explicit CompiledNumber(std::shared_ptr<const Expression>);
+
+    // Returns nullopt if the evaluation raised an error.
+    optional<double> operator()(const EvaluationContext& context) const {
+        return program(context);
+    }
+
+    using Program = CompiledProgram<double>;
+
+private:
+    std::shared_ptr<const Expression> expression;
+    Program program;
+};
+
+} // namespace expression
+} // namespace style
+} // namespace mbgl
@@ -1,12 +1,26 @@
 #include <mbgl/style/filter.hpp>
+#include <mbgl/style/expression/compiled_expression.hpp>
 #include <mbgl/tile/geometry_tile_data.hpp>
 
 namespace mbgl {
 namespace style {
 
+Filter::Filter(expression::ParseResult _expression, optional<mbgl::Value> _filter)
+    : expression(std::move(*_expression)),
+      legacyFilter(std::move(_filter)) {
+    assert(!expression || *expression != nullptr);
+    if (expression) {
+        compiled = std::make_shared<const expression::CompiledFilter>(*expression);
+    }
+}
+
 bool Filter::operator()(const expression::EvaluationContext &context) const {
     
     if (!this->expression) return true;
+
+    if (compiled) {
+        return (*compiled)(context).value_or(false);
+    }
     
     const expression::EvaluationResult result = (*this->expression)->evaluate(context);
     if (result) {
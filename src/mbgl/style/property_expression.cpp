@@ -1,4 +1,5 @@
 #include <mbgl/style/property_expression.hpp>
+#include <mbgl/style/expression/compiled_expression.hpp>
 
 namespace mbgl {
 namespace style {
@@ -9,6 +10,9 @@ PropertyExpressionBase::PropertyExpressionBase(std::unique_ptr<expression::Expre
     isZoomConstant_ = expression::isZoomConstant(*expression);
     isFeatureConstant_ = expression::isFeatureConstant(*expression);
     isRuntimeConstant_ = expression::isRuntimeConstant(*expression);
+    if (expression->getType() == expression::type::Number) {
+        compiledNumber = std::make_shared<const expression::CompiledNumber>(expression);
+    }
 }
 
 bool PropertyExpressionBase::isZoomConstant() const noexcept {
@@ -54,5 +58,10 @@ const expression::Expression& PropertyExpressionBase::getExpression() const noex
     return *expression;
 }
 
+optional<double> PropertyExpressionBase::evaluateNumber(const expression::EvaluationContext& context) const {
+    assert(compiledNumber);
+    return (*compiledNumber)(context);
+}
+
 } // namespace style
 } // namespace mbgl
@@ -26,6 +26,13 @@ static const float viewportPaddingDefault = 100;
 // Viewport padding must be much larger for static tiles to avoid clipped labels.
 static const float viewportPaddingForStaticTiles = 1024;
 
+template <class Geometry>
+static bool hitTest(const CollisionIndex::CollisionGrid& grid,
+                    const Geometry& geometry,
+                    const optional<std::function<bool(const IndexedSubfeature&)>>& predicate) {
+    return predicate ? grid.hitTest(geometry, *predicate) : grid.hitTest(geometry);
+}
+
 CollisionIndex::CollisionIndex(const TransformState& transformState_, MapMode& mapMode)
     : transformState(transformState_),
       viewportPadding(mapMode == MapMode::Tile ? viewportPaddingForStaticTiles : viewportPaddingDefault),
@@ -101,7 +108,7 @@ std::pair<bool,bool> CollisionIndex::placeFeature(const CollisionFeature& featur
                                       const bool pitchWithMap,
                                       const bool collisionDebug,
                                       const optional<CollisionTileBoundaries>& avoidEdges,
-                                      const optional<std::function<bool(const IndexedSubfeature&)>> collisionGroupPredicate,
+                                      const optional<std::function<bool(const IndexedSubfeature&)>>& collisionGroupPredicate,
                                       std::vector<ProjectedCollisionBox>& projectedBoxes) {
     assert(projectedBoxes.empty());
     if (!feature.alongLine) {
@@ -116,7 +123,7 @@ std::pair<bool,bool> CollisionIndex::placeFeature(const CollisionFeature& featur
 
         if ((avoidEdges && !isInsideTile(px1, py1, px2, py2, *avoidEdges)) ||
             !isInsideGrid(px1, py1, px2, py2) ||
-            (!allowOverlap && collisionGrid.hitTest(projectedBoxes.back().box(), collisionGroupPredicate))) {
+            (!allowOverlap && hitTest(collisionGrid, projectedBoxes.back().box(), collisionGroupPredicate))) {
             return { false, false };
         }
 
@@ -137,7 +144,7 @@ std::pair<bool,bool> CollisionIndex::placeLineFeature(const CollisionFeature& fe
                                       const bool pitchWithMap,
                                       const bool collisionDebug,
                                       const optional<CollisionTileBoundaries>& avoidEdges,
-                                      const optional<std::function<bool(const IndexedSubfeature&)>> collisionGroupPredicate,
+                                      const optional<std::function<bool(const IndexedSubfeature&)>>& collisionGroupPredicate,
                                       std::vector<ProjectedCollisionBox>& projectedBoxes) {
     assert(feature.alongLine);
     assert(projectedBoxes.empty());
@@ -238,7 +245,7 @@ std::pair<bool,bool> CollisionIndex::placeLineFeature(const CollisionFeature& fe
         inGrid |= isInsideGrid(px1, py1, px2, py2);
 
         if ((avoidEdges && !isInsideTile(px1, py1, px2, py2, *avoidEdges)) ||
-            (!allowOverlap && collisionGrid.hitTest(projectedBoxes[i].circle(), collisionGroupPredicate))) {
+            (!allowOverlap && hitTest(collisionGrid, projectedBoxes[i].circle(), collisionGroupPredicate))) {
             if (!collisionDebug) {
                 return {false, false};
             } else {
@@ -4,17 +4,47 @@
 #include <mbgl/renderer/render_tile.hpp>
 #include <mbgl/tile/tile.hpp>
 
+#include <algorithm>
+#include <tuple>
+
 namespace mbgl {
 
 
 TileLayerIndex::TileLayerIndex(OverscaledTileID coord_, std::vector<SymbolInstance>& symbolInstances, uint32_t bucketInstanceId_)
     : coord(coord_), bucketInstanceId(bucketInstanceId_) {
-        for (SymbolInstance& symbolInstance : symbolInstances) {
-            indexedSymbolInstances[symbolInstance.key].emplace_back(symbolInstance.crossTileID, getScaledCoordinates(symbolInstance, coord));
-        }
+    // Count the symbols of each key, and then lay the groups out one after the other.
+    std::vector<std::pair<uint32_t, uint32_t>*> symbolRanges;
+    symbolRanges.reserve(symbolInstances.size());
+    for (const SymbolInstance& symbolInstance : symbolInstances) {
+        auto& range = keyRanges[symbolInstance.key];
+        ++range.second;
+        symbolRanges.push_back(&range);
+    }
+
+    uint32_t offset = 0;
+    for (auto& entry : keyRanges) {
+        const uint32_t count = entry.second.second;
+        entry.second = { offset, offset };
+        offset += count;
+    }
+
+    indexedSymbolInstances.resize(symbolInstances.size(), IndexedSymbolInstance(0, { 0, 0 }, 0));
+    for (uint32_t i = 0; i < symbolInstances.size(); ++i) {
+        const SymbolInstance& symbolInstance = symbolInstances[i];
+        indexedSymbolInstances[symbolRanges[i]->second++] =
+            IndexedSymbolInstance(symbolInstance.crossTileID, getScaledCoordinates(symbolInstance, coord), i);
     }
 
-Point<int64_t> TileLayerIndex::getScaledCoordinates(SymbolInstance& symbolInstance, const OverscaledTileID& childTileCoord) {
+    for (const auto& entry : keyRanges) {
+        std::sort(indexedSymbolInstances.begin() + entry.second.first,
+                  indexedSymbolInstances.begin() + entry.second.second,
+                  [](const IndexedSymbolInstance& a, const IndexedSymbolInstance& b) {
+                      return std::tie(a.coord.x, a.order) < std::tie(b.coord.x, b.order);
+                  });
+    }
+}
+
+Point<int64_t> TileLayerIndex::getScaledCoordinates(const SymbolInstance& symbolInstance, const OverscaledTileID& childTileCoord) const {
     // Round anchor positions to roughly 4 pixel grid
     const double roundingFactor = 512.0 / util::EXTENT / 2.0;
     const double scale = roundingFactor / std::pow(2, childTileCoord.canonical.z - coord.canonical.z);
@@ -24,8 +54,8 @@ Point<int64_t> TileLayerIndex::getScaledCoordinates(SymbolInstance& symbolInstan
     };
 }
 
-void TileLayerIndex::findMatches(std::vector<SymbolInstance>& symbolInstances, const OverscaledTileID& newCoord, std::set<uint32_t>& zoomCrossTileIDs) {
-    float tolerance = coord.canonical.z < newCoord.canonical.z ? 1 : std::pow(2, coord.canonical.z - newCoord.canonical.z);
+void TileLayerIndex::findMatches(std::vector<SymbolInstance>& symbolInstances, const OverscaledTileID& newCoord, std::unordered_set<uint32_t>& zoomCrossTileIDs) const {
+    const int64_t tolerance = coord.canonical.z < newCoord.canonical.z ? 1 : int64_t(1) << (coord.canonical.z - newCoord.canonical.z);
 
     for (auto& symbolInstance : symbolInstances) {
         if (symbolInstance.crossTileID) {
@@ -33,28 +63,38 @@ void TileLayerIndex::findMatches(std::vector<SymbolInstance>& symbolInstances, c
             continue;
         }
 
-        auto it = indexedSymbolInstances.find(symbolInstance.key);
-        if (it == indexedSymbolInstances.end()) {
+        auto it = keyRanges.find(symbolInstance.key);
+        if (it == keyRanges.end()) {
             // No symbol with this key in this bucket
             continue;
         }
 
         auto scaledSymbolCoord = getScaledCoordinates(symbolInstance, newCoord);
 
-        for (IndexedSymbolInstance& thisTileSymbol: it->second) {
-            // Return any symbol with the same keys whose coordinates are within 1
-            // grid unit. (with a 4px grid, this covers a 12px by 12px area)
-            if (std::abs(thisTileSymbol.coord.x - scaledSymbolCoord.x) <= tolerance &&
-                std::abs(thisTileSymbol.coord.y - scaledSymbolCoord.y) <= tolerance &&
-                zoomCrossTileIDs.find(thisTileSymbol.crossTileID) == zoomCrossTileIDs.end()) {
-                // Once we've marked ourselves duplicate against this parent symbol,
-                // don't let any other symbols at the same zoom level duplicate against
-                // the same parent (see issue #10844)
-                zoomCrossTileIDs.insert(thisTileSymbol.crossTileID);
-                symbolInstance.crossTileID = thisTileSymbol.crossTileID;
-                break;
+        // Use the first symbol in bucket order with the same key whose coordinates are
+        // within 1 grid unit. (with a 4px grid, this covers a 12px by 12px area)
+        const auto begin = indexedSymbolInstances.begin() + it->second.first;
+        const auto end = indexedSymbolInstances.begin() + it->second.second;
+        auto candidate = std::lower_bound(begin, end, scaledSymbolCoord.x - tolerance,
+                                          [](const IndexedSymbolInstance& indexed, int64_t x) {
+                                              return indexed.coord.x < x;
+                                          });
+        const IndexedSymbolInstance* match = nullptr;
+        for (; candidate != end && candidate->coord.x <= scaledSymbolCoord.x + tolerance; ++candidate) {
+            if ((!match || candidate->order < match->order) &&
+                std::abs(candidate->coord.y - scaledSymbolCoord.y) <= tolerance &&
+                zoomCrossTileIDs.find(candidate->crossTileID) == zoomCrossTileIDs.end()) {
+                match = &*candidate;
             }
         }
+
+        if (match) {
+            // Once we've marked ourselves duplicate against this parent symbol,
+            // don't let any other symbols at the same zoom level duplicate against
+            // the same parent (see issue #10844)
+            zoomCrossTileIDs.insert(match->crossTileID);
+            symbolInstance.crossTileID = match->crossTileID;
+        }
     }
 }
 
@@ -69,35 +109,30 @@ void CrossTileSymbolLayerIndex::handleWrapJump(float newLng) {
 
     const int wrapDelta = ::round((newLng - lng) / 360);
     if (wrapDelta != 0) {
-        std::map<uint8_t, std::map<OverscaledTileID,TileLayerIndex>> newIndexes;
-        for (auto& zoomIndex : indexes) {
-            std::map<OverscaledTileID,TileLayerIndex> newZoomIndex;
-            for (auto& index : zoomIndex.second) {
-                // change the tileID's wrap and move its index
-                index.second.coord = index.second.coord.unwrapTo(index.second.coord.wrap + wrapDelta);
-                newZoomIndex.emplace(index.second.coord, std::move(index.second));
-            }
-            newIndexes.emplace(zoomIndex.first, std::move(newZoomIndex));
+        // All tiles move by the same number of wraps, so the indexes stay sorted.
+        for (auto& index : indexes) {
+            index.coord = index.coord.unwrapTo(index.coord.wrap + wrapDelta);
         }
-
-        indexes = std::move(newIndexes);
     }
 
     lng = newLng;
 }
 
 bool CrossTileSymbolLayerIndex::addBucket(const OverscaledTileID& tileID, SymbolBucket& bucket, uint32_t& maxCrossTileID) {
-    const auto& thisZoomIndexes = indexes[tileID.overscaledZ];
-    auto previousIndex = thisZoomIndexes.find(tileID);
-    if (previousIndex != thisZoomIndexes.end()) {
-        if (previousIndex->second.bucketInstanceId == bucket.bucketInstanceId) {
+    auto previousIndex = std::lower_bound(indexes.begin(), indexes.end(), tileID,
+                                          [](const TileLayerIndex& index, const OverscaledTileID& id) {
+                                              return index.coord < id;
+                                          });
+    const bool replacesIndex = previousIndex != indexes.end() && previousIndex->coord == tileID;
+    if (replacesIndex) {
+        if (previousIndex->bucketInstanceId == bucket.bucketInstanceId) {
             return false;
         } else {
             // We're replacing this bucket with an updated version
             // Remove the old bucket's "used crossTileIDs" now so that the new bucket can claim them.
             // We have to keep the old index entries themselves until the end of 'addBucket' so
             // that we can copy them with 'findMatches'.
-            removeBucketCrossTileIDs(tileID.overscaledZ, previousIndex->second);
+            removeBucketCrossTileIDs(tileID.overscaledZ, *previousIndex);
         }
     }
 
@@ -105,21 +140,14 @@ bool CrossTileSymbolLayerIndex::addBucket(const OverscaledTileID& tileID, Symbol
         symbolInstance.crossTileID = 0;
     }
 
-    for (auto& it : indexes) {
-        auto zoom = it.first;
-        auto zoomIndexes = it.second;
-        if (zoom > tileID.overscaledZ) {
-            for (auto& childIndex : zoomIndexes) {
-                if (childIndex.second.coord.isChildOf(tileID)) {
-                    childIndex.second.findMatches(bucket.symbolInstances, tileID, usedCrossTileIDs[tileID.overscaledZ]);
-                }
-            }
-        } else {
-            auto parentTileID = tileID.scaledTo(zoom);
-            auto parentIndex = zoomIndexes.find(parentTileID);
-            if (parentIndex != zoomIndexes.end()) {
-                parentIndex->second.findMatches(bucket.symbolInstances, tileID, usedCrossTileIDs[tileID.overscaledZ]);
+    auto& zoomCrossTileIDs = usedCrossTileIDs[tileID.overscaledZ];
+    for (const auto& index : indexes) {
+        if (index.coord.overscaledZ > tileID.overscaledZ) {
+            if (index.coord.isChildOf(tileID)) {
+                index.findMatches(bucket.symbolInstances, tileID, zoomCrossTileIDs);
             }
+        } else if (index.coord == tileID.scaledTo(index.coord.overscaledZ)) {
+            index.findMatches(bucket.symbolInstances, tileID, zoomCrossTileIDs);
         }
     }
 
@@ -127,37 +155,36 @@ bool CrossTileSymbolLayerIndex::addBucket(const OverscaledTileID& tileID, Symbol
         if (!symbolInstance.crossTileID) {
             // symbol did not match any known symbol, assign a new id
             symbolInstance.crossTileID = ++maxCrossTileID;
-            usedCrossTileIDs[tileID.overscaledZ].insert(symbolInstance.crossTileID);
+            zoomCrossTileIDs.insert(symbolInstance.crossTileID);
         }
     }
 
-
-    indexes[tileID.overscaledZ].erase(tileID);
-    indexes[tileID.overscaledZ].emplace(tileID, TileLayerIndex(tileID, bucket.symbolInstances, bucket.bucketInstanceId));
+    TileLayerIndex index(tileID, bucket.symbolInstances, bucket.bucketInstanceId);
+    if (replacesIndex) {
+        *previousIndex = std::move(index);
+    } else {
+        indexes.insert(previousIndex, std::move(index));
+    }
     return true;
 }
 
 void CrossTileSymbolLayerIndex::removeBucketCrossTileIDs(uint8_t zoom, const TileLayerIndex& removedBucket) {
-    for (auto key : removedBucket.indexedSymbolInstances) {
-        for (auto indexedSymbolInstance : key.second) {
-            usedCrossTileIDs[zoom].erase(indexedSymbolInstance.crossTileID);
-        }
+    auto& zoomCrossTileIDs = usedCrossTileIDs[zoom];
+    for (const auto& indexedSymbolInstance : removedBucket.indexedSymbolInstances) {
+        zoomCrossTileIDs.erase(indexedSymbolInstance.crossTileID);
     }
 }
 
 bool CrossTileSymbolLayerIndex::removeStaleBuckets(const std::unordered_set<uint32_t>& currentIDs) {
-    bool tilesChanged = false;
-    for (auto& zoomIndexes : indexes) {
-        for (auto it = zoomIndexes.second.begin(); it != zoomIndexes.second.end();) {
-            if (!currentIDs.count(it->second.bucketInstanceId)) {
-                removeBucketCrossTileIDs(zoomIndexes.first, it->second);
-                it = zoomIndexes.second.erase(it);
-                tilesChanged = true;
-            } else {
-                ++it;
-            }
+    const auto end = std::remove_if(indexes.begin(), indexes.end(), [&](const TileLayerIndex& index) {
+        if (currentIDs.count(index.bucketInstanceId)) {
+            return false;
         }
-    }
+        removeBucketCrossTileIDs(index.coord.overscaledZ, index);
+        return true;
+    });
+    const bool tilesChanged = end != indexes.end();
+    indexes.erase(end, indexes.end());
     return tilesChanged;
 }
 
@@ -11,6 +11,7 @@
 #include <vector>
 #include <string>
 #include <memory>
+#include <unordered_map>
 #include <unordered_set>
 
 namespace mbgl {
@@ -21,24 +22,31 @@ class SymbolBucket;
 
 class IndexedSymbolInstance {
 public:
-    IndexedSymbolInstance(uint32_t crossTileID_, Point<int64_t> coord_)
-        : crossTileID(crossTileID_), coord(coord_)
+    IndexedSymbolInstance(uint32_t crossTileID_, Point<int64_t> coord_, uint32_t order_)
+        : crossTileID(crossTileID_), coord(coord_), order(order_)
     {}
 
     uint32_t crossTileID;
     Point<int64_t> coord;
+    // Position of the symbol in its bucket. Of several matching symbols, the
+    // first one in the bucket is used.
+    uint32_t order;
 };
 
 class TileLayerIndex {
 public:
     TileLayerIndex(OverscaledTileID coord, std::vector<SymbolInstance>&, uint32_t bucketInstanceId);
 
-    Point<int64_t> getScaledCoordinates(SymbolInstance&, const OverscaledTileID&);
-    void findMatches(std::vector<SymbolInstance>&, const OverscaledTileID&, std::set<uint32_t>&);
+    Point<int64_t> getScaledCoordinates(const SymbolInstance&, const OverscaledTileID&) const;
+    void findMatches(std::vector<SymbolInstance>&, const OverscaledTileID&, std::unordered_set<uint32_t>&) const;
     
     OverscaledTileID coord;
     uint32_t bucketInstanceId;
-    std::map<std::u16string,std::vector<IndexedSymbolInstance>> indexedSymbolInstances;
+    // Symbols grouped by key, and sorted by x coordinate within a group so that
+    // the candidates for a match are found with a binary search.
+    std::vector<IndexedSymbolInstance> indexedSymbolInstances;
+    // The [begin, end) range of each key's group in `indexedSymbolInstances`.
+    std::unordered_map<std::u16string, std::pair<uint32_t, uint32_t>> keyRanges;
 };
 
 class CrossTileSymbolLayerIndex {
@@ -50,8 +58,9 @@ public:
 private:
     void removeBucketCrossTileIDs(uint8_t zoom, const TileLayerIndex& removedBucket);
 
-    std::map<uint8_t, std::map<OverscaledTileID,TileLayerIndex>> indexes;
-    std::map<uint8_t, std::set<uint32_t>> usedCrossTileIDs;
+    // Sorted by tile ID, and thus by zoom level first.
+    std::vector<TileLayerIndex> indexes;
+    std::map<uint8_t, std::unordered_set<uint32_t>> usedCrossTileIDs;
     float lng = 0;
 };
 
@@ -1,65 +1,145 @@
 #include <mbgl/text/glyph_atlas.hpp>
 
-#include <mapbox/shelf-pack.hpp>
+#include <cassert>
 
 namespace mbgl {
 
 static constexpr uint32_t padding = 1;
 
-GlyphAtlas makeGlyphAtlas(const GlyphMap& glyphs) {
-    GlyphAtlas result;
+namespace {
 
+// Packs the glyphs into an image of their own, the way each tile did before the
+// atlas was shared.
+AlphaImage makeOwnImage(const GlyphMap& glyphs, GlyphPositions& positions) {
     mapbox::ShelfPack::ShelfPackOptions options;
     options.autoResize = true;
     mapbox::ShelfPack pack(0, 0, options);
 
+    std::vector<std::pair<const Glyph*, const mapbox::Bin*>> packedGlyphs;
     for (const auto& glyphMapEntry : glyphs) {
-        FontStackHash fontStack = glyphMapEntry.first;
-        GlyphPositionMap& positions = result.positions[fontStack];
-
+        GlyphPositionMap& fontStackPositions = positions[glyphMapEntry.first];
         for (const auto& entry : glyphMapEntry.second) {
-            if (entry.second && (*entry.second)->bitmap.valid()) {
-                const Glyph& glyph = **entry.second;
-
-                const mapbox::Bin& bin = *pack.packOne(-1,
-                    glyph.bitmap.size.width + 2 * padding,
-                    glyph.bitmap.size.height + 2 * padding);
-
-                result.image.resize({
-                    static_cast<uint32_t>(pack.width()),
-                    static_cast<uint32_t>(pack.height())
-                });
-
-                AlphaImage::copy(glyph.bitmap,
-                                 result.image,
-                                 { 0, 0 },
-                                 {
-                                    bin.x + padding,
-                                    bin.y + padding
-                                 },
-                                 glyph.bitmap.size);
-
-                positions.emplace(glyph.id,
-                                  GlyphPosition {
-                                     Rect<uint16_t> {
-                                         static_cast<uint16_t>(bin.x),
-                                         static_cast<uint16_t>(bin.y),
-                                         static_cast<uint16_t>(bin.w),
-                                         static_cast<uint16_t>(bin.h)
-                                     },
-                                     glyph.metrics
-                                  });
+            if (!entry.second || !(*entry.second)->bitmap.valid()) {
+                continue;
             }
+            const Glyph& glyph = **entry.second;
+            const mapbox::Bin& bin = *pack.packOne(-1,
+                glyph.bitmap.size.width + 2 * padding,
+                glyph.bitmap.size.height + 2 * padding);
+            packedGlyphs.emplace_back(&glyph, &bin);
+            fontStackPositions[glyph.id] = GlyphPosition {
+                Rect<uint16_t> {
+                    static_cast<uint16_t>(bin.x),
+                    static_cast<uint16_t>(bin.y),
+                    static_cast<uint16_t>(bin.w),
+                    static_cast<uint16_t>(bin.h)
+                },
+                glyph.metrics
+            };
         }
     }
 
     pack.shrink();
-    result.image.resize({
-        static_cast<uint32_t>(pack.width()),
-        static_cast<uint32_t>(pack.height())
-    });
+    AlphaImage image({ static_cast<uint32_t>(pack.width()), static_cast<uint32_t>(pack.height()) });
+    for (const auto& packedGlyph : packedGlyphs) {
+        const Glyph& glyph = *packedGlyph.first;
+        const mapbox::Bin& bin = *packedGlyph.second;
+        AlphaImage::copy(glyph.bitmap, image, { 0, 0 },
+                         { bin.x + padding, bin.y + padding }, glyph.bitmap.size);
+    }
+    return image;
+}
+
+} // namespace
+
+GlyphAtlas::GlyphAtlas(Size maximumSize_)
+    : ShelfAtlas(maximumSize_) {
+}
+
+GlyphAtlas::~GlyphAtlas() = default;
+
+GlyphAtlasReference GlyphAtlas::addGlyphs(const GlyphMap& glyphs, GlyphPositions& positions) {
+    std::vector<int32_t> referencedBinIDs;
+    std::vector<std::pair<const Glyph*, int32_t>> addedGlyphs;
+    bool full = false;
+
+    std::unique_lock<std::mutex> lock(mutex);
+
+    for (const auto& glyphMapEntry : glyphs) {
+        if (full) {
+            break;
+        }
+        const FontStackHash fontStack = glyphMapEntry.first;
+        auto& fontStackBinIDs = binIDsByGlyph[fontStack];
+        GlyphPositionMap& fontStackPositions = positions[fontStack];
+
+        for (const auto& entry : glyphMapEntry.second) {
+            if (!entry.second || !(*entry.second)->bitmap.valid()) {
+                continue;
+            }
+            const Glyph& glyph = **entry.second;
+
+            mapbox::Bin* bin = nullptr;
+            bool added = false;
+            auto it = fontStackBinIDs.find(glyph.id);
+            if (it != fontStackBinIDs.end()) {
+                bin = &ref(it->second);
+            } else {
+                bin = add(glyph.bitmap.size.width + 2 * padding, glyph.bitmap.size.height + 2 * padding);
+                if (!bin) {
+                    full = true;
+                    break;
+                }
+                fontStackBinIDs.emplace(glyph.id, bin->id);
+                keysByBinID.emplace(bin->id, GlyphKey { fontStack, glyph.id });
+                added = true;
+            }
+
+            const Rect<uint16_t> rect {
+                static_cast<uint16_t>(bin->x),
+                static_cast<uint16_t>(bin->y),
+                static_cast<uint16_t>(bin->w),
+                static_cast<uint16_t>(bin->h)
+            };
+            if (added) {
+                addedGlyphs.emplace_back(&glyph, bin->id);
+            }
+            referencedBinIDs.push_back(bin->id);
+            fontStackPositions.emplace(glyph.id, GlyphPosition { rect, glyph.metrics });
+        }
+    }
+
+    if (full) {
+        releaseLocked(referencedBinIDs);
+        lock.unlock();
+        return GlyphAtlasReference(makeOwnImage(glyphs, positions));
+    }
+
+    resizeImage();
+    for (const auto& addedGlyph : addedGlyphs) {
+        const Glyph& glyph = *addedGlyph.first;
+        const mapbox::Bin& bin = getBin(addedGlyph.second);
+        clearBin(bin);
+        AlphaImage::copy(glyph.bitmap, image, { 0, 0 }, { bin.x + padding, bin.y + padding }, glyph.bitmap.size);
+    }
+
+    return makeReference(std::move(referencedBinIDs));
+}
+
+void GlyphAtlas::evict(int32_t binID) {
+    auto it = keysByBinID.find(binID);
+    assert(it != keysByBinID.end());
+    auto fontStackBinIDs = binIDsByGlyph.find(it->second.fontStack);
+    fontStackBinIDs->second.erase(it->second.glyphID);
+    if (fontStackBinIDs->second.empty()) {
+        binIDsByGlyph.erase(fontStackBinIDs);
+    }
+    keysByBinID.erase(it);
+}
 
-    return result;
+std::size_t GlyphAtlas::getGlyphCount() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return keysByBinID.size();
 }
 
 } // namespace mbgl
@@ -1,8 +1,10 @@
 #pragma once
 
 #include <mbgl/text/glyph.hpp>
+#include <mbgl/renderer/shelf_atlas.hpp>
 
-#include <mapbox/shelf-pack.hpp>
+#include <unordered_map>
+#include <vector>
 
 namespace mbgl {
 
@@ -14,12 +16,36 @@ struct GlyphPosition {
 using GlyphPositionMap = std::map<GlyphID, GlyphPosition>;
 using GlyphPositions = std::map<FontStackHash, GlyphPositionMap>;
 
-class GlyphAtlas {
+// Keeps the glyphs of a layout in the atlas.
+using GlyphAtlasReference = ShelfAtlasReference<AlphaImage>;
+
+// Glyph bitmaps of all font stacks, packed into a single image that is shared by
+// the tiles instead of being rebuilt for each of them. Glyphs are added by the
+// tile workers and counted per layout referencing them.
+class GlyphAtlas : public ShelfAtlas<AlphaImage> {
 public:
-    AlphaImage image;
-    GlyphPositions positions;
-};
+    explicit GlyphAtlas(Size maximumSize = { 2048, 2048 });
+    ~GlyphAtlas() override;
+
+    // Adds the glyphs of `glyphs` that aren't in the atlas yet, and returns the
+    // positions of all of them. The glyphs stay at these positions for as long
+    // as the returned reference is alive. If they don't all fit into the atlas,
+    // none of them is added, and they are packed into an image owned by the
+    // returned reference instead.
+    GlyphAtlasReference addGlyphs(const GlyphMap& glyphs, GlyphPositions& positions);
+
+    std::size_t getGlyphCount() const;
 
-GlyphAtlas makeGlyphAtlas(const GlyphMap&);
+private:
+    void evict(int32_t binID) override;
+
+    struct GlyphKey {
+        FontStackHash fontStack;
+        GlyphID glyphID;
+    };
+
+    std::unordered_map<FontStackHash, std::unordered_map<GlyphID, int32_t>> binIDsByGlyph;
+    std::unordered_map<int32_t, GlyphKey> keysByBinID;
+};
 
 } // namespace mbgl
@@ -4,16 +4,20 @@
 #include <mbgl/storage/file_source.hpp>
 #include <mbgl/storage/resource.hpp>
 #include <mbgl/storage/response.hpp>
+#include <mbgl/util/logging.hpp>
 #include <mbgl/util/tiny_sdf.hpp>
 #include <mbgl/util/std.hpp>
 
+#include <cassert>
+
 namespace mbgl {
 
 static GlyphManagerObserver nullObserver;
 
 GlyphManager::GlyphManager(std::unique_ptr<LocalGlyphRasterizer> localGlyphRasterizer_)
     : observer(&nullObserver),
-      localGlyphRasterizer(std::move(localGlyphRasterizer_)) {
+      localGlyphRasterizer(std::move(localGlyphRasterizer_)),
+      atlas(std::make_shared<GlyphAtlas>()) {
 }
 
 GlyphManager::~GlyphManager() = default;
@@ -162,4 +166,19 @@ void GlyphManager::evict(const std::set<FontStack>& keep) {
     });
 }
 
+void GlyphManager::uploadAtlas(gfx::UploadPass& uploadPass) {
+    atlas->upload(uploadPass, atlasTexture);
+}
+
+const gfx::Texture& GlyphManager::getAtlasTexture() const {
+    assert(atlasTexture);
+    return *atlasTexture;
+}
+
+void GlyphManager::dumpDebugLogs() const {
+    const Size size = atlas->getSize();
+    Log::Info(Event::General, "GlyphManager::atlas: %ux%u, %zu glyphs, %zu bytes",
+              size.width, size.height, atlas->getGlyphCount(), atlas->getMemoryUsage());
+}
+
 } // namespace mbgl
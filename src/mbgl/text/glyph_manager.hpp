@@ -1,17 +1,23 @@
 #pragma once
 
 #include <mbgl/text/glyph.hpp>
+#include <mbgl/text/glyph_atlas.hpp>
 #include <mbgl/text/glyph_manager_observer.hpp>
 #include <mbgl/text/glyph_range.hpp>
 #include <mbgl/text/local_glyph_rasterizer.hpp>
 #include <mbgl/util/font_stack.hpp>
 #include <mbgl/util/immutable.hpp>
 
+#include <memory>
 #include <string>
 #include <unordered_map>
 
 namespace mbgl {
 
+namespace gfx {
+class UploadPass;
+} // namespace gfx
+
 class FileSource;
 class AsyncRequest;
 class Response;
@@ -48,6 +54,14 @@ public:
     // Remove glyphs for all but the supplied font stacks.
     void evict(const std::set<FontStack>&);
 
+    // The atlas shared by the symbol layouts of all tiles. Workers add their
+    // glyphs to it, and the texture is updated on the render thread.
+    const std::shared_ptr<GlyphAtlas>& getAtlas() const { return atlas; }
+    void uploadAtlas(gfx::UploadPass&);
+    const gfx::Texture& getAtlasTexture() const;
+
+    void dumpDebugLogs() const;
+
 private:
     Glyph generateLocalSDF(const FontStack& fontStack, GlyphID glyphID);
     std::string glyphURL;
@@ -72,6 +86,11 @@ private:
     GlyphManagerObserver* observer = nullptr;
     
     std::unique_ptr<LocalGlyphRasterizer> localGlyphRasterizer;
+
+    std::shared_ptr<GlyphAtlas> atlas;
+    // Owned here rather than by the atlas, which may be kept alive by workers
+    // and must not release GPU resources off the render thread.
+    optional<gfx::Texture> atlasTexture;
 };
 
 } // namespace mbgl
@@ -1,5 +1,6 @@
 #include <mbgl/text/placement.hpp>
 
+#include <mbgl/actor/scheduler.hpp>
 #include <mbgl/layout/symbol_layout.hpp>
 #include <mbgl/renderer/render_layer.hpp>
 #include <mbgl/renderer/render_tile.hpp>
@@ -7,6 +8,7 @@
 #include <mbgl/renderer/buckets/symbol_bucket.hpp>
 #include <mbgl/renderer/bucket.hpp>
 #include <mbgl/util/math.hpp>
+#include <algorithm>
 #include <utility>
 
 namespace mbgl {
@@ -60,6 +62,22 @@ const CollisionGroups::CollisionGroup& CollisionGroups::get(const std::string& s
 
 // PlacementController implemenation
 
+LayerPlacementSnapshot::LayerPlacementSnapshot(const RenderLayer& layer)
+    : layerID(layer.getID()), sourceID(layer.baseImpl->source) {
+    const auto& placementData = layer.getPlacementData();
+    items.reserve(placementData.size());
+    for (const auto& item : placementData) {
+        const RenderTile& renderTile = item.tile;
+        const LayerRenderData* renderData = renderTile.getLayerRenderData(*layer.baseImpl);
+        assert(renderData && renderData->bucket.get() == &item.bucket.get());
+        items.push_back({renderData->bucket,
+                         renderTile.id,
+                         renderTile.getOverscaledTileID(),
+                         renderTile.holdForFade(),
+                         item.featureIndex});
+    }
+}
+
 PlacementController::PlacementController()
     : placement(makeMutable<Placement>(TransformState{}, MapMode::Static, style::TransitionOptions{}, true, nullopt)) {}
 
@@ -109,15 +127,58 @@ Placement::Placement(const TransformState& state_,
 
 void Placement::placeLayer(const RenderLayer& layer, const mat4& projMatrix, bool showCollisionBoxes) {
     std::set<uint32_t> seenCrossTileIDs;
-    for (const auto& item : layer.getPlacementData()) {
+    std::unordered_set<uint32_t> placedBuckets;
+    placeLayer(layer, projMatrix, showCollisionBoxes, seenCrossTileIDs, placedBuckets, [] { return false; });
+}
+
+std::size_t Placement::placeLayer(const RenderLayer& layer,
+                                  const mat4& projMatrix,
+                                  bool showCollisionBoxes,
+                                  std::set<uint32_t>& seenCrossTileIDs,
+                                  std::unordered_set<uint32_t>& placedBuckets,
+                                  const std::function<bool()>& shouldPause) {
+    const auto& placementData = layer.getPlacementData();
+    bool paused = false;
+    std::size_t remainingBuckets = 0;
+    for (const auto& item : placementData) {
         Bucket& bucket = item.bucket;
+        const uint32_t bucketInstanceId = bucket.getBucketInstanceId();
+        if (placedBuckets.count(bucketInstanceId)) {
+            continue;
+        }
+        if (paused) {
+            ++remainingBuckets;
+            continue;
+        }
+
+        const RenderTile& renderTile = item.tile;
         BucketPlacementParameters params{
-                item.tile,
+                renderTile.id,
+                renderTile.getOverscaledTileID(),
+                renderTile.holdForFade(),
                 projMatrix,
                 layer.baseImpl->source,
                 item.featureIndex,
                 showCollisionBoxes};
         bucket.place(*this, params, seenCrossTileIDs);
+        placedBuckets.insert(bucketInstanceId);
+        paused = shouldPause();
+    }
+    return remainingBuckets;
+}
+
+void Placement::placeLayer(const LayerPlacementSnapshot& layer, const mat4& projMatrix, bool showCollisionBoxes) {
+    std::set<uint32_t> seenCrossTileIDs;
+    for (const auto& item : layer.items) {
+        BucketPlacementParameters params{
+                item.tileID,
+                item.overscaledTileID,
+                item.holdForFade,
+                projMatrix,
+                layer.sourceID,
+                item.featureIndex,
+                showCollisionBoxes};
+        item.bucket->place(*this, params, seenCrossTileIDs);
     }
 }
 
@@ -137,15 +198,14 @@ void Placement::placeBucket(
         const BucketPlacementParameters& params,
         std::set<uint32_t>& seenCrossTileIDs) {
     const auto& layout = *bucket.layout;
-    const auto& renderTile = params.tile;
     const auto& state = collisionIndex.getTransformState();
-    const float pixelsToTileUnits = renderTile.id.pixelsToTileUnits(1, state.getZoom());
-    const OverscaledTileID& overscaledID = renderTile.getOverscaledTileID();
+    const float pixelsToTileUnits = params.tileID.pixelsToTileUnits(1, state.getZoom());
+    const OverscaledTileID& overscaledID = params.overscaledTileID;
     const float scale = std::pow(2, state.getZoom() - overscaledID.overscaledZ);
     const float pixelRatio = (util::tileSize * overscaledID.overscaleFactor()) / util::EXTENT;
 
     mat4 posMatrix;
-    state.matrixFor(posMatrix, renderTile.id);
+    state.matrixFor(posMatrix, params.tileID);
     matrix::multiply(posMatrix, params.projMatrix, posMatrix);
 
     mat4 textLabelPlaneMatrix = getLabelPlaneMatrix(posMatrix,
@@ -201,7 +261,7 @@ void Placement::placeBucket(
     auto placeSymbol = [&] (const SymbolInstance& symbolInstance) {
         if (seenCrossTileIDs.count(symbolInstance.crossTileID) != 0u) return;
 
-        if (renderTile.holdForFade()) {
+        if (params.holdForFade) {
             // Mark all symbols from this tile as "not placed", but don't add to seenCrossTileIDs, because we don't
             // know yet if we have a duplicate in a parent tile that _should_ be placed.
             placements.emplace(symbolInstance.crossTileID, JointPlacement(false, false, false));
@@ -1085,4 +1145,89 @@ const RetainedQueryData& Placement::getQueryData(uint32_t bucketInstanceId) cons
     return it->second;
 }
 
+// PauseablePlacement implementation
+
+PauseablePlacement::PauseablePlacement(Mutable<Placement> placement_, const mat4& projMatrix_, bool showCollisionBoxes_)
+    : placement(std::move(placement_)),
+      projMatrix(projMatrix_),
+      showCollisionBoxes(showCollisionBoxes_) {}
+
+bool PauseablePlacement::continuePlacement(const std::vector<std::reference_wrapper<const RenderLayer>>& layers,
+                                           const std::function<bool()>& shouldPause) {
+    bool paused = false;
+    remainingBuckets = 0;
+
+    for (const RenderLayer& layer : layers) {
+        LayerProgress& progress = layerProgress[layer.getID()];
+        const auto isPlaced = [&](const LayerPlacementData& item) {
+            return progress.placedBuckets.count(item.bucket.get().getBucketInstanceId()) != 0;
+        };
+
+        // Buckets of tiles that were added since the layer was placed are
+        // placed as well, while those of removed tiles are simply not seen.
+        const auto& placementData = layer.getPlacementData();
+        if (std::all_of(placementData.begin(), placementData.end(), isPlaced)) {
+            continue;
+        }
+
+        if (paused) {
+            remainingBuckets += static_cast<std::size_t>(std::count_if(
+                placementData.begin(), placementData.end(), [&](const LayerPlacementData& item) { return !isPlaced(item); }));
+            continue;
+        }
+
+        const std::size_t remaining = placement->placeLayer(
+            layer, projMatrix, showCollisionBoxes, progress.seenCrossTileIDs, progress.placedBuckets, shouldPause);
+        if (remaining) {
+            paused = true;
+            remainingBuckets += remaining;
+        } else {
+            // Pause between layers too, unless this was the last one.
+            paused = shouldPause();
+        }
+    }
+
+    return remainingBuckets == 0;
+}
+
+// BackgroundPlacement implementation
+
+BackgroundPlacement::BackgroundPlacement(Mutable<Placement> placement_,
+                                         std::vector<LayerPlacementSnapshot> layers_,
+                                         const mat4& projMatrix_,
+                                         bool showCollisionBoxes_)
+    : scheduler(Scheduler::GetBackground()),
+      placement(std::move(placement_)),
+      layers(std::move(layers_)),
+      projMatrix(projMatrix_),
+      showCollisionBoxes(showCollisionBoxes_) {
+    auto promise = std::make_shared<std::promise<void>>();
+    result = promise->get_future();
+    scheduler->schedule([this, promise] {
+        try {
+            for (const auto& layer : layers) {
+                placement->placeLayer(layer, projMatrix, showCollisionBoxes);
+            }
+            promise->set_value();
+        } catch (...) {
+            promise->set_exception(std::current_exception());
+        }
+    });
+}
+
+BackgroundPlacement::~BackgroundPlacement() {
+    if (result.valid()) {
+        result.wait();
+    }
+}
+
+bool BackgroundPlacement::isDone() const {
+    return result.wait_for(Duration::zero()) == std::future_status::ready;
+}
+
+Mutable<Placement> BackgroundPlacement::finish() {
+    result.get();
+    return std::move(placement);
+}
+
 } // namespace mbgl
@@ -6,10 +6,13 @@
 #include <mbgl/text/collision_index.hpp>
 #include <mbgl/layout/symbol_projection.hpp>
 #include <mbgl/style/transition_options.hpp>
+#include <future>
 #include <unordered_set>
 
 namespace mbgl {
 
+class Bucket;
+class Scheduler;
 class SymbolBucket;
 class SymbolInstance;
 enum class PlacedSymbolOrientation : bool;
@@ -87,13 +90,36 @@ private:
 
 class BucketPlacementParameters {
 public:
-    const RenderTile& tile;
+    UnwrappedTileID tileID;
+    OverscaledTileID overscaledTileID;
+    bool holdForFade;
     const mat4& projMatrix;
     std::string sourceId;
     std::shared_ptr<FeatureIndex> featureIndex;
     bool showCollisionBoxes;
 };
 
+// The inputs of the placement of a symbol layer, copied from the render layer
+// and its tiles so that the placement can be computed off the render thread.
+// The buckets are retained by the snapshot, which must therefore be destroyed
+// on the render thread.
+class LayerPlacementSnapshot {
+public:
+    explicit LayerPlacementSnapshot(const RenderLayer&);
+
+    struct Item {
+        std::shared_ptr<Bucket> bucket;
+        UnwrappedTileID tileID;
+        OverscaledTileID overscaledTileID;
+        bool holdForFade;
+        std::shared_ptr<FeatureIndex> featureIndex;
+    };
+
+    std::string layerID;
+    std::string sourceID;
+    std::vector<Item> items;
+};
+
 class Placement;
 
 class PlacementController {
@@ -118,6 +144,17 @@ public:
               const bool crossSourceCollisions,
               optional<Immutable<Placement>> prevPlacement = nullopt);
     void placeLayer(const RenderLayer&, const mat4&, bool showCollisionBoxes);
+    // Places the buckets of the layer whose instance ids aren't in
+    // `placedBuckets` and adds their ids to it, until all of them are placed or
+    // `shouldPause` returns true after placing a bucket. Returns the number of
+    // buckets of the layer that aren't placed.
+    std::size_t placeLayer(const RenderLayer&,
+                           const mat4&,
+                           bool showCollisionBoxes,
+                           std::set<uint32_t>& seenCrossTileIDs,
+                           std::unordered_set<uint32_t>& placedBuckets,
+                           const std::function<bool()>& shouldPause);
+    void placeLayer(const LayerPlacementSnapshot&, const mat4&, bool showCollisionBoxes);
     void commit(TimePoint, const double zoom);
     void updateLayerBuckets(const RenderLayer&, const TransformState&, bool updateOpacities) const;
     float symbolFadeChange(TimePoint now) const;
@@ -167,4 +204,64 @@ private:
     std::unordered_map<const CollisionFeature*, std::vector<ProjectedCollisionBox>> collisionCircles;
 };
 
+// Runs a placement over several frames. Each call to continuePlacement()
+// places layers bucket by bucket until it is asked to pause, and the next call
+// resumes with the buckets that weren't placed yet. The placement must only
+// be committed once it is done.
+class PauseablePlacement {
+public:
+    PauseablePlacement(Mutable<Placement>, const mat4& projMatrix, bool showCollisionBoxes);
+
+    // Places the given layers in order, skipping the buckets that are already
+    // placed, and returns true once all of them are placed. Layers are
+    // identified by their ID and buckets by their instance id, so the layers
+    // and their tiles may change between calls.
+    bool continuePlacement(const std::vector<std::reference_wrapper<const RenderLayer>>&,
+                           const std::function<bool()>& shouldPause);
+
+    // Number of buckets of the given layers that were not placed by the last
+    // call to continuePlacement().
+    std::size_t getRemainingBuckets() const { return remainingBuckets; }
+
+    Mutable<Placement> finish() { return std::move(placement); }
+
+private:
+    Mutable<Placement> placement;
+    const mat4 projMatrix;
+    const bool showCollisionBoxes;
+
+    struct LayerProgress {
+        std::unordered_set<uint32_t> placedBuckets;
+        std::set<uint32_t> seenCrossTileIDs;
+    };
+    std::unordered_map<std::string, LayerProgress> layerProgress;
+    std::size_t remainingBuckets = 0;
+};
+
+// Computes a placement of layer snapshots on the background scheduler. The
+// placement is only accessed on the calling thread once isDone() returns true.
+// Destroying an unfinished BackgroundPlacement waits for the worker to finish.
+class BackgroundPlacement {
+public:
+    BackgroundPlacement(Mutable<Placement>,
+                        std::vector<LayerPlacementSnapshot>,
+                        const mat4& projMatrix,
+                        bool showCollisionBoxes);
+    ~BackgroundPlacement();
+
+    bool isDone() const;
+    const std::vector<LayerPlacementSnapshot>& getLayers() const { return layers; }
+
+    // Returns the placement once it is done, rethrowing any error raised on the worker.
+    Mutable<Placement> finish();
+
+private:
+    std::shared_ptr<Scheduler> scheduler;
+    Mutable<Placement> placement;
+    const std::vector<LayerPlacementSnapshot> layers;
+    const mat4 projMatrix;
+    const bool showCollisionBoxes;
+    std::future<void> result;
+};
+
 } // namespace mbgl
@@ -23,6 +23,8 @@
 
 #include <mbgl/gfx/upload_pass.hpp>
 
+#include <unordered_set>
+
 namespace mbgl {
 
 LayerRenderData* GeometryTile::LayoutResult::getLayerRenderData(const style::Layer::Impl& layerImpl) {
@@ -42,9 +44,13 @@ class GeometryTileRenderData final : public TileRenderData {
 public:
     GeometryTileRenderData(
         std::shared_ptr<GeometryTile::LayoutResult> layoutResult_,
-        std::shared_ptr<TileAtlasTextures> atlasTextures_)
+        std::shared_ptr<TileAtlasTextures> atlasTextures_,
+        GlyphManager& glyphManager_,
+        ImageManager& imageManager_)
         : TileRenderData(std::move(atlasTextures_))
-        , layoutResult(std::move(layoutResult_)) {
+        , layoutResult(std::move(layoutResult_))
+        , glyphManager(glyphManager_)
+        , imageManager(imageManager_) {
     }
 
 private:
@@ -56,6 +62,9 @@ private:
     void prepare(const SourcePrepareParameters&) override;
 
     std::shared_ptr<GeometryTile::LayoutResult> layoutResult;
+    GlyphManager& glyphManager;
+    ImageManager& imageManager;
+    // Updated images to patch into the tile's own image atlas texture.
     std::vector<ImagePatch> imagePatches;
 };
 
@@ -87,27 +96,52 @@ void GeometryTileRenderData::upload(gfx::UploadPass& uploadPass) {
 
     assert(atlasTextures);
 
-    if (layoutResult->glyphAtlasImage) {
-        atlasTextures->glyph = uploadPass.createTexture(*layoutResult->glyphAtlasImage);
-        layoutResult->glyphAtlasImage = {};
-    }
-
-    if (layoutResult->iconAtlas.image.valid()) {
-        atlasTextures->icon = uploadPass.createTexture(layoutResult->iconAtlas.image);
-        layoutResult->iconAtlas.image = {};
+    // The glyph and image atlases are shared by all tiles, and only patched
+    // with the regions changed since the previous upload. Glyphs that didn't
+    // fit into the shared atlas get a texture of the tile's own, and so do images.
+    GlyphAtlasReference& glyphAtlas = layoutResult->glyphAtlasReference;
+    if (glyphAtlas.hasOwnImage()) {
+        if (optional<AlphaImage> image = glyphAtlas.takeOwnImage()) {
+            atlasTextures->ownGlyph = uploadPass.createTexture(*image);
+        }
+        assert(atlasTextures->ownGlyph);
+        atlasTextures->glyph = &*atlasTextures->ownGlyph;
+    } else {
+        glyphManager.uploadAtlas(uploadPass);
+        atlasTextures->glyph = &glyphManager.getAtlasTexture();
+        atlasTextures->ownGlyph = nullopt;
     }
 
-    if (atlasTextures->icon && !imagePatches.empty()) {
-        for (const auto& imagePatch : imagePatches) { // patch updated images.
-            uploadPass.updateTextureSub(*atlasTextures->icon, imagePatch.image->image, imagePatch.textureRect.x, imagePatch.textureRect.y);
+    ImageAtlasReference& iconAtlas = layoutResult->iconAtlas.reference;
+    if (iconAtlas.hasOwnImage()) {
+        if (optional<PremultipliedImage> image = iconAtlas.takeOwnImage()) {
+            atlasTextures->ownIcon = uploadPass.createTexture(*image);
+        }
+        assert(atlasTextures->ownIcon);
+        for (const auto& imagePatch : imagePatches) {
+            uploadPass.updateTextureSub(*atlasTextures->ownIcon, imagePatch.image->image, imagePatch.textureRect.x, imagePatch.textureRect.y);
         }
         imagePatches.clear();
+        atlasTextures->icon = &*atlasTextures->ownIcon;
+    } else {
+        imageManager.uploadAtlas(uploadPass);
+        atlasTextures->icon = &imageManager.getAtlasTexture();
+        atlasTextures->ownIcon = nullopt;
     }
 }
 
 void GeometryTileRenderData::prepare(const SourcePrepareParameters& parameters) {
     if (!layoutResult) return;
-    imagePatches = layoutResult->iconAtlas.getImagePatchesAndUpdateVersions(parameters.imageManager);
+    auto patches = layoutResult->iconAtlas.getImagePatchesAndUpdateVersions(parameters.imageManager);
+    if (layoutResult->iconAtlas.reference.hasOwnImage()) {
+        imagePatches = std::move(patches);
+        return;
+    }
+    // Updated images are written to the shared atlas once, for whichever tile
+    // notices the new version first.
+    for (const auto& imagePatch : patches) {
+        imageManager.getAtlas()->updateImage(*imagePatch.image, imagePatch.version);
+    }
 }
 
 Bucket* GeometryTileRenderData::getBucket(const Layer::Impl& layer) const {
@@ -148,9 +182,12 @@ GeometryTile::GeometryTile(const OverscaledTileID& id_,
              id_,
              sourceID,
              obsolete,
+             parameters.glyphManager.getAtlas(),
+             parameters.imageManager.getAtlas(),
              parameters.mode,
              parameters.pixelRatio,
-             parameters.debugOptions & MapDebugOptions::Collision),
+             parameters.debugOptions & MapDebugOptions::Collision,
+             parameters.parallelTileParsing),
       fileSource(parameters.fileSource),
       glyphManager(parameters.glyphManager),
       imageManager(parameters.imageManager),
@@ -196,7 +233,7 @@ void GeometryTile::reset() {
 }
 
 std::unique_ptr<TileRenderData> GeometryTile::createRenderData() {
-    return std::make_unique<GeometryTileRenderData>(layoutResult, atlasTextures);
+    return std::make_unique<GeometryTileRenderData>(layoutResult, atlasTextures, glyphManager, imageManager);
 }
 
 void GeometryTile::setLayers(const std::vector<Immutable<LayerProperties>>& layers) {
@@ -234,6 +271,38 @@ void GeometryTile::setShowCollisionBoxes(const bool showCollisionBoxes_) {
     }
 }
 
+void GeometryTile::setPriority(double priority) {
+    worker.setPriority(priority);
+}
+
+std::size_t GeometryTile::getMemoryUsage() const {
+    std::size_t bytes = 0;
+    if (layoutResult) {
+        // Layers of the same layout group share a bucket.
+        std::unordered_set<const Bucket*> buckets;
+        for (const auto& entry : layoutResult->layerRenderData) {
+            const Bucket* bucket = entry.second.bucket.get();
+            if (bucket && buckets.insert(bucket).second) {
+                bytes += bucket->getMemoryUsage();
+            }
+        }
+        if (layoutResult->featureIndex) {
+            bytes += layoutResult->featureIndex->getMemoryUsage();
+        }
+        // Glyphs and images that didn't fit into the shared atlases, before
+        // and after upload.
+        bytes += layoutResult->glyphAtlasReference.getMemoryUsage();
+        bytes += layoutResult->iconAtlas.reference.getMemoryUsage();
+    }
+    if (atlasTextures && atlasTextures->ownGlyph) {
+        bytes += atlasTextures->ownGlyph->size.area();
+    }
+    if (atlasTextures && atlasTextures->ownIcon) {
+        bytes += atlasTextures->ownIcon->size.area() * 4;
+    }
+    return bytes;
+}
+
 void GeometryTile::onLayout(std::shared_ptr<LayoutResult> result, const uint64_t resultCorrelationID) {
     loaded = true;
     renderable = true;
@@ -241,6 +310,25 @@ void GeometryTile::onLayout(std::shared_ptr<LayoutResult> result, const uint64_t
         pending = false;
     }
 
+    // Layer groups the worker didn't have to rebuild keep their bucket from
+    // the previous result. Entries whose bucket had no data are dropped.
+    auto& layerRenderData = result->layerRenderData;
+    for (auto it = layerRenderData.begin(); it != layerRenderData.end();) {
+        if (it->second.bucket) {
+            ++it;
+            continue;
+        }
+        if (layoutResult) {
+            auto previous = layoutResult->layerRenderData.find(it->first);
+            if (previous != layoutResult->layerRenderData.end()) {
+                it->second.bucket = previous->second.bucket;
+                ++it;
+                continue;
+            }
+        }
+        it = layerRenderData.erase(it);
+    }
+
     layoutResult = std::move(result);
     if (!atlasTextures) {
     	atlasTextures = std::make_shared<TileAtlasTextures>();
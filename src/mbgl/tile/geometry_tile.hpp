@@ -21,7 +21,6 @@ class GeometryTileData;
 class RenderLayer;
 class SourceQueryOptions;
 class TileParameters;
-class GlyphAtlas;
 class ImageAtlas;
 class TileAtlasTextures;
 
@@ -42,6 +41,8 @@ public:
     std::unique_ptr<TileRenderData> createRenderData() override;
     void setLayers(const std::vector<Immutable<style::LayerProperties>>&) override;
     void setShowCollisionBoxes(const bool showCollisionBoxes) override;
+    void setPriority(double) override;
+    std::size_t getMemoryUsage() const override;
 
     void onGlyphsAvailable(GlyphMap) override;
     void onImagesAvailable(ImageMap, ImageMap, ImageVersionMap versionMap, uint64_t imageCorrelationID) override;
@@ -67,20 +68,23 @@ public:
 
     class LayoutResult {
     public:
+        // Entries sent by the worker without a bucket refer to the bucket of
+        // the same layer in the previous result; see onLayout().
         std::unordered_map<std::string, LayerRenderData> layerRenderData;
         std::shared_ptr<FeatureIndex> featureIndex;
-        optional<AlphaImage> glyphAtlasImage;
+        // Keeps the glyphs used by the symbol buckets in the shared glyph atlas.
+        GlyphAtlasReference glyphAtlasReference;
         ImageAtlas iconAtlas;
 
         LayerRenderData* getLayerRenderData(const style::Layer::Impl&);
 
         LayoutResult(std::unordered_map<std::string, LayerRenderData> renderData_,
                      std::unique_ptr<FeatureIndex> featureIndex_,
-                     optional<AlphaImage> glyphAtlasImage_,
+                     GlyphAtlasReference glyphAtlasReference_,
                      ImageAtlas iconAtlas_)
             : layerRenderData(std::move(renderData_)),
               featureIndex(std::move(featureIndex_)),
-              glyphAtlasImage(std::move(glyphAtlasImage_)),
+              glyphAtlasReference(std::move(glyphAtlasReference_)),
               iconAtlas(std::move(iconAtlas_)) {}
     };
     void onLayout(std::shared_ptr<LayoutResult>, uint64_t correlationID);
@@ -1,8 +1,13 @@
 #include <mbgl/tile/geometry_tile_data.hpp>
 #include <mbgl/tile/tile_id.hpp>
+#include <mbgl/util/monotonic_arena.hpp>
 
 #include <mapbox/geometry/wagyu/wagyu.hpp>
 
+#include <algorithm>
+#include <mutex>
+#include <unordered_map>
+
 namespace mbgl {
 
 static double signedArea(const GeometryCoordinates& ring) {
@@ -180,6 +185,54 @@ Feature convertFeature(const GeometryTileFeature& geometryTileFeature, const Can
     return feature;
 }
 
+namespace {
+
+struct PropertyKeyRegistry {
+    std::mutex mutex;
+    std::unordered_map<std::string, uint32_t> indices;
+};
+
+PropertyKeyRegistry& propertyKeyRegistry() {
+    static PropertyKeyRegistry registry;
+    return registry;
+}
+
+} // namespace
+
+constexpr uint32_t FeaturePropertyKey::noIndex;
+
+FeaturePropertyKey::FeaturePropertyKey(std::string name_) : name(std::move(name_)) {
+    auto& registry = propertyKeyRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    index = registry.indices.emplace(name, static_cast<uint32_t>(registry.indices.size())).first->second;
+}
+
+FeaturePropertyKey::Resolution::Resolution(const std::vector<std::string>& names) {
+    auto& registry = propertyKeyRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    keyCount = static_cast<uint32_t>(registry.indices.size());
+    for (std::size_t i = 0; i < names.size(); ++i) {
+        auto it = registry.indices.find(names[i]);
+        if (it != registry.indices.end()) {
+            positions.emplace_back(it->second, static_cast<uint32_t>(i));
+        }
+    }
+    std::sort(positions.begin(), positions.end());
+    positions.shrink_to_fit();
+}
+
+optional<uint32_t> FeaturePropertyKey::Resolution::find(const FeaturePropertyKey& key) const {
+    if (key.index >= keyCount) {
+        return nullopt;
+    }
+    auto it = std::lower_bound(positions.begin(), positions.end(), std::make_pair(key.index, uint32_t(0)));
+    return it != positions.end() && it->first == key.index ? it->second : noIndex;
+}
+
+std::size_t FeaturePropertyKey::Resolution::getMemoryUsage() const {
+    return positions.capacity() * sizeof(std::pair<uint32_t, uint32_t>);
+}
+
 const PropertyMap& GeometryTileFeature::getProperties() const {
     static const PropertyMap dummy;
     return dummy;
@@ -190,4 +243,8 @@ const GeometryCollection& GeometryTileFeature::getGeometries() const {
     return dummy;
 }
 
+const GeometryTileFeature* GeometryTileLayer::getTemporaryFeature(std::size_t i, util::MonotonicArena& arena) const {
+    return arena.make<std::unique_ptr<GeometryTileFeature>>(getFeature(i))->get();
+}
+
 } // namespace mbgl
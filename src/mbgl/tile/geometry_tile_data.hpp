@@ -5,6 +5,7 @@
 #include <mbgl/util/optional.hpp>
 
 #include <cstdint>
+#include <limits>
 #include <string>
 #include <vector>
 #include <memory>
@@ -13,6 +14,10 @@ namespace mbgl {
 
 class CanonicalTileID;
 
+namespace util {
+class MonotonicArena;
+} // namespace util
+
 // Normalized vector tile coordinates.
 // Each geometry coordinate represents a point in a bidimensional space,
 // varying from -V...0...+V, where V is the maximum extent applicable.
@@ -42,11 +47,45 @@ private:
     GeometryCollection(const GeometryCollection&) = default;
 };
 
+// A feature property name that is registered once in a process-wide key table,
+// so that features with a columnar key table can look it up by index instead of
+// comparing strings.
+class FeaturePropertyKey {
+public:
+    explicit FeaturePropertyKey(std::string name);
+
+    static constexpr uint32_t noIndex = std::numeric_limits<uint32_t>::max();
+
+    // The positions of the registered keys within a list of names, such as the
+    // key table of a vector tile layer. Only the keys that occur in the list
+    // are held, so the size doesn't depend on how many keys were registered.
+    class Resolution {
+    public:
+        Resolution() = default;
+        explicit Resolution(const std::vector<std::string>& names);
+
+        // Returns the position of the key's name, `noIndex` if the list doesn't
+        // contain it, or nullopt if the key was registered afterwards.
+        optional<uint32_t> find(const FeaturePropertyKey&) const;
+
+        std::size_t getMemoryUsage() const;
+
+    private:
+        // Pairs of a key index and the position of its name, sorted by key index.
+        std::vector<std::pair<uint32_t, uint32_t>> positions;
+        uint32_t keyCount = 0;
+    };
+
+    std::string name;
+    uint32_t index;
+};
+
 class GeometryTileFeature {
 public:
     virtual ~GeometryTileFeature() = default;
     virtual FeatureType getType() const = 0;
     virtual optional<Value> getValue(const std::string& key) const = 0;
+    virtual optional<Value> getPropertyValue(const FeaturePropertyKey& key) const { return getValue(key.name); }
     virtual const PropertyMap& getProperties() const;
     virtual FeatureIdentifier getID() const { return NullValue {}; }
     virtual const GeometryCollection& getGeometries() const;
@@ -61,6 +100,11 @@ public:
     // object may *not* outlive the layer object.
     virtual std::unique_ptr<GeometryTileFeature> getFeature(std::size_t) const = 0;
 
+    // Same as getFeature(), for a feature that is only needed until the arena is
+    // reset. Layers whose features are views of decoded data override this to
+    // create them in the arena rather than with one heap allocation each.
+    virtual const GeometryTileFeature* getTemporaryFeature(std::size_t, util::MonotonicArena&) const;
+
     virtual std::string getName() const = 0;
 };
 
@@ -72,6 +116,10 @@ public:
     // Returns the layer with the given name. The returned layer object *may* outlive the data
     // object.
     virtual std::unique_ptr<GeometryTileLayer> getLayer(const std::string&) const = 0;
+
+    // Approximate number of bytes held by the data, including anything
+    // decoded from it so far.
+    virtual std::size_t getMemoryUsage() const { return 0; }
 };
 
 // classifies an array of rings into polygons with outer rings and holes
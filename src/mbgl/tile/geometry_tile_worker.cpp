@@ -1,6 +1,7 @@
 #include <mbgl/tile/geometry_tile_worker.hpp>
 #include <mbgl/tile/geometry_tile_data.hpp>
 #include <mbgl/tile/geometry_tile.hpp>
+#include <mbgl/actor/scheduler.hpp>
 #include <mbgl/layermanager/layer_manager.hpp>
 #include <mbgl/layout/layout.hpp>
 #include <mbgl/layout/symbol_layout.hpp>
@@ -9,15 +10,18 @@
 #include <mbgl/renderer/group_by_layout.hpp>
 #include <mbgl/style/filter.hpp>
 #include <mbgl/style/layers/symbol_layer_impl.hpp>
+#include <mbgl/text/glyph_atlas.hpp>
 #include <mbgl/renderer/layers/render_fill_layer.hpp>
 #include <mbgl/renderer/layers/render_fill_extrusion_layer.hpp>
 #include <mbgl/renderer/layers/render_line_layer.hpp>
 #include <mbgl/renderer/layers/render_symbol_layer.hpp>
 #include <mbgl/renderer/buckets/symbol_bucket.hpp>
 #include <mbgl/util/logging.hpp>
+#include <mbgl/util/monotonic_arena.hpp>
 #include <mbgl/util/constants.hpp>
 #include <mbgl/util/string.hpp>
 #include <mbgl/util/exception.hpp>
+#include <mbgl/util/parallel_for.hpp>
 #include <mbgl/util/stopwatch.hpp>
 
 #include <unordered_set>
@@ -32,16 +36,22 @@ GeometryTileWorker::GeometryTileWorker(ActorRef<GeometryTileWorker> self_,
                                        OverscaledTileID id_,
                                        std::string sourceID_,
                                        const std::atomic<bool>& obsolete_,
+                                       std::shared_ptr<GlyphAtlas> glyphAtlas_,
+                                       std::shared_ptr<SharedImageAtlas> imageAtlas_,
                                        const MapMode mode_,
                                        const float pixelRatio_,
-                                       const bool showCollisionBoxes_)
+                                       const bool showCollisionBoxes_,
+                                       const bool parallelParsing_)
     : self(std::move(self_)),
       parent(std::move(parent_)),
       id(id_),
       sourceID(std::move(sourceID_)),
       obsolete(obsolete_),
+      glyphAtlas(std::move(glyphAtlas_)),
+      imageAtlas(std::move(imageAtlas_)),
       mode(mode_),
       pixelRatio(pixelRatio_),
+      parallelParsing(parallelParsing_),
       showCollisionBoxes(showCollisionBoxes_) {}
 
 GeometryTileWorker::~GeometryTileWorker() = default;
@@ -122,6 +132,7 @@ void GeometryTileWorker::setData(std::unique_ptr<const GeometryTileData> data_,
     try {
         data = std::move(data_);
         correlationID = correlationID_;
+        parsedGroups.clear();
         availableImages = std::move(availableImages_);
 
         switch (state) {
@@ -172,6 +183,7 @@ void GeometryTileWorker::reset(uint64_t correlationID_) {
     layers = nullopt;
     data = nullopt;
     correlationID = correlationID_;
+    parsedGroups.clear();
 
     switch (state) {
         case Idle:
@@ -333,6 +345,51 @@ void GeometryTileWorker::requestNewImages(const ImageDependencies& imageDependen
     }
 }
 
+namespace {
+
+// The outcome of filtering and laying out the features of one layout group.
+// Groups don't depend on each other, so they can be processed concurrently;
+// everything that touches state shared by the whole tile (feature index,
+// render data, symbol dependencies) is applied afterwards, in group order.
+struct LayerGroupResult {
+    // Whether the bucket built by the previous parse can be kept.
+    bool reused = false;
+    std::unique_ptr<GeometryTileLayer> geometryLayer;
+    std::unique_ptr<Layout> layout;
+    std::shared_ptr<Bucket> bucket;
+    // Owns the features read while parsing the group, which are only needed
+    // until the group is added to the feature index. Each group has its own,
+    // as groups may be parsed in parallel.
+    util::MonotonicArena arena;
+    std::vector<std::pair<std::size_t, const GeometryTileFeature*>> indexedFeatures;
+    GlyphDependencies glyphDependencies;
+    ImageDependencies imageDependencies;
+};
+
+// A group can keep its bucket if it consists of the same layers, in the same
+// order, and none of them changed in a way that affects the bucket contents.
+bool isSameLayerGroup(const std::vector<Immutable<style::LayerProperties>>& before,
+                      const std::vector<Immutable<style::LayerProperties>>& after) {
+    if (before.size() != after.size()) {
+        return false;
+    }
+    for (std::size_t i = 0; i < before.size(); ++i) {
+        const style::LayerProperties& previous = *before[i];
+        const style::LayerProperties& current = *after[i];
+        if (previous.baseImpl->id != current.baseImpl->id ||
+            previous.baseImpl->getTypeInfo() != current.baseImpl->getTypeInfo() ||
+            previous.constantsMask() != current.constantsMask()) {
+            return false;
+        }
+        if (previous.baseImpl != current.baseImpl && previous.baseImpl->hasLayoutDifference(*current.baseImpl)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
 void GeometryTileWorker::parse() {
     if (!data || !layers) {
         return;
@@ -340,10 +397,9 @@ void GeometryTileWorker::parse() {
 
     MBGL_TIMING_START(watch)
 
-    std::unordered_map<std::string, std::unique_ptr<SymbolLayout>> symbolLayoutMap;
-
     renderData.clear();
     layouts.clear();
+    pendingGroups.clear();
 
     featureIndex = std::make_unique<FeatureIndex>(*data ? (*data)->clone() : nullptr);
 
@@ -351,71 +407,162 @@ void GeometryTileWorker::parse() {
     ImageDependencies imageDependencies;
 
     // Create render layers and group by layout
-    std::unordered_map<std::string, std::vector<Immutable<style::LayerProperties>>> groupMap;
+    LayerGroups groupMap;
     for (auto layer : *layers) {
         groupMap[layoutKey(*layer->baseImpl)].push_back(std::move(layer));
     }
 
-    for (auto& pair : groupMap) {
-        const auto& group = pair.second;
-        if (obsolete) {
-            return;
+    std::vector<const LayerGroups::value_type*> groups;
+    std::vector<LayerGroupResult> results;
+    if (*data) { // Tile has data.
+        groups.reserve(groupMap.size());
+        results.resize(groupMap.size());
+        for (const auto& pair : groupMap) {
+            LayerGroupResult& result = results[groups.size()];
+            // Source layers are looked up here rather than per group: tile data
+            // is parsed lazily on first access and must not be shared across threads.
+            result.geometryLayer = (*data)->getLayer(pair.second.at(0)->baseImpl->sourceLayer);
+
+            auto parsed = parsedGroups.find(pair.first);
+            result.reused = result.geometryLayer && parsed != parsedGroups.end() &&
+                            isSameLayerGroup(parsed->second, pair.second);
+            groups.emplace_back(&pair);
         }
+    }
 
-        if (!*data) {
-            continue; // Tile has no data.
+    auto parseGroup = [&](std::size_t index) {
+        LayerGroupResult& result = results[index];
+        if (obsolete || !result.geometryLayer) {
+            return;
         }
 
+        const auto& group = groups[index]->second;
         const style::Layer::Impl& leaderImpl = *(group.at(0)->baseImpl);
-        BucketParameters parameters { id, mode, pixelRatio, leaderImpl.getTypeInfo() };
-
-        auto geometryLayer = (*data)->getLayer(leaderImpl.sourceLayer);
-        if (!geometryLayer) {
-            continue;
-        }
 
-        std::vector<std::string> layerIDs(group.size());
-        for (const auto& layer : group) {
-            layerIDs.push_back(layer->baseImpl->id);
+        if (result.reused) {
+            // The bucket is kept, but the feature index is rebuilt along with
+            // the rest of the tile. Filtering is cheap compared to building the
+            // bucket, and the source layer has already been decoded.
+            const Filter& filter = leaderImpl.filter;
+            const GeometryTileLayer& geometryLayer = *result.geometryLayer;
+            for (std::size_t i = 0; !obsolete && i < geometryLayer.featureCount(); i++) {
+                const GeometryTileFeature* feature = geometryLayer.getTemporaryFeature(i, result.arena);
+                if (filter(expression::EvaluationContext { static_cast<float>(this->id.overscaledZ), feature })) {
+                    result.indexedFeatures.emplace_back(i, feature);
+                }
+            }
+            return;
         }
 
-        featureIndex->setBucketLayerIDs(leaderImpl.id, layerIDs);
+        BucketParameters parameters { id, mode, pixelRatio, leaderImpl.getTypeInfo() };
 
         // Symbol layers and layers that support pattern properties have an extra step at layout time to figure out what images/glyphs
         // are needed to render the layer. They use the intermediate Layout data structure to accomplish this,
         // and either immediately create a bucket if no images/glyphs are used, or the Layout is stored until
         // the images/glyphs are available to add the features to the buckets.
         if (leaderImpl.getTypeInfo()->layout == LayerTypeInfo::Layout::Required) {
-            std::unique_ptr<Layout> layout = LayerManager::get()->createLayout(
-                {parameters, glyphDependencies, imageDependencies, availableImages}, std::move(geometryLayer), group);
-            if (layout->hasDependencies()) {
-                layouts.push_back(std::move(layout));
-            } else {
-                layout->createBucket({}, featureIndex, renderData, firstLoad, showCollisionBoxes);
-            }
+            result.layout = LayerManager::get()->createLayout(
+                {parameters, result.glyphDependencies, result.imageDependencies, availableImages},
+                std::move(result.geometryLayer), group);
         } else {
             const Filter& filter = leaderImpl.filter;
-            const std::string& sourceLayerID = leaderImpl.sourceLayer;
-            std::shared_ptr<Bucket> bucket = LayerManager::get()->createBucket(parameters, group);
+            const GeometryTileLayer& geometryLayer = *result.geometryLayer;
+            result.bucket = LayerManager::get()->createBucket(parameters, group);
 
-            for (std::size_t i = 0; !obsolete && i < geometryLayer->featureCount(); i++) {
-                std::unique_ptr<GeometryTileFeature> feature = geometryLayer->getFeature(i);
+            for (std::size_t i = 0; !obsolete && i < geometryLayer.featureCount(); i++) {
+                const GeometryTileFeature* feature = geometryLayer.getTemporaryFeature(i, result.arena);
 
-                if (!filter(expression::EvaluationContext { static_cast<float>(this->id.overscaledZ), feature.get() }))
+                if (!filter(expression::EvaluationContext { static_cast<float>(this->id.overscaledZ), feature }))
                     continue;
 
                 const GeometryCollection& geometries = feature->getGeometries();
-                bucket->addFeature(*feature, geometries, {}, PatternLayerMap(), i);
-                featureIndex->insert(geometries, i, sourceLayerID, leaderImpl.id);
+                result.bucket->addFeature(*feature, geometries, {}, PatternLayerMap(), i);
+                result.indexedFeatures.emplace_back(i, feature);
             }
+            // The features are kept alive by the group's arena.
+            result.bucket->finishFeatures();
+        }
+    };
 
-            if (!bucket->hasData()) {
-                continue;
+    auto applyGroup = [&](std::size_t index) {
+        LayerGroupResult& result = results[index];
+        if (!result.reused && !result.layout && !result.bucket) {
+            return; // Source layer not present in this tile.
+        }
+
+        const auto& key = groups[index]->first;
+        const auto& group = groups[index]->second;
+        const style::Layer::Impl& leaderImpl = *(group.at(0)->baseImpl);
+
+        std::vector<std::string> layerIDs(group.size());
+        for (const auto& layer : group) {
+            layerIDs.push_back(layer->baseImpl->id);
+        }
+
+        featureIndex->setBucketLayerIDs(leaderImpl.id, layerIDs);
+
+        if (result.reused) {
+            for (const auto& indexedFeature : result.indexedFeatures) {
+                featureIndex->insert(indexedFeature.second->getGeometries(), indexedFeature.first,
+                                     leaderImpl.sourceLayer, leaderImpl.id);
             }
+            result.indexedFeatures.clear();
 
+            // Buckets own GPU resources and must stay on the render thread, so
+            // the entries are sent without one and GeometryTile::onLayout takes
+            // the bucket from the previous layout result.
             for (const auto& layer : group) {
-                renderData.emplace(layer->baseImpl->id, LayerRenderData{bucket, layer});
+                renderData.emplace(layer->baseImpl->id, LayerRenderData{nullptr, layer});
+            }
+            pendingGroups.emplace(key, group);
+        } else if (result.layout) {
+            for (auto& dependency : result.glyphDependencies) {
+                glyphDependencies[dependency.first].insert(dependency.second.begin(), dependency.second.end());
+            }
+            imageDependencies.insert(result.imageDependencies.begin(), result.imageDependencies.end());
+
+            if (result.layout->hasDependencies()) {
+                layouts.push_back(std::move(result.layout));
+            } else {
+                result.layout->createBucket({}, featureIndex, renderData, firstLoad, showCollisionBoxes);
+                if (leaderImpl.getTypeInfo()->crossTileIndex == LayerTypeInfo::CrossTileIndex::NotRequired) {
+                    pendingGroups.emplace(key, group);
+                }
+            }
+        } else {
+            for (const auto& indexedFeature : result.indexedFeatures) {
+                featureIndex->insert(indexedFeature.second->getGeometries(), indexedFeature.first,
+                                     leaderImpl.sourceLayer, leaderImpl.id);
+            }
+            result.indexedFeatures.clear();
+            pendingGroups.emplace(key, group);
+
+            if (!result.bucket->hasData()) {
+                return;
+            }
+
+            for (const auto& layer : group) {
+                renderData.emplace(layer->baseImpl->id, LayerRenderData{result.bucket, layer});
+            }
+        }
+    };
+
+    if (parallelParsing) {
+        std::shared_ptr<Scheduler> scheduler = Scheduler::GetBackground();
+        util::parallelFor(*scheduler, results.size(), parseGroup);
+        for (std::size_t i = 0; i < results.size(); ++i) {
+            if (obsolete) {
+                return;
+            }
+            applyGroup(i);
+        }
+    } else {
+        for (std::size_t i = 0; i < results.size(); ++i) {
+            if (obsolete) {
+                return;
             }
+            parseGroup(i);
+            applyGroup(i);
         }
     }
 
@@ -449,18 +596,18 @@ void GeometryTileWorker::finalizeLayout() {
     }
     
     MBGL_TIMING_START(watch)
-    optional<AlphaImage> glyphAtlasImage;
-    ImageAtlas iconAtlas = makeImageAtlas(imageMap, patternMap, versionMap);
+    GlyphAtlasReference glyphAtlasReference;
+    ImageAtlas iconAtlas = imageAtlas->addImages(imageMap, patternMap, versionMap);
     if (!layouts.empty()) {
-        GlyphAtlas glyphAtlas = makeGlyphAtlas(glyphMap);
-        glyphAtlasImage = std::move(glyphAtlas.image);
+        GlyphPositions glyphPositions;
+        glyphAtlasReference = glyphAtlas->addGlyphs(glyphMap, glyphPositions);
 
         for (auto& layout : layouts) {
             if (obsolete) {
                 return;
             }
 
-            layout->prepareSymbols(glyphMap, glyphAtlas.positions, imageMap, iconAtlas.iconPositions);
+            layout->prepareSymbols(glyphMap, glyphPositions, imageMap, iconAtlas.iconPositions);
 
             if (!layout->hasSymbolInstances()) {
                 continue;
@@ -472,6 +619,8 @@ void GeometryTileWorker::finalizeLayout() {
     }
 
     layouts.clear();
+    parsedGroups = std::move(pendingGroups);
+    pendingGroups.clear();
 
     firstLoad = false;
     
@@ -484,7 +633,7 @@ void GeometryTileWorker::finalizeLayout() {
     parent.invoke(&GeometryTile::onLayout, std::make_shared<GeometryTile::LayoutResult>(
         std::move(renderData),
         std::move(featureIndex),
-        std::move(glyphAtlasImage),
+        std::move(glyphAtlasReference),
         std::move(iconAtlas)
     ), correlationID);
 }
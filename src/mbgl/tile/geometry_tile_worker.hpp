@@ -20,7 +20,9 @@ namespace mbgl {
 
 class GeometryTile;
 class GeometryTileData;
+class GlyphAtlas;
 class Layout;
+class SharedImageAtlas;
 
 namespace style {
 class Layer;
@@ -33,9 +35,12 @@ public:
                        OverscaledTileID,
                        std::string,
                        const std::atomic<bool>&,
+                       std::shared_ptr<GlyphAtlas>,
+                       std::shared_ptr<SharedImageAtlas>,
                        const MapMode,
                        const float pixelRatio,
-                       const bool showCollisionBoxes_);
+                       const bool showCollisionBoxes_,
+                       const bool parallelParsing_);
     ~GeometryTileWorker();
 
     void setLayers(std::vector<Immutable<style::LayerProperties>>,
@@ -72,12 +77,25 @@ private:
     const OverscaledTileID id;
     const std::string sourceID;
     const std::atomic<bool>& obsolete;
+    const std::shared_ptr<GlyphAtlas> glyphAtlas;
+    const std::shared_ptr<SharedImageAtlas> imageAtlas;
     const MapMode mode;
     const float pixelRatio;
+    // Whether parse() spreads independent layout groups across the background scheduler.
+    const bool parallelParsing;
     
     std::unique_ptr<FeatureIndex> featureIndex;
     std::unordered_map<std::string, LayerRenderData> renderData;
 
+    // Layer groups, keyed by layout key, whose buckets were built during parsing
+    // and didn't depend on glyphs or images. When a style update leaves such a
+    // group unchanged, its bucket is carried over from the previous layout
+    // result instead of being rebuilt. |parsedGroups| describes the last result
+    // sent to the tile, |pendingGroups| the one currently being prepared.
+    using LayerGroups = std::unordered_map<std::string, std::vector<Immutable<style::LayerProperties>>>;
+    LayerGroups parsedGroups;
+    LayerGroups pendingGroups;
+
     enum State {
         Idle,
         Coalescing,
@@ -120,4 +120,13 @@ void RasterDEMTile::setNecessity(TileNecessity necessity) {
     loader.setNecessity(necessity);
 }
 
+void RasterDEMTile::setPriority(double priority) {
+    worker.setPriority(priority);
+    loader.setPriority(priority);
+}
+
+std::size_t RasterDEMTile::getMemoryUsage() const {
+    return bucket ? bucket->getMemoryUsage() : 0;
+}
+
 } // namespace mbgl
@@ -68,6 +68,8 @@ public:
 
     std::unique_ptr<TileRenderData> createRenderData() override;
     void setNecessity(TileNecessity) final;
+    void setPriority(double) final;
+    std::size_t getMemoryUsage() const final;
 
     void setError(std::exception_ptr);
     void setMetadata(optional<Timestamp> modified, optional<Timestamp> expires);
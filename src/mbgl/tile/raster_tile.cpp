@@ -77,4 +77,13 @@ void RasterTile::setNecessity(TileNecessity necessity) {
     loader.setNecessity(necessity);
 }
 
+void RasterTile::setPriority(double priority) {
+    worker.setPriority(priority);
+    loader.setPriority(priority);
+}
+
+std::size_t RasterTile::getMemoryUsage() const {
+    return bucket ? bucket->getMemoryUsage() : 0;
+}
+
 } // namespace mbgl
@@ -36,6 +36,7 @@ void Tile::dumpDebugLogs() const {
     Log::Info(Event::General, "Tile::id: %s", util::toString(id).c_str());
     Log::Info(Event::General, "Tile::renderable: %s", isRenderable() ? "yes" : "no");
     Log::Info(Event::General, "Tile::complete: %s", isComplete() ? "yes" : "no");
+    Log::Info(Event::General, "Tile::memoryUsage: %zu bytes", getMemoryUsage());
 }
 
 void Tile::queryRenderedFeatures(std::unordered_map<std::string, std::vector<Feature>>&, const GeometryCoordinates&,
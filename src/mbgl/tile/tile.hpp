@@ -53,6 +53,14 @@ public:
 
     virtual void setNecessity(TileNecessity) {}
 
+    // Sets the order in which pending work for this tile is processed relative
+    // to other tiles. Lower values are processed first.
+    virtual void setPriority(double) {}
+
+    // Approximate number of bytes held by the tile's buckets, feature index
+    // and textures, in client as well as GPU memory.
+    virtual std::size_t getMemoryUsage() const { return 0; }
+
     // Mark this tile as no longer needed and cancel any pending work.
     virtual void cancel();
 
@@ -1,18 +1,18 @@
 #include <mbgl/tile/tile_cache.hpp>
 #include <cassert>
+#include <iterator>
 
 namespace mbgl {
 
 void TileCache::setSize(size_t size_) {
     size = size_;
+    prune();
+    assert(tiles.size() <= size);
+}
 
-    while (orderedKeys.size() > size) {
-        auto key = orderedKeys.front();
-        orderedKeys.remove(key);
-        tiles.erase(key);
-    }
-
-    assert(orderedKeys.size() <= size);
+void TileCache::setMaximumMemoryUsage(size_t maximumMemoryUsage_) {
+    maximumMemoryUsage = maximumMemoryUsage_;
+    prune();
 }
 
 void TileCache::add(const OverscaledTileID& key, std::unique_ptr<Tile> tile) {
@@ -20,41 +20,39 @@ void TileCache::add(const OverscaledTileID& key, std::unique_ptr<Tile> tile) {
         return;
     }
 
-    // insert new or query existing tile
-    if (!tiles.emplace(key, std::move(tile)).second) {
-        // remove existing tile key
-        orderedKeys.remove(key);
+    // replace existing tile
+    auto it = tiles.find(key);
+    if (it != tiles.end()) {
+        erase(it->second);
     }
 
-    // (re-)insert tile key as newest
-    orderedKeys.push_back(key);
+    // insert tile as newest
+    const size_t tileMemoryUsage = tile->getMemoryUsage();
+    entries.push_back({key, std::move(tile), tileMemoryUsage});
+    tiles.emplace(key, std::prev(entries.end()));
+    memoryUsage += tileMemoryUsage;
 
-    // purge oldest key/tile if necessary
-    if (orderedKeys.size() > size) {
-        pop(orderedKeys.front());
-    }
+    // purge oldest tiles if necessary
+    prune();
 
-    assert(orderedKeys.size() <= size);
+    assert(tiles.size() <= size);
 }
 
 Tile* TileCache::get(const OverscaledTileID& key) {
     auto it = tiles.find(key);
     if (it != tiles.end()) {
-        return it->second.get();
+        return it->second->tile.get();
     } else {
         return nullptr;
     }
 }
 
 std::unique_ptr<Tile> TileCache::pop(const OverscaledTileID& key) {
-
     std::unique_ptr<Tile> tile;
 
     auto it = tiles.find(key);
     if (it != tiles.end()) {
-        tile = std::move(it->second);
-        tiles.erase(it);
-        orderedKeys.remove(key);
+        tile = erase(it->second);
         assert(tile->isRenderable());
     }
 
@@ -66,8 +64,25 @@ bool TileCache::has(const OverscaledTileID& key) {
 }
 
 void TileCache::clear() {
-    orderedKeys.clear();
     tiles.clear();
+    entries.clear();
+    memoryUsage = 0;
+}
+
+std::unique_ptr<Tile> TileCache::erase(Entries::iterator entry) {
+    std::unique_ptr<Tile> tile = std::move(entry->tile);
+    assert(memoryUsage >= entry->memoryUsage);
+    memoryUsage -= entry->memoryUsage;
+    tiles.erase(entry->key);
+    entries.erase(entry);
+    return tile;
+}
+
+void TileCache::prune() {
+    while (!entries.empty() &&
+           (tiles.size() > size || (maximumMemoryUsage && memoryUsage > maximumMemoryUsage))) {
+        erase(entries.begin());
+    }
 }
 
 } // namespace mbgl
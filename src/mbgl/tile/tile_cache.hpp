@@ -3,19 +3,30 @@
 #include <mbgl/tile/tile_id.hpp>
 #include <mbgl/tile/tile.hpp>
 
-
 #include <list>
 #include <memory>
-#include <map>
+#include <unordered_map>
 
 namespace mbgl {
 
+// Keeps recently used tiles around, evicting the least recently used ones once
+// either the number of tiles or their combined memory usage exceeds the limit.
+// The memory usage of a tile is sampled when it is added to the cache.
 class TileCache {
 public:
     TileCache(size_t size_ = 0) : size(size_) {}
 
     void setSize(size_t);
     size_t getSize() const { return size; };
+
+    // Limits the combined memory usage of the cached tiles, in bytes. 0 means
+    // that the cache is limited by tile count only.
+    void setMaximumMemoryUsage(size_t);
+    size_t getMaximumMemoryUsage() const { return maximumMemoryUsage; }
+
+    // Combined memory usage of the cached tiles, in bytes.
+    size_t getMemoryUsage() const { return memoryUsage; }
+
     void add(const OverscaledTileID& key, std::unique_ptr<Tile> data);
     std::unique_ptr<Tile> pop(const OverscaledTileID& key);
     Tile* get(const OverscaledTileID& key);
@@ -23,10 +34,24 @@ public:
     void clear();
 
 private:
-    std::map<OverscaledTileID, std::unique_ptr<Tile>> tiles;
-    std::list<OverscaledTileID> orderedKeys;
+    struct Entry {
+        OverscaledTileID key;
+        std::unique_ptr<Tile> tile;
+        size_t memoryUsage;
+    };
+
+    // Ordered from least to most recently added.
+    using Entries = std::list<Entry>;
+
+    std::unique_ptr<Tile> erase(Entries::iterator);
+    void prune();
+
+    Entries entries;
+    std::unordered_map<OverscaledTileID, Entries::iterator> tiles;
 
     size_t size;
+    size_t maximumMemoryUsage = 0;
+    size_t memoryUsage = 0;
 };
 
 } // namespace mbgl
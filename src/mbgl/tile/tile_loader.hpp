@@ -2,11 +2,13 @@
 
 #include <mbgl/storage/resource.hpp>
 #include <mbgl/tile/tile.hpp>
+#include <mbgl/util/async_request.hpp>
+
+#include <cmath>
 
 namespace mbgl {
 
 class FileSource;
-class AsyncRequest;
 class Response;
 class Tileset;
 class TileParameters;
@@ -33,6 +35,17 @@ public:
         }
     }
 
+    // Tile priorities change continuously while the map moves, so pending
+    // requests are only reordered once the priority changed by a whole tile.
+    void setPriority(double priority) {
+        if (!request) {
+            resource.order = priority;
+        } else if (std::abs(priority - resource.order) >= 1) {
+            resource.order = priority;
+            request->setPriority(priority);
+        }
+    }
+
 private:
     // called when the tile is one of the ideal tiles that we want to show definitely. the tile source
     // should try to make every effort (e.g. fetch from internet, or revalidate existing resources).
@@ -16,6 +16,11 @@ void VectorTile::setNecessity(TileNecessity necessity) {
     loader.setNecessity(necessity);
 }
 
+void VectorTile::setPriority(double priority) {
+    GeometryTile::setPriority(priority);
+    loader.setPriority(priority);
+}
+
 void VectorTile::setMetadata(optional<Timestamp> modified_, optional<Timestamp> expires_) {
     modified = modified_;
     expires = expires_;
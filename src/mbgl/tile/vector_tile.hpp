@@ -16,6 +16,7 @@ public:
                const Tileset&);
 
     void setNecessity(TileNecessity) final;
+    void setPriority(double) final;
     void setMetadata(optional<Timestamp> modified, optional<Timestamp> expires);
     void setData(std::shared_ptr<const std::string> data);
 
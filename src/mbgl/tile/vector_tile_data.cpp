@@ -1,15 +1,15 @@
 #include <mbgl/tile/vector_tile_data.hpp>
 #include <mbgl/util/constants.hpp>
+#include <mbgl/util/monotonic_arena.hpp>
+
+#include <stdexcept>
 
 namespace mbgl {
 
-VectorTileFeature::VectorTileFeature(const mapbox::vector_tile::layer& layer,
-                                     const protozero::data_view& view)
-    : feature(view, layer) {
-}
+namespace {
 
-FeatureType VectorTileFeature::getType() const {
-    switch (feature.getType()) {
+FeatureType convertType(mapbox::vector_tile::GeomType type) {
+    switch (type) {
     case mapbox::vector_tile::GeomType::POINT:
         return FeatureType::Point;
     case mapbox::vector_tile::GeomType::LINESTRING:
@@ -21,72 +21,244 @@ FeatureType VectorTileFeature::getType() const {
     }
 }
 
+} // namespace
+
+VectorTileLayerData::VectorTileLayerData(std::shared_ptr<const std::string> data_,
+                                         const protozero::data_view& view)
+    : data(std::move(data_)), layer(view) {
+}
+
+void VectorTileLayerData::decode() const {
+    std::call_once(decoded, [this] { decodeFeatures(); });
+}
+
+void VectorTileLayerData::decodeFeatures() const {
+    // Start from scratch in case a previous attempt threw halfway through.
+    keys.clear();
+    keyIndices.clear();
+    resolvedKeys = {};
+    tags.clear();
+    features.clear();
+    ids.clear();
+    geometries.clear();
+
+    const std::size_t count = layer.featureCount();
+    features.reserve(count);
+    ids.reserve(count);
+    geometries.reserve(count);
+
+    for (std::size_t i = 0; i < count; ++i) {
+        const mapbox::vector_tile::feature feature(layer.getFeature(i), layer);
+
+        const auto tagsBegin = static_cast<uint32_t>(tags.size());
+        for (auto& property : feature.getProperties()) {
+            auto it = keyIndices.find(property.first);
+            if (it == keyIndices.end()) {
+                it = keyIndices.emplace(property.first, static_cast<uint32_t>(keys.size())).first;
+                keys.push_back(property.first);
+            }
+            tags.push_back({ it->second, std::move(property.second) });
+        }
+
+        features.push_back({ convertType(feature.getType()), tagsBegin, static_cast<uint32_t>(tags.size()) });
+        ids.push_back(feature.getID());
+
+        const float scale = float(util::EXTENT) / feature.getExtent();
+        GeometryCollection lines = feature.getGeometries<GeometryCollection>(scale);
+        if (feature.getVersion() < 2 && feature.getType() == mapbox::vector_tile::GeomType::POLYGON) {
+            lines = fixupPolygons(lines);
+        }
+        geometries.push_back(std::move(lines));
+    }
+
+    resolvedKeys = FeaturePropertyKey::Resolution(keys);
+    memoryUsage = computeMemoryUsage();
+}
+
+std::size_t VectorTileLayerData::computeMemoryUsage() const {
+    std::size_t bytes = keys.capacity() * sizeof(std::string) +
+                        resolvedKeys.getMemoryUsage() +
+                        tags.capacity() * sizeof(Tag) +
+                        features.capacity() * sizeof(FeatureRecord) +
+                        ids.capacity() * sizeof(FeatureIdentifier) +
+                        geometries.capacity() * sizeof(GeometryCollection);
+
+    for (const auto& key : keys) {
+        // Each key is stored in the key table and in the index map.
+        bytes += 2 * key.capacity() + sizeof(std::pair<const std::string, uint32_t>) + sizeof(void*);
+    }
+    for (const auto& tag : tags) {
+        if (tag.value.is<std::string>()) {
+            bytes += tag.value.get<std::string>().capacity();
+        }
+    }
+    for (const auto& id : ids) {
+        if (id.is<std::string>()) {
+            bytes += id.get<std::string>().capacity();
+        }
+    }
+    for (const auto& geometry : geometries) {
+        bytes += geometry.capacity() * sizeof(GeometryCoordinates);
+        for (const auto& ring : geometry) {
+            bytes += ring.capacity() * sizeof(GeometryCoordinate);
+        }
+    }
+    return bytes;
+}
+
+FeatureType VectorTileLayerData::getType(std::size_t i) const {
+    return features[i].type;
+}
+
+FeatureIdentifier VectorTileLayerData::getID(std::size_t i) const {
+    return ids[i];
+}
+
+optional<Value> VectorTileLayerData::getValue(std::size_t i, const std::string& key) const {
+    auto it = keyIndices.find(key);
+    if (it == keyIndices.end()) {
+        return nullopt;
+    }
+    return getTagValue(i, it->second);
+}
+
+optional<Value> VectorTileLayerData::getValue(std::size_t i, const FeaturePropertyKey& key) const {
+    const optional<uint32_t> keyIndex = resolvedKeys.find(key);
+    if (!keyIndex) {
+        // The key was registered after this layer was decoded.
+        return getValue(i, key.name);
+    }
+    if (*keyIndex == FeaturePropertyKey::noIndex) {
+        return nullopt;
+    }
+    return getTagValue(i, *keyIndex);
+}
+
+optional<Value> VectorTileLayerData::getTagValue(std::size_t i, uint32_t key) const {
+    const FeatureRecord& feature = features[i];
+    for (uint32_t tag = feature.tagsBegin; tag != feature.tagsEnd; ++tag) {
+        if (tags[tag].key == key) {
+            const Value& value = tags[tag].value;
+            return value.is<NullValue>() ? nullopt : optional<Value>(value);
+        }
+    }
+    return nullopt;
+}
+
+PropertyMap VectorTileLayerData::getProperties(std::size_t i) const {
+    const FeatureRecord& feature = features[i];
+    PropertyMap result;
+    result.reserve(feature.tagsEnd - feature.tagsBegin);
+    for (uint32_t tag = feature.tagsBegin; tag != feature.tagsEnd; ++tag) {
+        result.emplace(keys[tags[tag].key], tags[tag].value);
+    }
+    return result;
+}
+
+const GeometryCollection& VectorTileLayerData::getGeometries(std::size_t i) const {
+    return geometries[i];
+}
+
+VectorTileFeature::VectorTileFeature(const VectorTileLayerData& layer_, std::size_t index_)
+    : layer(layer_), index(index_) {
+}
+
+FeatureType VectorTileFeature::getType() const {
+    return layer.getType(index);
+}
+
 optional<Value> VectorTileFeature::getValue(const std::string& key) const {
-    const optional<Value> value(feature.getValue(key));
-    return value->is<NullValue>() ? nullopt : value;
+    return layer.getValue(index, key);
+}
+
+optional<Value> VectorTileFeature::getPropertyValue(const FeaturePropertyKey& key) const {
+    return layer.getValue(index, key);
 }
 
 const PropertyMap& VectorTileFeature::getProperties() const {
     if (!properties) {
-        properties = feature.getProperties();
+        properties = layer.getProperties(index);
     }
     return *properties;
 }
 
 FeatureIdentifier VectorTileFeature::getID() const {
-    return feature.getID();
+    return layer.getID(index);
 }
 
 const GeometryCollection& VectorTileFeature::getGeometries() const {
-    if (!lines) {
-        const float scale = float(util::EXTENT) / feature.getExtent();
-        lines = feature.getGeometries<GeometryCollection>(scale);
-        if (feature.getVersion() < 2 && feature.getType() == mapbox::vector_tile::GeomType::POLYGON) {
-            lines = fixupPolygons(*lines);
-        }
-    }
-    return *lines;
+    return layer.getGeometries(index);
 }
 
-VectorTileLayer::VectorTileLayer(std::shared_ptr<const std::string> data_,
-                                 const protozero::data_view& view)
-    : data(std::move(data_)), layer(view) {
+VectorTileLayer::VectorTileLayer(std::shared_ptr<const VectorTileLayerData> layer_)
+    : layer(std::move(layer_)) {
 }
 
 std::size_t VectorTileLayer::featureCount() const {
-    return layer.featureCount();
+    return layer->featureCount();
 }
 
 std::unique_ptr<GeometryTileFeature> VectorTileLayer::getFeature(std::size_t i) const {
-    return std::make_unique<VectorTileFeature>(layer, layer.getFeature(i));
+    if (i >= layer->featureCount()) {
+        throw std::out_of_range("feature index out of range");
+    }
+    layer->decode();
+    return std::make_unique<VectorTileFeature>(*layer, i);
+}
+
+const GeometryTileFeature* VectorTileLayer::getTemporaryFeature(std::size_t i, util::MonotonicArena& arena) const {
+    if (i >= layer->featureCount()) {
+        throw std::out_of_range("feature index out of range");
+    }
+    layer->decode();
+    return arena.make<VectorTileFeature>(*layer, i);
 }
 
 std::string VectorTileLayer::getName() const {
-    return layer.getName();
+    return layer->getName();
 }
 
-VectorTileData::VectorTileData(std::shared_ptr<const std::string> data_) : data(std::move(data_)) {
+VectorTileData::VectorTileData(std::shared_ptr<const std::string> data_)
+    : VectorTileData(std::move(data_), std::make_shared<Layers>()) {
+}
+
+VectorTileData::VectorTileData(std::shared_ptr<const std::string> data_, std::shared_ptr<Layers> layers_)
+    : data(std::move(data_)), layers(std::move(layers_)) {
 }
 
 std::unique_ptr<GeometryTileData> VectorTileData::clone() const {
-    return std::make_unique<VectorTileData>(data);
+    // Clones share the decoded layers, e.g. the copy held by the feature index.
+    return std::unique_ptr<GeometryTileData>(new VectorTileData(data, layers));
 }
 
 std::unique_ptr<GeometryTileLayer> VectorTileData::getLayer(const std::string& name) const {
-    if (!parsed) {
+    std::lock_guard<std::mutex> lock(layers->mutex);
+
+    if (!layers->parsed) {
         // We're parsing this lazily so that we can construct VectorTileData objects on the main
         // thread without incurring the overhead of parsing immediately.
-        layers = mapbox::vector_tile::buffer(*data).getLayers();
-        parsed = true;
+        for (const auto& layer : mapbox::vector_tile::buffer(*data).getLayers()) {
+            layers->layers.emplace(layer.first, std::make_shared<VectorTileLayerData>(data, layer.second));
+        }
+        layers->parsed = true;
     }
 
-    auto it = layers.find(name);
-    if (it != layers.end()) {
-        return std::make_unique<VectorTileLayer>(data, it->second);
+    auto it = layers->layers.find(name);
+    if (it != layers->layers.end()) {
+        return std::make_unique<VectorTileLayer>(it->second);
     }
     return nullptr;
 }
 
+std::size_t VectorTileData::getMemoryUsage() const {
+    std::size_t bytes = data ? data->size() : 0;
+    std::lock_guard<std::mutex> lock(layers->mutex);
+    for (const auto& layer : layers->layers) {
+        bytes += layer.second->getMemoryUsage();
+    }
+    return bytes;
+}
+
 std::vector<std::string> VectorTileData::layerNames() const {
     return mapbox::vector_tile::buffer(*data).layerNames();
 }
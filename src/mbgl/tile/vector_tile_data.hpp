@@ -3,39 +3,103 @@
 #include <mapbox/vector_tile.hpp>
 #include <protozero/pbf_reader.hpp>
 
+#include <atomic>
 #include <unordered_map>
 #include <functional>
+#include <mutex>
 #include <utility>
 
 namespace mbgl {
 
+// The features of one source layer, decoded from the protobuf representation
+// once and then shared by every layout group that reads the layer, by the
+// feature index and by re-parses of the same tile data. Decoding happens on
+// first access to a feature, on whichever thread gets there first.
+//
+// Properties are stored in columns: each feature refers to a range of tags,
+// which pair an index into the layer-wide key table with a decoded value. The
+// key table is also resolved against the registered FeaturePropertyKeys, so
+// that these are looked up without comparing strings.
+class VectorTileLayerData {
+public:
+    VectorTileLayerData(std::shared_ptr<const std::string> data, const protozero::data_view&);
+
+    std::size_t featureCount() const { return layer.featureCount(); }
+    std::string getName() const { return layer.getName(); }
+
+    FeatureType getType(std::size_t) const;
+    FeatureIdentifier getID(std::size_t) const;
+    optional<Value> getValue(std::size_t, const std::string& key) const;
+    optional<Value> getValue(std::size_t, const FeaturePropertyKey& key) const;
+    PropertyMap getProperties(std::size_t) const;
+    const GeometryCollection& getGeometries(std::size_t) const;
+
+    // Decodes all features of the layer if that hasn't happened yet.
+    void decode() const;
+
+    // Approximate number of bytes held by the decoded features, or 0 if the
+    // layer wasn't decoded yet. Safe to call while another thread decodes.
+    std::size_t getMemoryUsage() const { return memoryUsage; }
+
+private:
+    struct Tag {
+        uint32_t key;
+        Value value;
+    };
+
+    struct FeatureRecord {
+        FeatureType type;
+        uint32_t tagsBegin;
+        uint32_t tagsEnd;
+    };
+
+    void decodeFeatures() const;
+    std::size_t computeMemoryUsage() const;
+    optional<Value> getTagValue(std::size_t, uint32_t key) const;
+
+    std::shared_ptr<const std::string> data;
+    mapbox::vector_tile::layer layer;
+
+    mutable std::once_flag decoded;
+    mutable std::vector<std::string> keys;
+    mutable std::unordered_map<std::string, uint32_t> keyIndices;
+    // Position in `keys` of the FeaturePropertyKeys registered before decoding.
+    mutable FeaturePropertyKey::Resolution resolvedKeys;
+    mutable std::vector<Tag> tags;
+    mutable std::vector<FeatureRecord> features;
+    mutable std::vector<FeatureIdentifier> ids;
+    mutable std::vector<GeometryCollection> geometries;
+    mutable std::atomic<std::size_t> memoryUsage { 0 };
+};
+
 class VectorTileFeature : public GeometryTileFeature {
 public:
-    VectorTileFeature(const mapbox::vector_tile::layer&, const protozero::data_view&);
+    VectorTileFeature(const VectorTileLayerData&, std::size_t index);
 
     FeatureType getType() const override;
     optional<Value> getValue(const std::string& key) const override;
+    optional<Value> getPropertyValue(const FeaturePropertyKey& key) const override;
     const PropertyMap& getProperties() const override;
     FeatureIdentifier getID() const override;
     const GeometryCollection& getGeometries() const override;
 
 private:
-    mapbox::vector_tile::feature feature;
-    mutable optional<GeometryCollection> lines;
+    const VectorTileLayerData& layer;
+    const std::size_t index;
     mutable optional<PropertyMap> properties;
 };
 
 class VectorTileLayer : public GeometryTileLayer {
 public:
-    VectorTileLayer(std::shared_ptr<const std::string> data, const protozero::data_view&);
+    VectorTileLayer(std::shared_ptr<const VectorTileLayerData>);
 
     std::size_t featureCount() const override;
     std::unique_ptr<GeometryTileFeature> getFeature(std::size_t i) const override;
+    const GeometryTileFeature* getTemporaryFeature(std::size_t i, util::MonotonicArena&) const override;
     std::string getName() const override;
 
 private:
-    std::shared_ptr<const std::string> data;
-    mapbox::vector_tile::layer layer;
+    std::shared_ptr<const VectorTileLayerData> layer;
 };
 
 class VectorTileData : public GeometryTileData {
@@ -47,10 +111,21 @@ public:
 
     std::vector<std::string> layerNames() const;
 
+    std::size_t getMemoryUsage() const override;
+
 private:
+    // Shared between all clones of the same tile data, which may be used from
+    // different threads.
+    struct Layers {
+        std::mutex mutex;
+        bool parsed = false;
+        std::map<std::string, std::shared_ptr<const VectorTileLayerData>> layers;
+    };
+
+    VectorTileData(std::shared_ptr<const std::string> data, std::shared_ptr<Layers>);
+
     std::shared_ptr<const std::string> data;
-    mutable bool parsed = false;
-    mutable std::map<std::string, const protozero::data_view> layers;
+    std::shared_ptr<Layers> layers;
 };
 
 } // namespace mbgl
@@ -1,9 +1,7 @@
 #include <mbgl/util/grid_index.hpp>
 #include <mbgl/geometry/feature_index.hpp>
-#include <mbgl/math/minmax.hpp>
 
-#include <unordered_set>
-#include <cmath>
+#include <cassert>
 
 namespace mbgl {
 
@@ -23,9 +21,67 @@ GridIndex<T>::GridIndex(const float width_, const float height_, const uint32_t
         circleCells.resize(xCellCount * yCellCount);
     }
 
+template <class T>
+void GridIndex<T>::Cells::resize(std::size_t count) {
+    offsets.resize(count + 1, 0);
+    pendingFirst.resize(count, noEntry);
+    pendingLast.resize(count, noEntry);
+}
+
+template <class T>
+void GridIndex<T>::Cells::insert(std::size_t cell, uint32_t element) {
+    const auto entry = static_cast<uint32_t>(pending.size());
+    pending.push_back({ element, noEntry });
+    if (pendingLast[cell] == noEntry) {
+        pendingFirst[cell] = entry;
+    } else {
+        pending[pendingLast[cell]].next = entry;
+    }
+    pendingLast[cell] = entry;
+}
+
+template <class T>
+void GridIndex<T>::Cells::compact() {
+    // Rebuilding takes time linear in the number of cells and entries. Only
+    // doing it once there are at least as many pending entries as entries in
+    // the array and as cells keeps the total cost linear in the number of
+    // insertions.
+    const std::size_t count = pendingFirst.size();
+    if (pending.empty() || pending.size() < elements.size() || pending.size() < count) {
+        return;
+    }
+
+    std::vector<uint32_t> newOffsets(count + 1);
+    std::vector<uint32_t> newElements(elements.size() + pending.size());
+    uint32_t size = 0;
+    for (std::size_t cell = 0; cell < count; ++cell) {
+        newOffsets[cell] = size;
+        for (uint32_t i = offsets[cell], end = offsets[cell + 1]; i < end; ++i) {
+            newElements[size++] = elements[i];
+        }
+        for (uint32_t entry = pendingFirst[cell]; entry != noEntry; entry = pending[entry].next) {
+            newElements[size++] = pending[entry].element;
+        }
+    }
+    newOffsets[count] = size;
+
+    offsets.swap(newOffsets);
+    elements.swap(newElements);
+    pending.clear();
+    std::fill(pendingFirst.begin(), pendingFirst.end(), noEntry);
+    std::fill(pendingLast.begin(), pendingLast.end(), noEntry);
+}
+
+template <class T>
+std::size_t GridIndex<T>::Cells::getMemoryUsage() const {
+    return (offsets.capacity() + elements.capacity() + pendingFirst.capacity() + pendingLast.capacity()) *
+               sizeof(uint32_t) +
+           pending.capacity() * sizeof(PendingEntry);
+}
+
 template <class T>
 void GridIndex<T>::insert(T&& t, const BBox& bbox) {
-    size_t uid = boxElements.size();
+    const auto uid = static_cast<uint32_t>(boxElements.size());
 
     auto cx1 = convertToXCellCoord(bbox.min.x);
     auto cy1 = convertToYCellCoord(bbox.min.y);
@@ -36,16 +92,17 @@ void GridIndex<T>::insert(T&& t, const BBox& bbox) {
     for (x = cx1; x <= cx2; ++x) {
         for (y = cy1; y <= cy2; ++y) {
             cellIndex = xCellCount * y + x;
-            boxCells[cellIndex].push_back(uid);
+            boxCells.insert(cellIndex, uid);
         }
     }
 
     boxElements.emplace_back(t, bbox);
+    boxVisits.push_back(0);
 }
 
 template <class T>
 void GridIndex<T>::insert(T&& t, const BCircle& bcircle) {
-    size_t uid = circleElements.size();
+    const auto uid = static_cast<uint32_t>(circleElements.size());
 
     auto cx1 = convertToXCellCoord(bcircle.center.x - bcircle.radius);
     auto cy1 = convertToYCellCoord(bcircle.center.y - bcircle.radius);
@@ -56,11 +113,12 @@ void GridIndex<T>::insert(T&& t, const BCircle& bcircle) {
     for (x = cx1; x <= cx2; ++x) {
         for (y = cy1; y <= cy2; ++y) {
             cellIndex = xCellCount * y + x;
-            circleCells[cellIndex].push_back(uid);
+            circleCells.insert(cellIndex, uid);
         }
     }
 
     circleElements.emplace_back(t, bcircle);
+    circleVisits.push_back(0);
 }
 
 template <class T>
@@ -84,227 +142,26 @@ std::vector<std::pair<T, typename GridIndex<T>::BBox>> GridIndex<T>::queryWithBo
 }
 
 template <class T>
-bool GridIndex<T>::hitTest(const BBox& queryBBox, optional<std::function<bool(const T&)>> predicate) const {
-    bool hit = false;
-    query(queryBBox, [&](const T& t, const BBox&) -> bool {
-        if (!predicate || (*predicate)(t)) {
-            hit = true;
-            return true;
-        } else {
-            return false;
-        }
-    });
-    return hit;
-}
-
-template <class T>
-bool GridIndex<T>::hitTest(const BCircle& queryBCircle, optional<std::function<bool(const T&)>> predicate) const {
-    bool hit = false;
-    query(queryBCircle, [&](const T& t, const BBox&) -> bool {
-        if (!predicate || (*predicate)(t)) {
-            hit = true;
-            return true;
-        } else {
-            return false;
-        }
-    });
-    return hit;
-}
-
-template <class T>
-bool GridIndex<T>::noIntersection(const BBox& queryBBox) const {
-    return queryBBox.max.x < 0 || queryBBox.min.x >= width || queryBBox.max.y < 0 || queryBBox.min.y >= height;
-}
-
-template <class T>
-bool GridIndex<T>::completeIntersection(const BBox& queryBBox) const {
-    return queryBBox.min.x <= 0 && queryBBox.min.y <= 0 && width <= queryBBox.max.x && height <= queryBBox.max.y;
-}
-
-template <class T>
-typename GridIndex<T>::BBox GridIndex<T>::convertToBox(const BCircle& circle) const {
-    return BBox{{circle.center.x - circle.radius, circle.center.y - circle.radius},
-                {circle.center.x + circle.radius, circle.center.y + circle.radius}};
-}
-
-template <class T>
-void GridIndex<T>::query(const BBox& queryBBox, std::function<bool (const T&, const BBox&)> resultFn) const {
-    std::unordered_set<size_t> seenBoxes;
-    std::unordered_set<size_t> seenCircles;
-    
-    if (noIntersection(queryBBox)) {
-        return;
-    } else if (completeIntersection(queryBBox)) {
-        for (auto& element : boxElements) {
-            if (resultFn(element.first, element.second)) {
-                return;
-            }
-        }
-        for (auto& element : circleElements) {
-            if (resultFn(element.first, convertToBox(element.second))) {
-                return;
-            }
-        }
-        return;
-    }
-
-    auto cx1 = convertToXCellCoord(queryBBox.min.x);
-    auto cy1 = convertToYCellCoord(queryBBox.min.y);
-    auto cx2 = convertToXCellCoord(queryBBox.max.x);
-    auto cy2 = convertToYCellCoord(queryBBox.max.y);
-
-    std::size_t x, y, cellIndex;
-    for (x = cx1; x <= cx2; ++x) {
-        for (y = cy1; y <= cy2; ++y) {
-            cellIndex = xCellCount * y + x;
-            // Look up other boxes
-            for (auto uid : boxCells[cellIndex]) {
-                if (seenBoxes.count(uid) == 0) {
-                    seenBoxes.insert(uid);
-
-                    auto& pair = boxElements.at(uid);
-                    auto& bbox = pair.second;
-                    if (boxesCollide(queryBBox, bbox)) {
-                        if (resultFn(pair.first, bbox)) {
-                            return;
-                        }
-                    }
-                }
-            }
-            
-            // Look up circles
-            for (auto uid : circleCells[cellIndex]) {
-                if (seenCircles.count(uid) == 0) {
-                    seenCircles.insert(uid);
-
-                    auto& pair = circleElements.at(uid);
-                    auto& bcircle = pair.second;
-                    if (circleAndBoxCollide(bcircle, queryBBox)) {
-                        if (resultFn(pair.first, convertToBox(bcircle))) {
-                            return;
-                        }
-                    }
-                }
-            }
-        }
-    }
-}
-
-template <class T>
-void GridIndex<T>::query(const BCircle& queryBCircle, std::function<bool (const T&, const BBox&)> resultFn) const {
-    std::unordered_set<size_t> seenBoxes;
-    std::unordered_set<size_t> seenCircles;
-
-    BBox queryBBox = convertToBox(queryBCircle);
-    if (noIntersection(queryBBox)) {
-        return;
-    } else if (completeIntersection(queryBBox)) {
-        for (auto& element : boxElements) {
-            if (resultFn(element.first, element.second)) {
-                return;
-            }
-        }
-        for (auto& element : circleElements) {
-            if (resultFn(element.first, convertToBox(element.second))) {
-                return;
-            }
-        }
-    }
-
-    auto cx1 = convertToXCellCoord(queryBCircle.center.x - queryBCircle.radius);
-    auto cy1 = convertToYCellCoord(queryBCircle.center.y - queryBCircle.radius);
-    auto cx2 = convertToXCellCoord(queryBCircle.center.x + queryBCircle.radius);
-    auto cy2 = convertToYCellCoord(queryBCircle.center.y + queryBCircle.radius);
-
-    std::size_t x, y, cellIndex;
-    for (x = cx1; x <= cx2; ++x) {
-        for (y = cy1; y <= cy2; ++y) {
-            cellIndex = xCellCount * y + x;
-            // Look up boxes
-            for (auto uid : boxCells[cellIndex]) {
-                if (seenBoxes.count(uid) == 0) {
-                    seenBoxes.insert(uid);
-
-                    auto& pair = boxElements.at(uid);
-                    auto& bbox = pair.second;
-                    if (circleAndBoxCollide(queryBCircle, bbox)) {
-                        if (resultFn(pair.first, bbox)) {
-                            return;
-                        }
-                    }
-                }
-            }
-            
-            // Look up other circles
-            for (auto uid : circleCells[cellIndex]) {
-                if (seenCircles.count(uid) == 0) {
-                    seenCircles.insert(uid);
-
-                    auto& pair = circleElements.at(uid);
-                    auto& bcircle = pair.second;
-                    if (circlesCollide(queryBCircle, bcircle)) {
-                        if (resultFn(pair.first, convertToBox(bcircle))) {
-                            return;
-                        }
-                    }
-                }
-            }
-        }
-    }
-}
-
-template <class T>
-std::size_t GridIndex<T>::convertToXCellCoord(const float x) const {
-    return util::max(0.0, util::min(xCellCount - 1.0, std::floor(x * xScale)));
-}
-
-template <class T>
-std::size_t GridIndex<T>::convertToYCellCoord(const float y) const {
-    return util::max(0.0, util::min(yCellCount - 1.0, std::floor(y * yScale)));
-}
-
-template <class T>
-bool GridIndex<T>::boxesCollide(const BBox& first, const BBox& second) const {
-	return first.min.x <= second.max.x &&
-           first.min.y <= second.max.y &&
-           first.max.x >= second.min.x &&
-           first.max.y >= second.min.y;
+bool GridIndex<T>::hitTest(const BBox& queryBBox) const {
+    return hitTest(queryBBox, [](const T&) { return true; });
 }
 
 template <class T>
-bool GridIndex<T>::circlesCollide(const BCircle& first, const BCircle& second) const {
-    auto dx = second.center.x - first.center.x;
-    auto dy = second.center.y - first.center.y;
-    auto bothRadii = first.radius + second.radius;
-    return (bothRadii * bothRadii) > (dx * dx + dy * dy);
+bool GridIndex<T>::hitTest(const BCircle& queryBCircle) const {
+    return hitTest(queryBCircle, [](const T&) { return true; });
 }
 
 template <class T>
-bool GridIndex<T>::circleAndBoxCollide(const BCircle& circle, const BBox& box) const {
-    auto halfRectWidth = (box.max.x - box.min.x) / 2;
-    auto distX = std::abs(circle.center.x - (box.min.x + halfRectWidth));
-    if (distX > (halfRectWidth + circle.radius)) {
-        return false;
-    }
-
-    auto halfRectHeight = (box.max.y - box.min.y) / 2;
-    auto distY = std::abs(circle.center.y - (box.min.y + halfRectHeight));
-    if (distY > (halfRectHeight + circle.radius)) {
-        return false;
-    }
-
-    if (distX <= halfRectWidth || distY <= halfRectHeight) {
-        return true;
-    }
-
-    auto dx = distX - halfRectWidth;
-    auto dy = distY - halfRectHeight;
-    return (dx * dx + dy * dy) <= (circle.radius * circle.radius);
+bool GridIndex<T>::empty() const {
+    return boxElements.empty() && circleElements.empty();
 }
 
 template <class T>
-bool GridIndex<T>::empty() const {
-    return boxElements.empty() && circleElements.empty();
+std::size_t GridIndex<T>::getMemoryUsage() const {
+    return boxElements.capacity() * sizeof(typename decltype(boxElements)::value_type) +
+           circleElements.capacity() * sizeof(typename decltype(circleElements)::value_type) +
+           (boxVisits.capacity() + circleVisits.capacity()) * sizeof(uint32_t) +
+           boxCells.getMemoryUsage() + circleCells.getMemoryUsage();
 }
 
 
@@ -2,10 +2,14 @@
 
 #include <mapbox/geometry/point.hpp>
 #include <mapbox/geometry/box.hpp>
+#include <mbgl/math/minmax.hpp>
 #include <mbgl/util/optional.hpp>
 
+#include <algorithm>
+#include <cmath>
 #include <cstdint>
 #include <cstddef>
+#include <limits>
 #include <vector>
 #include <functional>
 
@@ -68,18 +72,79 @@ public:
     std::vector<T> query(const BBox&) const;
     std::vector<std::pair<T,BBox>> queryWithBoxes(const BBox&) const;
     
-    bool hitTest(const BBox&, optional<std::function<bool(const T&)>> predicate = nullopt) const;
-    bool hitTest(const BCircle&, optional<std::function<bool(const T&)>> predicate = nullopt) const;
+    bool hitTest(const BBox&) const;
+    bool hitTest(const BCircle&) const;
+
+    // Only elements for which the predicate returns true count as a hit.
+    template <class Predicate>
+    bool hitTest(const BBox&, Predicate&&) const;
+    template <class Predicate>
+    bool hitTest(const BCircle&, Predicate&&) const;
     
     bool empty() const;
 
+    // Approximate number of bytes used by the elements and cells of the index.
+    std::size_t getMemoryUsage() const;
+
 private:
+    static constexpr uint32_t noEntry = std::numeric_limits<uint32_t>::max();
+
+    // The elements of each cell, in insertion order. They are stored in one
+    // array sorted by cell, with the range of each cell given by `offsets`.
+    // Elements inserted since the array was last built are kept in a linked
+    // list per cell, threaded through `pending`, until compact() merges them
+    // into the array. Queries compact the cells once there are enough pending
+    // entries to pay for it: an index that is filled and then queried ends up
+    // with contiguous cells, while one that is queried in between insertions
+    // is only rebuilt a logarithmic number of times.
+    struct Cells {
+        struct PendingEntry {
+            uint32_t element;
+            uint32_t next;
+        };
+
+        std::vector<uint32_t> offsets;
+        std::vector<uint32_t> elements;
+        std::vector<uint32_t> pendingFirst;
+        std::vector<uint32_t> pendingLast;
+        std::vector<PendingEntry> pending;
+
+        void resize(std::size_t count);
+        void insert(std::size_t cell, uint32_t element);
+        void compact();
+        std::size_t getMemoryUsage() const;
+
+        // Calls fn for the elements of the cell until it returns true, and
+        // returns whether it did.
+        template <class Fn>
+        bool forEach(std::size_t cell, Fn&& fn) const {
+            for (uint32_t i = offsets[cell], end = offsets[cell + 1]; i < end; ++i) {
+                if (fn(elements[i])) {
+                    return true;
+                }
+            }
+            for (uint32_t entry = pendingFirst[cell]; entry != noEntry; entry = pending[entry].next) {
+                if (fn(pending[entry].element)) {
+                    return true;
+                }
+            }
+            return false;
+        }
+    };
+
     bool noIntersection(const BBox& queryBBox) const;
     bool completeIntersection(const BBox& queryBBox) const;
     BBox convertToBox(const BCircle& circle) const;
 
-    void query(const BBox&, std::function<bool (const T&, const BBox&)>) const;
-    void query(const BCircle&, std::function<bool (const T&, const BBox&)>) const;
+    template <class Fn>
+    void query(const BBox&, Fn&&) const;
+    template <class Fn>
+    void query(const BCircle&, Fn&&) const;
+
+    // Calls fn for every element in the cells covered by the box, visiting
+    // each element at most once, until fn returns true.
+    template <class BoxFn, class CircleFn>
+    void queryCells(const BBox&, BoxFn&&, CircleFn&&) const;
 
     std::size_t convertToXCellCoord(const float x) const;
     std::size_t convertToYCellCoord(const float y) const;
@@ -99,9 +164,216 @@ private:
     std::vector<std::pair<T, BBox>> boxElements;
     std::vector<std::pair<T, BCircle>> circleElements;
     
-    std::vector<std::vector<size_t>> boxCells;
-    std::vector<std::vector<size_t>> circleCells;
+    // Compacted by queries.
+    mutable Cells boxCells;
+    mutable Cells circleCells;
 
+    // An element was visited by the current query if its entry equals the
+    // query generation. This replaces per-query hash sets, but makes queries
+    // unsafe to run concurrently on the same index.
+    mutable std::vector<uint32_t> boxVisits;
+    mutable std::vector<uint32_t> circleVisits;
+    mutable uint32_t queryGeneration = 0;
 };
 
+template <class T>
+constexpr uint32_t GridIndex<T>::noEntry;
+
+template <class T>
+template <class Predicate>
+bool GridIndex<T>::hitTest(const BBox& queryBBox, Predicate&& predicate) const {
+    bool hit = false;
+    query(queryBBox, [&](const T& t, const BBox&) -> bool {
+        if (predicate(t)) {
+            hit = true;
+            return true;
+        }
+        return false;
+    });
+    return hit;
+}
+
+template <class T>
+template <class Predicate>
+bool GridIndex<T>::hitTest(const BCircle& queryBCircle, Predicate&& predicate) const {
+    bool hit = false;
+    query(queryBCircle, [&](const T& t, const BBox&) -> bool {
+        if (predicate(t)) {
+            hit = true;
+            return true;
+        }
+        return false;
+    });
+    return hit;
+}
+
+template <class T>
+inline bool GridIndex<T>::noIntersection(const BBox& queryBBox) const {
+    return queryBBox.max.x < 0 || queryBBox.min.x >= width || queryBBox.max.y < 0 || queryBBox.min.y >= height;
+}
+
+template <class T>
+inline bool GridIndex<T>::completeIntersection(const BBox& queryBBox) const {
+    return queryBBox.min.x <= 0 && queryBBox.min.y <= 0 && width <= queryBBox.max.x && height <= queryBBox.max.y;
+}
+
+template <class T>
+inline typename GridIndex<T>::BBox GridIndex<T>::convertToBox(const BCircle& circle) const {
+    return BBox{{circle.center.x - circle.radius, circle.center.y - circle.radius},
+                {circle.center.x + circle.radius, circle.center.y + circle.radius}};
+}
+
+template <class T>
+template <class Fn>
+void GridIndex<T>::query(const BBox& queryBBox, Fn&& resultFn) const {
+    if (noIntersection(queryBBox)) {
+        return;
+    } else if (completeIntersection(queryBBox)) {
+        for (auto& element : boxElements) {
+            if (resultFn(element.first, element.second)) {
+                return;
+            }
+        }
+        for (auto& element : circleElements) {
+            if (resultFn(element.first, convertToBox(element.second))) {
+                return;
+            }
+        }
+        return;
+    }
+
+    queryCells(queryBBox,
+        [&](const std::pair<T, BBox>& pair) {
+            return boxesCollide(queryBBox, pair.second) && resultFn(pair.first, pair.second);
+        },
+        [&](const std::pair<T, BCircle>& pair) {
+            return circleAndBoxCollide(pair.second, queryBBox) && resultFn(pair.first, convertToBox(pair.second));
+        });
+}
+
+template <class T>
+template <class Fn>
+void GridIndex<T>::query(const BCircle& queryBCircle, Fn&& resultFn) const {
+    BBox queryBBox = convertToBox(queryBCircle);
+    if (noIntersection(queryBBox)) {
+        return;
+    } else if (completeIntersection(queryBBox)) {
+        for (auto& element : boxElements) {
+            if (resultFn(element.first, element.second)) {
+                return;
+            }
+        }
+        for (auto& element : circleElements) {
+            if (resultFn(element.first, convertToBox(element.second))) {
+                return;
+            }
+        }
+        return;
+    }
+
+    queryCells(queryBBox,
+        [&](const std::pair<T, BBox>& pair) {
+            return circleAndBoxCollide(queryBCircle, pair.second) && resultFn(pair.first, pair.second);
+        },
+        [&](const std::pair<T, BCircle>& pair) {
+            return circlesCollide(queryBCircle, pair.second) && resultFn(pair.first, convertToBox(pair.second));
+        });
+}
+
+template <class T>
+template <class BoxFn, class CircleFn>
+void GridIndex<T>::queryCells(const BBox& queryBBox, BoxFn&& boxFn, CircleFn&& circleFn) const {
+    if (++queryGeneration == 0) {
+        std::fill(boxVisits.begin(), boxVisits.end(), 0);
+        std::fill(circleVisits.begin(), circleVisits.end(), 0);
+        queryGeneration = 1;
+    }
+    const uint32_t generation = queryGeneration;
+
+    boxCells.compact();
+    circleCells.compact();
+
+    auto cx1 = convertToXCellCoord(queryBBox.min.x);
+    auto cy1 = convertToYCellCoord(queryBBox.min.y);
+    auto cx2 = convertToXCellCoord(queryBBox.max.x);
+    auto cy2 = convertToYCellCoord(queryBBox.max.y);
+
+    std::size_t x, y, cellIndex;
+    for (x = cx1; x <= cx2; ++x) {
+        for (y = cy1; y <= cy2; ++y) {
+            cellIndex = xCellCount * y + x;
+            // Look up boxes
+            if (boxCells.forEach(cellIndex, [&](uint32_t uid) {
+                    if (boxVisits[uid] == generation) {
+                        return false;
+                    }
+                    boxVisits[uid] = generation;
+                    return bool(boxFn(boxElements[uid]));
+                })) {
+                return;
+            }
+
+            // Look up circles
+            if (circleCells.forEach(cellIndex, [&](uint32_t uid) {
+                    if (circleVisits[uid] == generation) {
+                        return false;
+                    }
+                    circleVisits[uid] = generation;
+                    return bool(circleFn(circleElements[uid]));
+                })) {
+                return;
+            }
+        }
+    }
+}
+
+template <class T>
+inline std::size_t GridIndex<T>::convertToXCellCoord(const float x) const {
+    return util::max(0.0, util::min(xCellCount - 1.0, std::floor(x * xScale)));
+}
+
+template <class T>
+inline std::size_t GridIndex<T>::convertToYCellCoord(const float y) const {
+    return util::max(0.0, util::min(yCellCount - 1.0, std::floor(y * yScale)));
+}
+
+template <class T>
+inline bool GridIndex<T>::boxesCollide(const BBox& first, const BBox& second) const {
+    return first.min.x <= second.max.x &&
+           first.min.y <= second.max.y &&
+           first.max.x >= second.min.x &&
+           first.max.y >= second.min.y;
+}
+
+template <class T>
+inline bool GridIndex<T>::circlesCollide(const BCircle& first, const BCircle& second) const {
+    auto dx = second.center.x - first.center.x;
+    auto dy = second.center.y - first.center.y;
+    auto bothRadii = first.radius + second.radius;
+    return (bothRadii * bothRadii) > (dx * dx + dy * dy);
+}
+
+template <class T>
+inline bool GridIndex<T>::circleAndBoxCollide(const BCircle& circle, const BBox& box) const {
+    auto halfRectWidth = (box.max.x - box.min.x) / 2;
+    auto distX = std::abs(circle.center.x - (box.min.x + halfRectWidth));
+    if (distX > (halfRectWidth + circle.radius)) {
+        return false;
+    }
+
+    auto halfRectHeight = (box.max.y - box.min.y) / 2;
+    auto distY = std::abs(circle.center.y - (box.min.y + halfRectHeight));
+    if (distY > (halfRectHeight + circle.radius)) {
+        return false;
+    }
+
+    if (distX <= halfRectWidth || distY <= halfRectHeight) {
+        return true;
+    }
+
+    auto dx = distX - halfRectWidth;
+    auto dy = distY - halfRectHeight;
+    return (dx * dx + dy * dy) <= (circle.radius * circle.radius);
+}
+
 } // namespace mbgl
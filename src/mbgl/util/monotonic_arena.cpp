@@ -0,0 +1,107 @@
+#include <mbgl/util/monotonic_arena.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+
+namespace mbgl {
+namespace util {
+
+namespace {
+
+// Blocks grow geometrically up to this size, so that large tiles need few of
+// them without small ones reserving much memory.
+constexpr std::size_t maximumBlockSize = 1024 * 1024;
+
+std::size_t alignmentPadding(const unsigned char* ptr, std::size_t alignment) {
+    const auto address = reinterpret_cast<std::uintptr_t>(ptr);
+    return (alignment - address % alignment) % alignment;
+}
+
+} // namespace
+
+MonotonicArena::MonotonicArena(std::size_t initialBlockSize)
+    : nextBlockSize(initialBlockSize) {
+}
+
+MonotonicArena::MonotonicArena(MonotonicArena&& other) noexcept
+    : blocks(std::move(other.blocks)),
+      destructors(other.destructors),
+      current(other.current),
+      remaining(other.remaining),
+      nextBlockSize(other.nextBlockSize) {
+    other.blocks.clear();
+    other.destructors = nullptr;
+    other.current = nullptr;
+    other.remaining = 0;
+}
+
+MonotonicArena::~MonotonicArena() {
+    destroyObjects();
+}
+
+void* MonotonicArena::allocate(std::size_t size, std::size_t alignment) {
+    assert(alignment != 0 && (alignment & (alignment - 1)) == 0);
+
+    std::size_t padding = current ? alignmentPadding(current, alignment) : 0;
+    if (!current || padding + size > remaining) {
+        addBlock(size + alignment);
+        padding = alignmentPadding(current, alignment);
+    }
+
+    unsigned char* result = current + padding;
+    current = result + size;
+    remaining -= padding + size;
+    return result;
+}
+
+void MonotonicArena::reset() {
+    destroyObjects();
+
+    if (blocks.empty()) {
+        return;
+    }
+
+    auto largest = std::max_element(blocks.begin(), blocks.end(), [](const Block& a, const Block& b) {
+        return a.size < b.size;
+    });
+    Block kept = std::move(*largest);
+    blocks.clear();
+    current = kept.data.get();
+    remaining = kept.size;
+    blocks.push_back(std::move(kept));
+}
+
+std::size_t MonotonicArena::getCapacity() const {
+    std::size_t capacity = 0;
+    for (const auto& block : blocks) {
+        capacity += block.size;
+    }
+    return capacity;
+}
+
+void MonotonicArena::addBlock(std::size_t minimumSize) {
+    const std::size_t size = std::max(nextBlockSize, minimumSize);
+    nextBlockSize = std::min(nextBlockSize * 2, maximumBlockSize);
+
+    // Not value-initialized, unlike std::make_unique<unsigned char[]>.
+    blocks.push_back({ std::unique_ptr<unsigned char[]>(new unsigned char[size]), size });
+    current = blocks.back().data.get();
+    remaining = size;
+}
+
+void MonotonicArena::addDestructor(void* object, void (*destroy)(void*)) {
+    void* memory = allocate(sizeof(Destructor), alignof(Destructor));
+    destructors = new (memory) Destructor { object, destroy, destructors };
+}
+
+void MonotonicArena::destroyObjects() {
+    // The list starts with the most recently created object.
+    for (Destructor* destructor = destructors; destructor; destructor = destructor->next) {
+        destructor->destroy(destructor->object);
+    }
+    destructors = nullptr;
+}
+
+} // namespace util
+} // namespace mbgl
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace mbgl {
+namespace util {
+
+// A bump allocator for temporaries that share a lifetime, such as the features
+// read while parsing a layer group of a tile. Memory is handed out from a few
+// large blocks and only given back all at once, when the arena is reset or
+// destroyed. Objects created with make() are destroyed at that point, in the
+// reverse order of their creation. Not thread-safe.
+class MonotonicArena {
+public:
+    explicit MonotonicArena(std::size_t initialBlockSize = 16 * 1024);
+    MonotonicArena(MonotonicArena&&) noexcept;
+    MonotonicArena(const MonotonicArena&) = delete;
+    MonotonicArena& operator=(const MonotonicArena&) = delete;
+    MonotonicArena& operator=(MonotonicArena&&) = delete;
+    ~MonotonicArena();
+
+    void* allocate(std::size_t size, std::size_t alignment = alignof(std::max_align_t));
+
+    template <class T, class... Args>
+    T* make(Args&&... args) {
+        void* memory = allocate(sizeof(T), alignof(T));
+        T* object = new (memory) T(std::forward<Args>(args)...);
+        if (!std::is_trivially_destructible<T>::value) {
+            addDestructor(object, [](void* ptr) { static_cast<T*>(ptr)->~T(); });
+        }
+        return object;
+    }
+
+    // Destroys the objects created in the arena, and keeps the largest block
+    // for the allocations that follow.
+    void reset();
+
+    // The total size of the blocks currently held by the arena.
+    std::size_t getCapacity() const;
+
+private:
+    struct Block {
+        std::unique_ptr<unsigned char[]> data;
+        std::size_t size;
+    };
+
+    // Destructors to run are kept in a list allocated from the arena itself.
+    struct Destructor {
+        void* object;
+        void (*destroy)(void*);
+        Destructor* next;
+    };
+
+    void addBlock(std::size_t minimumSize);
+    void addDestructor(void* object, void (*destroy)(void*));
+    void destroyObjects();
+
+    std::vector<Block> blocks;
+    Destructor* destructors = nullptr;
+    unsigned char* current = nullptr;
+    std::size_t remaining = 0;
+    std::size_t nextBlockSize;
+};
+
+} // namespace util
+} // namespace mbgl
@@ -0,0 +1,77 @@
+#include <mbgl/util/parallel_for.hpp>
+#include <mbgl/actor/scheduler.hpp>
+
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <memory>
+#include <mutex>
+
+namespace mbgl {
+namespace util {
+
+namespace {
+
+class ParallelForState {
+public:
+    ParallelForState(std::size_t count_, const std::function<void(std::size_t)>& fn_)
+        : count(count_), fn(fn_) {}
+
+    // Runs calls until there are none left to claim. Helpers that start late
+    // find nothing to do and never touch |fn|, which might be gone by then.
+    void run() {
+        for (std::size_t index = next++; index < count; index = next++) {
+            std::exception_ptr error;
+            try {
+                fn(index);
+            } catch (...) {
+                error = std::current_exception();
+            }
+
+            std::lock_guard<std::mutex> lock(mutex);
+            if (error && !firstError) {
+                firstError = error;
+            }
+            if (++finished == count) {
+                cv.notify_all();
+            }
+        }
+    }
+
+    void wait() {
+        std::unique_lock<std::mutex> lock(mutex);
+        cv.wait(lock, [this] { return finished == count; });
+        if (firstError) {
+            std::rethrow_exception(firstError);
+        }
+    }
+
+private:
+    const std::size_t count;
+    const std::function<void(std::size_t)>& fn;
+
+    std::atomic<std::size_t> next{0};
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::size_t finished = 0;
+    std::exception_ptr firstError;
+};
+
+} // namespace
+
+void parallelFor(Scheduler& scheduler, std::size_t count, const std::function<void(std::size_t)>& fn) {
+    if (count == 0) {
+        return;
+    }
+
+    auto state = std::make_shared<ParallelForState>(count, fn);
+    for (std::size_t i = 1; i < count; ++i) {
+        scheduler.schedule([state] { state->run(); });
+    }
+
+    state->run();
+    state->wait();
+}
+
+} // namespace util
+} // namespace mbgl
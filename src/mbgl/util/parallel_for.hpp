@@ -0,0 +1,20 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+
+namespace mbgl {
+
+class Scheduler;
+
+namespace util {
+
+// Calls |fn| once for every index in [0, count), spreading the calls over the
+// given scheduler. The calling thread takes part in the work and only waits for
+// calls that another thread has already started, so this is safe to use from
+// within a task running on the very same scheduler. Returns once all calls have
+// finished; the first exception thrown by |fn| is rethrown on the calling thread.
+void parallelFor(Scheduler&, std::size_t count, const std::function<void(std::size_t)>& fn);
+
+} // namespace util
+} // namespace mbgl
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <mbgl/util/size.hpp>
+
+#include <mapbox/shelf-pack.hpp>
+
+#include <algorithm>
+#include <cstdint>
+
+namespace mbgl {
+namespace util {
+
+// Packs a bin of the given size into a ShelfPack created without the autoResize
+// option. The pack is grown the way autoResize would grow it, but never beyond
+// `maximumSize`. Returns nullptr if the bin doesn't fit.
+inline mapbox::Bin* packWithinSize(mapbox::ShelfPack& pack, int32_t id, int32_t w, int32_t h, Size maximumSize) {
+    const auto maximumWidth = static_cast<int32_t>(maximumSize.width);
+    const auto maximumHeight = static_cast<int32_t>(maximumSize.height);
+
+    while (true) {
+        if (mapbox::Bin* bin = pack.packOne(id, w, h)) {
+            return bin;
+        }
+
+        const int32_t width = pack.width();
+        const int32_t height = pack.height();
+        int32_t newWidth = width;
+        int32_t newHeight = height;
+        if (width <= height || w > width) {
+            newWidth = std::min(std::max(w, width) * 2, maximumWidth);
+        }
+        if (height < width || h > height) {
+            newHeight = std::min(std::max(h, height) * 2, maximumHeight);
+        }
+        if (newWidth == width && newHeight == height) {
+            // The dimension autoResize would grow is at its maximum already.
+            if (height < maximumHeight) {
+                newHeight = std::min(std::max(h, height) * 2, maximumHeight);
+            } else if (width < maximumWidth) {
+                newWidth = std::min(std::max(w, width) * 2, maximumWidth);
+            } else {
+                return nullptr;
+            }
+        }
+        pack.resize(newWidth, newHeight);
+    }
+}
+
+} // namespace util
+} // namespace mbgl
@@ -2,51 +2,237 @@
 
 #include <mbgl/util/platform.hpp>
 #include <mbgl/util/string.hpp>
+#include <mbgl/util/thread_local.hpp>
 #include <mbgl/platform/thread.hpp>
 
+#include <algorithm>
+#include <cassert>
+#include <limits>
+
 namespace mbgl {
 
+namespace {
+
+// The queue owned by the worker thread we're currently running on, if any.
+util::ThreadLocal<void>& currentQueue() {
+    static util::ThreadLocal<void> queue;
+    return queue;
+}
+
+std::atomic<std::size_t> defaultThreadCount{0};
+
+double currentPriority(const std::weak_ptr<const TaskPriority>& priority) {
+    // Tasks whose priority has expired belong to a destroyed mailbox and are
+    // flushed out first.
+    auto locked = priority.lock();
+    return locked ? locked->load() : -std::numeric_limits<double>::infinity();
+}
+
+// Heap order that puts the most urgent task at the front.
+template <typename Task>
+bool lessUrgent(const Task& a, const Task& b) {
+    return a.key > b.key;
+}
+
+} // namespace
+
+ThreadedSchedulerBase::ThreadedSchedulerBase(std::size_t threadCount) {
+    assert(threadCount > 0);
+    queues.reserve(threadCount);
+    for (std::size_t i = 0u; i < threadCount; ++i) {
+        queues.emplace_back(std::make_unique<WorkerQueue>(*this));
+    }
+}
+
 ThreadedSchedulerBase::~ThreadedSchedulerBase() = default;
 
 void ThreadedSchedulerBase::terminate() {
     {
-        std::lock_guard<std::mutex> lock(mutex);
+        std::lock_guard<std::mutex> lock(idleMutex);
         terminated = true;
     }
-    cv.notify_all();
+    idleCv.notify_all();
+}
+
+void ThreadedSchedulerBase::WorkerQueue::updatePriorities() {
+    const std::size_t generation = TaskPriority::generation();
+    if (generation == priorityGeneration) return;
+    priorityGeneration = generation;
+
+    for (auto& task : prioritizedTasks) {
+        task.key = currentPriority(task.priority);
+    }
+    std::make_heap(prioritizedTasks.begin(), prioritizedTasks.end(), lessUrgent<PrioritizedTask>);
+}
+
+std::function<void()> ThreadedSchedulerBase::WorkerQueue::popPrioritized() {
+    if (prioritizedTasks.empty()) return {};
+    updatePriorities();
+    std::pop_heap(prioritizedTasks.begin(), prioritizedTasks.end(), lessUrgent<PrioritizedTask>);
+    auto function = std::move(prioritizedTasks.back().function);
+    prioritizedTasks.pop_back();
+    return function;
+}
+
+std::function<void()> ThreadedSchedulerBase::pop(std::size_t index, bool prioritizedFirst) {
+    WorkerQueue& queue = *queues[index];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (prioritizedFirst || queue.tasks.empty()) {
+        if (auto function = queue.popPrioritized()) return function;
+    }
+    if (queue.tasks.empty()) return {};
+    auto function = std::move(queue.tasks.front());
+    queue.tasks.pop_front();
+    return function;
+}
+
+std::function<void()> ThreadedSchedulerBase::steal(std::size_t index, bool prioritizedFirst) {
+    if (prioritizedFirst) {
+        if (auto function = stealPrioritized(index)) return function;
+    }
+
+    const std::size_t count = queues.size();
+    for (std::size_t i = 1u; i < count; ++i) {
+        WorkerQueue& victim = *queues[(index + i) % count];
+        std::unique_lock<std::mutex> lock(victim.mutex, std::try_to_lock);
+        if (!lock || victim.tasks.empty()) continue;
+        auto function = std::move(victim.tasks.back());
+        victim.tasks.pop_back();
+        return function;
+    }
+
+    return prioritizedFirst ? std::function<void()>() : stealPrioritized(index);
+}
+
+std::function<void()> ThreadedSchedulerBase::stealPrioritized(std::size_t index) {
+    // Sample the most urgent task of every sibling that isn't busy and take
+    // the best one.
+    const std::size_t count = queues.size();
+    WorkerQueue* best = nullptr;
+    double bestKey = 0;
+    for (std::size_t i = 1u; i < count; ++i) {
+        WorkerQueue& victim = *queues[(index + i) % count];
+        std::unique_lock<std::mutex> lock(victim.mutex, std::try_to_lock);
+        if (!lock || victim.prioritizedTasks.empty()) continue;
+        victim.updatePriorities();
+        const double key = victim.prioritizedTasks.front().key;
+        if (!best || key < bestKey) {
+            best = &victim;
+            bestKey = key;
+        }
+    }
+    if (!best) return {};
+
+    std::unique_lock<std::mutex> lock(best->mutex, std::try_to_lock);
+    if (!lock) return {};
+    return best->popPrioritized();
 }
 
 std::thread ThreadedSchedulerBase::makeSchedulerThread(size_t index) {
     return std::thread([this, index]() {
         platform::setCurrentThreadName(std::string{"Worker "} + util::toString(index + 1));
         platform::attachThread();
+        currentQueue().set(queues[index].get());
 
+        // Alternate between prioritized and regular tasks, so that neither
+        // kind starves the other.
+        bool prioritizedFirst = false;
         while (true) {
-            std::unique_lock<std::mutex> lock(mutex);
+            if (terminated) break;
 
-            cv.wait(lock, [this] { return !queue.empty() || terminated; });
+            auto function = pop(index, prioritizedFirst);
+            if (!function) function = steal(index, prioritizedFirst);
 
-            if (terminated) {
-                platform::detachThread();
-                return;
+            if (function) {
+                pendingTasks--;
+                function();
+                prioritizedFirst = !prioritizedFirst;
+                continue;
             }
 
-            auto function = std::move(queue.front());
-            queue.pop();
-            lock.unlock();
-            if (function) function();
+            std::unique_lock<std::mutex> lock(idleMutex);
+            idleWorkers++;
+            // A task counted in |pendingTasks| might still sit in a deque whose
+            // lock we failed to acquire while stealing, so only sleep when
+            // there is genuinely nothing left to do.
+            idleCv.wait(lock, [this] { return pendingTasks > 0 || terminated; });
+            idleWorkers--;
         }
+
+        currentQueue().set(nullptr);
+        platform::detachThread();
     });
 }
 
+void ThreadedSchedulerBase::wakeUpWorker() {
+    // Pairs with the |idleWorkers| increment in the worker loop: either the
+    // worker sees the new pending task before going to sleep, or we see it
+    // waiting and notify it.
+    if (idleWorkers > 0) {
+        { std::lock_guard<std::mutex> lock(idleMutex); }
+        idleCv.notify_one();
+    }
+}
+
+ThreadedSchedulerBase::WorkerQueue& ThreadedSchedulerBase::queueForScheduling() {
+    auto* current = static_cast<WorkerQueue*>(currentQueue().get());
+    return current && &current->owner == this ? *current : *queues[nextQueue++ % queues.size()];
+}
+
 void ThreadedSchedulerBase::schedule(std::function<void()> fn) {
     assert(fn);
+
+    WorkerQueue& queue = queueForScheduling();
     {
-        std::lock_guard<std::mutex> lock(mutex);
-        queue.push(std::move(fn));
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        queue.tasks.push_back(std::move(fn));
     }
 
-    cv.notify_one();
+    pendingTasks++;
+    wakeUpWorker();
+}
+
+void ThreadedSchedulerBase::scheduleWithPriority(std::function<void()> fn,
+                                                 std::weak_ptr<const TaskPriority> priority) {
+    assert(fn);
+
+    WorkerQueue& queue = queueForScheduling();
+    {
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        const double key = currentPriority(priority);
+        queue.prioritizedTasks.push_back({std::move(fn), std::move(priority), key});
+        std::push_heap(queue.prioritizedTasks.begin(), queue.prioritizedTasks.end(), lessUrgent<PrioritizedTask>);
+    }
+
+    pendingTasks++;
+    wakeUpWorker();
+}
+
+ThreadedScheduler::ThreadedScheduler(std::size_t threadCount) : ThreadedSchedulerBase(threadCount) {
+    threads.reserve(threadCount);
+    for (std::size_t i = 0u; i < threadCount; ++i) {
+        threads.emplace_back(makeSchedulerThread(i));
+    }
+}
+
+ThreadedScheduler::~ThreadedScheduler() {
+    terminate();
+    for (auto& thread : threads) {
+        thread.join();
+    }
+}
+
+// static
+std::size_t ThreadPool::getDefaultThreadCount() {
+    if (std::size_t count = defaultThreadCount) {
+        return count;
+    }
+    return std::max<std::size_t>(4u, std::thread::hardware_concurrency());
+}
+
+// static
+void ThreadPool::setDefaultThreadCount(std::size_t count) {
+    defaultThreadCount = count;
 }
 
 } // namespace mbgl
@@ -3,68 +3,126 @@
 #include <mbgl/actor/mailbox.hpp>
 #include <mbgl/actor/scheduler.hpp>
 
-#include <array>
+#include <atomic>
 #include <condition_variable>
+#include <deque>
+#include <memory>
 #include <mutex>
-#include <queue>
 #include <thread>
+#include <vector>
 
 namespace mbgl {
 
+/**
+ * @brief ThreadedSchedulerBase implements a work-stealing task queue.
+ *
+ * Every worker thread owns a deque guarded by its own mutex. Tasks scheduled
+ * from a worker thread go to that worker's deque, tasks scheduled from other
+ * threads are distributed round-robin. An idle worker first drains its own
+ * deque (oldest first) and then steals the most recently queued tasks from
+ * its siblings, so there is no single lock that all producers and consumers
+ * contend on.
+ *
+ * Tasks scheduled with a priority go to a heap next to the deque, and workers
+ * alternate between the two so that neither kind of task starves the other.
+ * The heaps are ordered by the priorities the tasks had when the heap was last
+ * built, and are rebuilt when a worker finds that a priority changed since, so
+ * pending tasks can be re-prioritized in place. Stealing workers take the most
+ * urgent of their siblings' prioritized tasks.
+ */
 class ThreadedSchedulerBase : public Scheduler {
 public:
     void schedule(std::function<void()>) override;
+    void scheduleWithPriority(std::function<void()>, std::weak_ptr<const TaskPriority>) override;
+
+    std::size_t getThreadCount() const { return queues.size(); }
 
 protected:
-    ThreadedSchedulerBase() = default;
+    explicit ThreadedSchedulerBase(std::size_t threadCount);
     ~ThreadedSchedulerBase() override;
 
     void terminate();
     std::thread makeSchedulerThread(size_t index);
 
-    std::queue<std::function<void()>> queue;
-    std::mutex mutex;
-    std::condition_variable cv;
-    bool terminated{false};
+private:
+    struct PrioritizedTask {
+        std::function<void()> function;
+        std::weak_ptr<const TaskPriority> priority;
+        double key;
+    };
+
+    struct WorkerQueue {
+        explicit WorkerQueue(ThreadedSchedulerBase& owner_) : owner(owner_) {}
+
+        // Rebuilds the heap if any priority changed since it was last built.
+        void updatePriorities();
+        std::function<void()> popPrioritized();
+
+        ThreadedSchedulerBase& owner;
+        std::deque<std::function<void()>> tasks;
+        // A min-heap on PrioritizedTask::key.
+        std::vector<PrioritizedTask> prioritizedTasks;
+        std::size_t priorityGeneration = 0;
+        std::mutex mutex;
+    };
+
+    WorkerQueue& queueForScheduling();
+    std::function<void()> pop(std::size_t index, bool prioritizedFirst);
+    std::function<void()> steal(std::size_t index, bool prioritizedFirst);
+    std::function<void()> stealPrioritized(std::size_t index);
+    void wakeUpWorker();
+
+    std::vector<std::unique_ptr<WorkerQueue>> queues;
+    std::atomic<std::size_t> nextQueue{0};
+    std::atomic<std::size_t> pendingTasks{0};
+    std::atomic<std::size_t> idleWorkers{0};
+
+    std::mutex idleMutex;
+    std::condition_variable idleCv;
+    std::atomic<bool> terminated{false};
 };
 
 /**
  * @brief ThreadScheduler implements Scheduler interface using a lightweight event loop
  *
- * @tparam N number of threads
- *
- * Note: If N == 1 all scheduled tasks are guaranteed to execute consequently;
+ * Note: If the thread count is 1 all scheduled tasks are guaranteed to execute consequently;
  * otherwise, some of the scheduled tasks might be executed in parallel.
  */
-template <std::size_t N>
 class ThreadedScheduler : public ThreadedSchedulerBase {
 public:
-    ThreadedScheduler() {
-        for (std::size_t i = 0u; i < N; ++i) {
-            threads[i] = makeSchedulerThread(i);
-        }
-    }
-
-    ~ThreadedScheduler() override {
-        terminate();
-        for (auto& thread : threads) {
-            thread.join();
-        }
-    }
+    explicit ThreadedScheduler(std::size_t threadCount);
+    ~ThreadedScheduler() override;
 
     mapbox::base::WeakPtr<Scheduler> makeWeakPtr() override { return weakFactory.makeWeakPtr(); }
 
 private:
-    std::array<std::thread, N> threads;
+    std::vector<std::thread> threads;
     mapbox::base::WeakPtrFactory<Scheduler> weakFactory{this};
-    static_assert(N > 0, "Thread count must be more than zero.");
 };
 
-class SequencedScheduler : public ThreadedScheduler<1> {};
+class SequencedScheduler : public ThreadedScheduler {
+public:
+    SequencedScheduler() : ThreadedScheduler(1) {}
+};
 
 template <std::size_t extra>
-using ParallelScheduler = ThreadedScheduler<1 + extra>;
+class ParallelScheduler : public ThreadedScheduler {
+public:
+    ParallelScheduler() : ThreadedScheduler(1 + extra) {}
+};
+
+class ThreadPool : public ThreadedScheduler {
+public:
+    explicit ThreadPool(std::size_t threadCount = getDefaultThreadCount()) : ThreadedScheduler(threadCount) {}
 
-class ThreadPool : public ParallelScheduler<3> {};
+    // The number of threads used by default constructed pools, including the
+    // shared pool returned by Scheduler::GetBackground(). Defaults to the
+    // number of hardware threads, but never less than four.
+    static std::size_t getDefaultThreadCount();
+
+    // Overrides the default thread count. Only affects pools created after
+    // this call; passing 0 restores the hardware based default.
+    static void setDefaultThreadCount(std::size_t);
+};
 
 } // namespace mbgl
@@ -8,6 +8,7 @@
 
 #include <functional>
 #include <list>
+#include <limits>
 
 namespace mbgl {
 
@@ -204,13 +205,8 @@ uint64_t tileCount(const LatLngBounds& bounds, uint8_t zoom){
 }
 
 uint64_t tileCount(const Geometry<double>& geometry, uint8_t z) {
-    uint64_t tileCount = 0;
-
     TileCover tc(geometry, z, true);
-    while (tc.next()) {
-        tileCount++;
-    };
-    return tileCount;
+    return tc.skip(std::numeric_limits<uint64_t>::max());
 }
 
 TileCover::TileCover(const LatLngBounds&bounds_, uint8_t z) {
@@ -247,5 +243,9 @@ bool TileCover::hasNext() {
     return impl->hasNext();
 }
 
+uint64_t TileCover::skip(uint64_t count) {
+    return impl->skip(count);
+}
+
 } // namespace util
 } // namespace mbgl
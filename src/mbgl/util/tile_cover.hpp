@@ -26,6 +26,11 @@ public:
     optional<UnwrappedTileID> next();
     bool hasNext();
 
+    // Skips up to the given number of tiles without producing them, and
+    // returns the number of tiles that were skipped. Runs in time
+    // proportional to the number of rows and spans, not tiles.
+    uint64_t skip(uint64_t count);
+
 private:
     class Impl;
     std::unique_ptr<Impl> impl;
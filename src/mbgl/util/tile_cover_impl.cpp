@@ -356,5 +356,24 @@ optional<UnwrappedTileID> TileCover::Impl::next() {
     return UnwrappedTileID(zoom, x, y);
 }
 
+// Skips whole spans at once: all but the last tile of a span are skipped by
+// moving tileX, and next() then steps over the last one, advancing to the next
+// span or row exactly like regular iteration does.
+uint64_t TileCover::Impl::skip(uint64_t count) {
+    uint64_t skipped = 0;
+    while (skipped < count && hasNext()) {
+        const int32_t spanEnd = tileXSpans.front().second;
+        const auto remaining = static_cast<uint64_t>(spanEnd - tileX);
+        if (count - skipped < remaining) {
+            tileX += static_cast<int32_t>(count - skipped);
+            return count;
+        }
+        skipped += remaining;
+        tileX = spanEnd - 1;
+        next();
+    }
+    return skipped;
+}
+
 } // namespace util
 } // namespace mbgl
@@ -83,6 +83,7 @@ public:
 
     optional<UnwrappedTileID> next();
     bool hasNext() const;
+    uint64_t skip(uint64_t count);
 
 private:
     using TileSpans = std::queue<std::pair<int32_t, int32_t>>;
@@ -26,6 +26,8 @@
 #include <mbgl/style/sources/image_source.hpp>
 #include <mbgl/util/color.hpp>
 
+#include <algorithm>
+
 using namespace mbgl;
 using namespace mbgl::style;
 using namespace std::literals::string_literals;
@@ -347,6 +349,8 @@ TEST(Map, DefaultMapOptions) {
     EXPECT_EQ(options.constrainMode(), ConstrainMode::HeightOnly);
     EXPECT_EQ(options.northOrientation(), NorthOrientation::Upwards);
     EXPECT_TRUE(options.crossSourceCollisions());
+    EXPECT_FALSE(options.parallelTileParsing());
+    EXPECT_EQ(options.tileCacheMemoryLimit(), 0u);
     EXPECT_EQ(options.size().width, 256);
     EXPECT_EQ(options.size().height, 256);
     EXPECT_EQ(options.pixelRatio(), 1);
@@ -1054,3 +1058,145 @@ TEST(Map, NoHangOnMissingImage) {
     // The test passes if the following call does not hang.
     test.frontend.render(test.map);
 }
+
+namespace {
+
+const std::string symbolStyle = R"STYLE({
+  "version": 8,
+  "sources": {
+    "points": {
+      "type": "geojson",
+      "data": {
+        "type": "FeatureCollection",
+        "features": [
+          { "type": "Feature", "properties": { "name": "a" }, "geometry": { "type": "Point", "coordinates": [ -20, 20 ] } },
+          { "type": "Feature", "properties": { "name": "b" }, "geometry": { "type": "Point", "coordinates": [ 20, 20 ] } },
+          { "type": "Feature", "properties": { "name": "c" }, "geometry": { "type": "Point", "coordinates": [ -20, -20 ] } },
+          { "type": "Feature", "properties": { "name": "d" }, "geometry": { "type": "Point", "coordinates": [ 20, -20 ] } }
+        ]
+      }
+    }
+  },
+  "layers": [{
+    "id": "symbols",
+    "type": "symbol",
+    "source": "points",
+    "layout": {
+      "icon-image": "test-icon",
+      "icon-allow-overlap": true
+    }
+  }]
+})STYLE";
+
+// The names of the symbols shown by the current placement, sorted.
+std::vector<std::string> visibleSymbols(HeadlessFrontend& frontend) {
+    const Size size = frontend.getSize();
+    std::vector<std::string> names;
+    for (const auto& feature : frontend.getRenderer()->queryRenderedFeatures(
+             ScreenBox { { 0, 0 }, { double(size.width), double(size.height) } }, {{{ "symbols" }}, {}})) {
+        names.push_back(feature.properties.at("name").get<std::string>());
+    }
+    std::sort(names.begin(), names.end());
+    return names;
+}
+
+} // namespace
+
+TEST(Map, BackgroundSymbolPlacement) {
+    using namespace std::chrono_literals;
+
+    MapTest<> test { 1, MapMode::Continuous };
+    test.frontend.getRenderer()->setBackgroundSymbolPlacement(true);
+
+    util::Timer emergencyShutoff;
+    emergencyShutoff.start(10s, 0s, [&] {
+        test.runLoop.stop();
+        FAIL() << "Did not stop rendering";
+    });
+
+    bool anyPlacementCommitted = false;
+    bool placementCommitted = false;
+    test.observer.didFinishRenderingFrameCallback = [&] (MapObserver::RenderFrameStatus status) {
+        anyPlacementCommitted = anyPlacementCommitted || status.placementChanged;
+        placementCommitted = placementCommitted || status.placementChanged;
+
+        // Symbols only show up once a placement computed in the background has
+        // been committed, and the cross tile index never lets a symbol be
+        // placed twice, even while tiles of two zoom levels are shown.
+        const std::vector<std::string> names = visibleSymbols(test.frontend);
+        if (!anyPlacementCommitted) {
+            EXPECT_TRUE(names.empty());
+        }
+        EXPECT_EQ(names.end(), std::adjacent_find(names.begin(), names.end()));
+
+        if (placementCommitted && !status.needsRepaint) {
+            test.runLoop.stop();
+        }
+    };
+
+    test.map.getStyle().loadJSON(symbolStyle);
+    test.map.getStyle().addImage(std::make_unique<style::Image>("test-icon",
+        decodeImage(util::read_file("test/fixtures/sprites/default_marker.png")), 1.0));
+    test.map.jumpTo(CameraOptions().withCenter(LatLng { 0, 0 }).withZoom(0));
+    test.runLoop.run();
+    EXPECT_EQ((std::vector<std::string> { "a", "b", "c", "d" }), visibleSymbols(test.frontend));
+
+    // Symbols of the child tiles are matched with those of the parent tile
+    // they replace, while placements keep running in the background.
+    placementCommitted = false;
+    test.map.jumpTo(CameraOptions().withZoom(1));
+    test.runLoop.run();
+    EXPECT_EQ((std::vector<std::string> { "a", "b", "c", "d" }), visibleSymbols(test.frontend));
+}
+
+TEST(Map, SymbolPlacementTimeBudget) {
+    using namespace std::chrono_literals;
+
+    MapTest<> test { 1, MapMode::Continuous };
+
+    util::Timer emergencyShutoff;
+    emergencyShutoff.start(10s, 0s, [&] {
+        test.runLoop.stop();
+        FAIL() << "Did not stop rendering";
+    });
+
+    std::size_t frames = 0;
+    std::size_t framesUntilPlacement = 0;
+    test.observer.didFinishRenderingFrameCallback = [&] (MapObserver::RenderFrameStatus status) {
+        ++frames;
+        if (status.placementChanged && !framesUntilPlacement) {
+            framesUntilPlacement = frames;
+        }
+
+        // Buckets that were placed in an earlier frame are never placed again.
+        const std::vector<std::string> names = visibleSymbols(test.frontend);
+        EXPECT_EQ(names.end(), std::adjacent_find(names.begin(), names.end()));
+
+        if (framesUntilPlacement && !status.needsRepaint) {
+            test.runLoop.stop();
+        }
+    };
+
+    test.map.getStyle().loadJSON(symbolStyle);
+    test.map.getStyle().addImage(std::make_unique<style::Image>("test-icon",
+        decodeImage(util::read_file("test/fixtures/sprites/default_marker.png")), 1.0));
+    test.map.jumpTo(CameraOptions().withCenter(LatLng { 0, 0 }).withZoom(1));
+    test.runLoop.run();
+    EXPECT_EQ((std::vector<std::string> { "a", "b", "c", "d" }), visibleSymbols(test.frontend));
+
+    // Without any time, a single bucket is placed per frame, so the placement
+    // of the four tiles is committed in the fourth frame at the earliest.
+    test.frontend.getRenderer()->setSymbolPlacementTimeBudget(Duration::zero());
+    frames = framesUntilPlacement = 0;
+    test.map.jumpTo(CameraOptions().withCenter(LatLng { 1, 1 }));
+    test.runLoop.run();
+    EXPECT_LE(4u, framesUntilPlacement);
+    EXPECT_EQ((std::vector<std::string> { "a", "b", "c", "d" }), visibleSymbols(test.frontend));
+
+    // The zoom 2 tiles replace the zoom 1 tiles while placements are spread
+    // over several frames, so the buckets of a layer change between slices.
+    frames = framesUntilPlacement = 0;
+    test.map.jumpTo(CameraOptions().withCenter(LatLng { 0, 0 }).withZoom(2));
+    test.runLoop.run();
+    EXPECT_EQ((std::vector<std::string> { "a", "b", "c", "d" }), visibleSymbols(test.frontend));
+}
@@ -76,6 +76,85 @@ TEST(ImageManager, RemoveReleasesBinPackRect) {
     EXPECT_TRUE(log.empty());
 }
 
+TEST(ImageManager, SharedAtlas) {
+    ImageManager imageManager;
+    SharedImageAtlas& atlas = *imageManager.getAtlas();
+
+    ImageMap icons;
+    icons.emplace("one", makeMutable<style::Image::Impl>("one", PremultipliedImage({ 16, 16 }), 1));
+    icons.emplace("two", makeMutable<style::Image::Impl>("two", PremultipliedImage({ 8, 8 }), 1));
+    ImageMap patterns;
+    patterns.emplace("one", icons.at("one"));
+
+    // Tiles using the same images share their position in the atlas.
+    ImageAtlas first = atlas.addImages(icons, patterns, {});
+    ImageAtlas second = atlas.addImages(icons, {}, {});
+    EXPECT_EQ(3u, atlas.getImageCount());
+    EXPECT_EQ(first.iconPositions.at("one").textureRect, second.iconPositions.at("one").textureRect);
+    EXPECT_EQ(16, first.iconPositions.at("one").textureRect.w);
+
+    // An icon and a pattern of the same image are packed separately, as patterns have wrapped padding.
+    EXPECT_FALSE(first.iconPositions.at("one").textureRect == first.patternPositions.at("one").textureRect);
+
+    // Images are evicted once no tile references them anymore.
+    first = {};
+    EXPECT_EQ(2u, atlas.getImageCount());
+    second = {};
+    EXPECT_EQ(0u, atlas.getImageCount());
+
+    // Images removed or resized in the style aren't shared with tiles still using the previous version.
+    ImageAtlas third = atlas.addImages(icons, {}, {});
+    atlas.removeImage("one");
+    icons.erase("one");
+    icons.emplace("one", makeMutable<style::Image::Impl>("one", PremultipliedImage({ 16, 16 }), 1));
+    ImageAtlas fourth = atlas.addImages(icons, {}, {});
+    EXPECT_EQ(3u, atlas.getImageCount());
+    EXPECT_FALSE(third.iconPositions.at("one").textureRect == fourth.iconPositions.at("one").textureRect);
+    EXPECT_EQ(third.iconPositions.at("two").textureRect, fourth.iconPositions.at("two").textureRect);
+}
+
+TEST(ImageManager, SharedAtlasOverflow) {
+    // Room for four images of 14x14 pixels plus padding.
+    auto atlas = std::make_shared<SharedImageAtlas>(Size { 32, 32 });
+
+    ImageMap icons;
+    for (const auto& id : { "a", "b", "c", "d", "e", "f" }) {
+        PremultipliedImage image({ 14, 14 });
+        image.fill(id[0]);
+        icons.emplace(id, makeMutable<style::Image::Impl>(id, std::move(image), 1));
+    }
+    ImageMap firstIcons { *icons.find("a"), *icons.find("b") };
+
+    ImageAtlas first = atlas->addImages(firstIcons, {}, {});
+    EXPECT_FALSE(first.reference.hasOwnImage());
+    EXPECT_EQ(2u, atlas->getImageCount());
+
+    // A tile whose images don't all fit gets an image of its own, and leaves
+    // the shared atlas as it was.
+    ImageAtlas second = atlas->addImages(icons, {}, { { "f", 3 } });
+    EXPECT_TRUE(second.reference.hasOwnImage());
+    EXPECT_EQ(2u, atlas->getImageCount());
+    EXPECT_EQ(Size(32, 32), atlas->getSize());
+    ASSERT_EQ(6u, second.iconPositions.size());
+    EXPECT_EQ(3u, second.iconPositions.at("f").version);
+
+    EXPECT_LT(0u, second.reference.getMemoryUsage());
+    optional<PremultipliedImage> image = second.reference.takeOwnImage();
+    ASSERT_TRUE(image);
+    EXPECT_EQ(0u, second.reference.getMemoryUsage());
+    EXPECT_FALSE(second.reference.takeOwnImage());
+
+    const Rect<uint16_t>& rect = second.iconPositions.at("e").textureRect;
+    EXPECT_EQ('e', image->data[(rect.y * image->size.width + rect.x) * 4]);
+
+    // Tiles that fit keep using the shared atlas.
+    ImageMap thirdIcons { *icons.find("c") };
+    ImageAtlas third = atlas->addImages(thirdIcons, {}, {});
+    EXPECT_FALSE(third.reference.hasOwnImage());
+    EXPECT_EQ(3u, atlas->getImageCount());
+    EXPECT_EQ(Size(32, 32), atlas->getSize());
+}
+
 class StubImageRequestor : public ImageRequestor {
 public:
     StubImageRequestor(ImageManager& imageManager) : ImageRequestor(imageManager) {}
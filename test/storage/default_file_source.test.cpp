@@ -308,6 +308,76 @@ TEST(DefaultFileSource, OptionalExpired) {
     loop.run();
 }
 
+TEST(DefaultFileSource, MemoryCache) {
+    util::RunLoop loop;
+    DefaultFileSource fs(":memory:", ".");
+
+    const Resource optionalResource { Resource::Unknown, "http://127.0.0.1:3000/test", {}, Resource::LoadingMethod::CacheOnly };
+
+    using namespace std::chrono_literals;
+
+    Response response;
+    response.data = std::make_shared<std::string>("Cached value");
+    response.expires = util::now() + 1h;
+    fs.put(optionalResource, response);
+
+    std::unique_ptr<AsyncRequest> req;
+    req = fs.request(optionalResource, [&](Response res) {
+        req.reset();
+        ASSERT_TRUE(res.data.get());
+        EXPECT_EQ("Cached value", *res.data);
+        loop.stop();
+    });
+
+    loop.run();
+    EXPECT_EQ(0u, fs.getMemoryCacheHits());
+    EXPECT_EQ(1u, fs.getMemoryCacheMisses());
+
+    // The second request is answered from memory, even though the database
+    // thread is paused.
+    fs.pause();
+    req = fs.request(optionalResource, [&](Response res) {
+        req.reset();
+        EXPECT_EQ(nullptr, res.error);
+        ASSERT_TRUE(res.data.get());
+        EXPECT_EQ("Cached value", *res.data);
+        ASSERT_TRUE(bool(res.expires));
+        EXPECT_EQ(*response.expires, *res.expires);
+        loop.stop();
+    });
+
+    loop.run();
+    EXPECT_EQ(1u, fs.getMemoryCacheHits());
+    EXPECT_EQ(1u, fs.getMemoryCacheMisses());
+    fs.resume();
+}
+
+TEST(DefaultFileSource, TEST_REQUIRES_SERVER(SharedOnlineRequest)) {
+    util::RunLoop loop;
+    DefaultFileSource fs(":memory:", ".");
+
+    const Resource resource { Resource::Unknown, "http://127.0.0.1:3000/test", {}, Resource::LoadingMethod::NetworkOnly };
+
+    std::vector<Response> responses;
+    auto callback = [&](Response res) {
+        responses.push_back(res);
+        if (responses.size() == 2) {
+            loop.stop();
+        }
+    };
+
+    std::unique_ptr<AsyncRequest> req1 = fs.request(resource, callback);
+    std::unique_ptr<AsyncRequest> req2 = fs.request(resource, callback);
+
+    loop.run();
+
+    // Both requests are answered by the same transfer, sharing its data.
+    ASSERT_EQ(2u, responses.size());
+    ASSERT_TRUE(responses[0].data.get());
+    EXPECT_EQ("Hello World!", *responses[0].data);
+    EXPECT_EQ(responses[0].data, responses[1].data);
+}
+
 TEST(DefaultFileSource, GetBaseURLAndAccessTokenWhilePaused) {
     util::RunLoop loop;
     DefaultFileSource fs(":memory:", ".");
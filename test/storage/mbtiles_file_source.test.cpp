@@ -0,0 +1,102 @@
+#include <mbgl/storage/mbtiles_file_source.hpp>
+#include <mbgl/storage/resource.hpp>
+#include <mbgl/storage/sqlite3.hpp>
+#include <mbgl/test/util.hpp>
+#include <mbgl/util/io.hpp>
+#include <mbgl/util/run_loop.hpp>
+
+using namespace mbgl;
+
+namespace {
+
+const std::string path = "test/fixtures/storage/tiles.mbtiles";
+
+void createTileSet() {
+    util::deleteFile(path);
+
+    mapbox::sqlite::Database db = mapbox::sqlite::Database::open(path, mapbox::sqlite::ReadWriteCreate);
+    db.exec("CREATE TABLE metadata (name TEXT, value TEXT)");
+    db.exec("CREATE TABLE tiles (zoom_level INTEGER, tile_column INTEGER, tile_row INTEGER, tile_data BLOB)");
+    db.exec("INSERT INTO metadata VALUES ('minzoom', '0'), ('maxzoom', '4'), ('bounds', '-180,-85,180,85')");
+    // Rows are numbered from the bottom, so this is tile 1/0/0.
+    db.exec("INSERT INTO tiles VALUES (1, 0, 1, 'tile 1/0/0')");
+}
+
+} // namespace
+
+TEST(MBTilesFileSource, AcceptsURL) {
+    EXPECT_TRUE(MBTilesFileSource::acceptsURL("mbtiles:///tiles.mbtiles"));
+    EXPECT_FALSE(MBTilesFileSource::acceptsURL("file:///tiles.mbtiles"));
+    EXPECT_FALSE(MBTilesFileSource::acceptsURL("mbtiles:"));
+    EXPECT_FALSE(MBTilesFileSource::acceptsURL(""));
+}
+
+TEST(MBTilesFileSource, TEST_REQUIRES_WRITE(Tile)) {
+    util::RunLoop loop;
+    createTileSet();
+
+    MBTilesFileSource fs;
+
+    const Resource tile = Resource::tile("mbtiles://" + path, 1, 0, 0, 1, Tileset::Scheme::XYZ);
+    std::unique_ptr<AsyncRequest> req = fs.request(tile, [&](Response res) {
+        req.reset();
+        EXPECT_EQ(nullptr, res.error);
+        ASSERT_TRUE(res.data.get());
+        EXPECT_EQ("tile 1/0/0", *res.data);
+        loop.stop();
+    });
+
+    loop.run();
+
+    const Resource missing = Resource::tile("mbtiles://" + path, 1, 1, 1, 1, Tileset::Scheme::XYZ);
+    req = fs.request(missing, [&](Response res) {
+        req.reset();
+        EXPECT_EQ(nullptr, res.error);
+        EXPECT_TRUE(res.noContent);
+        EXPECT_FALSE(res.data.get());
+        loop.stop();
+    });
+
+    loop.run();
+
+    util::deleteFile(path);
+}
+
+TEST(MBTilesFileSource, TEST_REQUIRES_WRITE(TileJSON)) {
+    util::RunLoop loop;
+    createTileSet();
+
+    MBTilesFileSource fs;
+
+    std::unique_ptr<AsyncRequest> req = fs.request(Resource::source("mbtiles://" + path), [&](Response res) {
+        req.reset();
+        EXPECT_EQ(nullptr, res.error);
+        ASSERT_TRUE(res.data.get());
+        EXPECT_EQ(R"({"tilejson":"2.2.0","tiles":["mbtiles://test/fixtures/storage/tiles.mbtiles"],)"
+                  R"("minzoom":0,"maxzoom":4,"bounds":[-180.0,-85.0,180.0,85.0]})",
+                  *res.data);
+        loop.stop();
+    });
+
+    loop.run();
+
+    util::deleteFile(path);
+}
+
+TEST(MBTilesFileSource, InvalidFile) {
+    util::RunLoop loop;
+
+    MBTilesFileSource fs;
+
+    const Resource tile = Resource::tile("mbtiles://test/fixtures/storage/nonexistent.mbtiles", 1, 0, 0, 0,
+                                         Tileset::Scheme::XYZ);
+    std::unique_ptr<AsyncRequest> req = fs.request(tile, [&](Response res) {
+        req.reset();
+        ASSERT_NE(nullptr, res.error);
+        EXPECT_EQ(Response::Error::Reason::Other, res.error->reason);
+        EXPECT_FALSE(res.data.get());
+        loop.stop();
+    });
+
+    loop.run();
+}
@@ -146,7 +146,6 @@ TEST(OfflineDatabase, TEST_REQUIRES_WRITE(CreateFail)) {
     // We can also still "query" the database even though it is not open, and we will always get an empty result.
     for (const auto& res : { fixture::resource, fixture::tile }) {
         EXPECT_FALSE(bool(db.get(res)));
-        EXPECT_EQ(1u, log.count(warning(ResultCode::CantOpen, "Can't update timestamp: unable to open database file")));
         EXPECT_EQ(1u, log.count(warning(ResultCode::CantOpen, "Can't read resource: unable to open database file")));
         EXPECT_EQ(0u, log.uncheckedCount());
     }
@@ -163,13 +162,12 @@ TEST(OfflineDatabase, TEST_REQUIRES_WRITE(CreateFail)) {
     }
 
     // Next, set the file system to read only mode and try to read the data again. While we can't
-    // write anymore, we should still be able to read, and the query that tries to update the last
-    // accessed timestamp may fail without crashing.
+    // write anymore, we should still be able to read, as the last accessed timestamp is only
+    // written lazily.
     fs.allowFileCreate(false);
     fs.setWriteLimit(0);
     for (const auto& res : { fixture::resource, fixture::tile }) {
         auto result = db.get(res);
-        EXPECT_EQ(1u, log.count(warning(ResultCode::CantOpen, "Can't update timestamp: unable to open database file")));
         EXPECT_EQ(0u, log.uncheckedCount());
 
         ASSERT_TRUE(result && result->data);
@@ -178,13 +176,11 @@ TEST(OfflineDatabase, TEST_REQUIRES_WRITE(CreateFail)) {
     fs.setDebug(false);
 
     // We're allowing SQLite to create a journal file, but restrict the number of bytes it
-    // can write so that it can start writing the journal file, but eventually fails during the
-    // timestamp update.
+    // can write. Reading doesn't write anything.
     fs.allowFileCreate(true);
     fs.setWriteLimit(8192);
     for (const auto& res : { fixture::resource, fixture::tile }) {
         auto result = db.get(res);
-        EXPECT_EQ(1u, log.count(warning(ResultCode::Full, "Can't update timestamp: database or disk is full")));
         EXPECT_EQ(0u, log.uncheckedCount());
         ASSERT_TRUE(result && result->data);
         EXPECT_EQ("first", *result->data);
@@ -197,7 +193,6 @@ TEST(OfflineDatabase, TEST_REQUIRES_WRITE(CreateFail)) {
     for (const auto& res : { fixture::resource, fixture::tile }) {
         // First, try reading.
         auto result = db.get(res);
-        EXPECT_EQ(1u, log.count(warning(ResultCode::Auth, "Can't update timestamp: authorization denied")));
         EXPECT_EQ(1u, log.count(warning(ResultCode::Auth, "Can't read resource: authorization denied")));
         EXPECT_EQ(0u, log.uncheckedCount());
         EXPECT_FALSE(result);
@@ -1032,6 +1027,46 @@ TEST(OfflineDatabase, TEST_REQUIRES_WRITE(ConcurrentUse)) {
     EXPECT_EQ(0u, log.uncheckedCount());
 }
 
+TEST(OfflineDatabase, TEST_REQUIRES_WRITE(CompressionCodec)) {
+    FixtureLog log;
+    deleteDatabaseFiles();
+
+    class Codec : public OfflineDatabaseCodec {
+    public:
+        uint8_t id() const override { return 7; }
+        std::string compress(const std::string&) const override { return "compressed"; }
+        std::string decompress(const std::string&) const override { return "decompressed"; }
+    };
+
+    Response response;
+    response.data = std::make_shared<std::string>(1024, 0);
+
+    {
+        OfflineDatabase db(filename);
+        db.put(Resource::style("http://example.com/zlib"), response);
+
+        db.setCompressionCodec(std::make_shared<Codec>());
+        EXPECT_EQ(10u, db.put(Resource::style("http://example.com/custom"), response).second);
+
+        // Rows compressed with either codec can be read.
+        auto zlib = db.get(Resource::style("http://example.com/zlib"));
+        ASSERT_TRUE(zlib && zlib->data);
+        EXPECT_EQ(*response.data, *zlib->data);
+
+        auto custom = db.get(Resource::style("http://example.com/custom"));
+        ASSERT_TRUE(custom && custom->data);
+        EXPECT_EQ("decompressed", *custom->data);
+    }
+
+    // Rows compressed with a codec that isn't registered can't be read.
+    OfflineDatabase db(filename);
+    EXPECT_TRUE(bool(db.get(Resource::style("http://example.com/zlib"))));
+    EXPECT_FALSE(bool(db.get(Resource::style("http://example.com/custom"))));
+    EXPECT_EQ(1u, log.count({ EventSeverity::Error, Event::Database, -1, "Can't read resource: Unknown compression codec 7" }));
+
+    EXPECT_EQ(0u, log.uncheckedCount());
+}
+
 TEST(OfflineDatabase, PutReturnsSize) {
     FixtureLog log;
     OfflineDatabase db(":memory:");
@@ -1051,6 +1086,147 @@ TEST(OfflineDatabase, PutReturnsSize) {
     EXPECT_EQ(0u, log.uncheckedCount());
 }
 
+TEST(OfflineDatabase, TEST_REQUIRES_WRITE(BatchedWrites)) {
+    FixtureLog log;
+    deleteDatabaseFiles();
+
+    Response response;
+    response.data = std::make_shared<std::string>("first");
+
+    {
+        OfflineDatabase db(filename);
+        db.setWriteAheadLogEnabled(true);
+        db.setWriteBatchSize(3);
+        EXPECT_EQ("wal", databaseJournalMode(filename));
+
+        db.put(Resource::style("http://example.com/1"), response);
+        db.put(Resource::style("http://example.com/2"), response);
+        EXPECT_TRUE(db.hasPendingWrites());
+
+        // Batched writes are visible to the connection that made them.
+        auto res = db.get(Resource::style("http://example.com/1"));
+        ASSERT_TRUE(res && res->data);
+        EXPECT_EQ("first", *res->data);
+
+        // The third write completes the batch.
+        db.put(Resource::style("http://example.com/3"), response);
+        EXPECT_FALSE(db.hasPendingWrites());
+
+        // Reads don't start a batch, and don't count towards one.
+        EXPECT_TRUE(bool(db.get(Resource::style("http://example.com/3"))));
+        EXPECT_FALSE(db.hasPendingWrites());
+
+        db.put(Resource::style("http://example.com/4"), response);
+        EXPECT_TRUE(db.hasPendingWrites());
+        db.flush();
+        EXPECT_FALSE(db.hasPendingWrites());
+
+        db.put(Resource::style("http://example.com/5"), response);
+        EXPECT_TRUE(db.hasPendingWrites());
+    }
+
+    // Pending writes are committed when the database is closed.
+    OfflineDatabase db(filename);
+    for (uint32_t i = 1; i <= 5; i++) {
+        EXPECT_TRUE(bool(db.get(Resource::style("http://example.com/"s + util::toString(i))))) << i;
+    }
+
+    EXPECT_EQ(0u, log.uncheckedCount());
+}
+
+TEST(OfflineDatabase, TEST_REQUIRES_WRITE(FailedBatchedWriteKeepsRegionChanges)) {
+    FixtureLog log;
+    deleteDatabaseFiles();
+
+    class FailingCodec : public OfflineDatabaseCodec {
+    public:
+        uint8_t id() const override { return 7; }
+        std::string compress(const std::string&) const override { throw std::runtime_error("compression failed"); }
+        std::string decompress(const std::string& data) const override { return data; }
+    };
+
+    Response response;
+    response.data = std::make_shared<std::string>("data");
+
+    OfflineDatabase db(filename);
+    db.setWriteBatchSize(10);
+
+    OfflineTilePyramidRegionDefinition definition { "http://example.com/style", LatLngBounds::hull({1, 2}, {3, 4}), 5, 6, 2.0, true };
+    db.put(Resource::style("http://example.com/1"), response);
+    auto region = db.createRegion(definition, {{ 1, 2, 3 }});
+    ASSERT_TRUE(region);
+    db.put(Resource::style("http://example.com/2"), response);
+    EXPECT_TRUE(bool(db.updateMetadata(region->getID(), {{ 4, 5, 6 }})));
+    db.put(Resource::style("http://example.com/3"), response);
+    EXPECT_TRUE(db.hasPendingWrites());
+
+    // A failed write only rolls back itself, not the writes batched before it
+    // nor the writes that happened outside of the batch.
+    db.setCompressionCodec(std::make_shared<FailingCodec>());
+    EXPECT_FALSE(db.put(Resource::style("http://example.com/4"), response).first);
+    EXPECT_EQ(1u, log.count({ EventSeverity::Error, Event::Database, -1, "Can't write resource: compression failed" }));
+    EXPECT_TRUE(db.hasPendingWrites());
+    db.flush();
+    EXPECT_FALSE(db.hasPendingWrites());
+
+    auto regions = db.listRegions();
+    ASSERT_TRUE(regions);
+    ASSERT_EQ(1u, regions->size());
+    EXPECT_EQ(region->getID(), regions->at(0).getID());
+    EXPECT_EQ((OfflineRegionMetadata {{ 4, 5, 6 }}), regions->at(0).getMetadata());
+
+    // Batched writes that preceded the region changes were committed with them.
+    EXPECT_TRUE(bool(db.get(Resource::style("http://example.com/1"))));
+    EXPECT_TRUE(bool(db.get(Resource::style("http://example.com/2"))));
+    EXPECT_TRUE(bool(db.get(Resource::style("http://example.com/3"))));
+    EXPECT_FALSE(bool(db.get(Resource::style("http://example.com/4"))));
+
+    EXPECT_EQ(0u, log.uncheckedCount());
+}
+
+TEST(OfflineDatabase, TEST_REQUIRES_WRITE(DeferredAccessTimes)) {
+    FixtureLog log;
+    deleteDatabaseFiles();
+
+    auto accessed = [](const char* table) {
+        mapbox::sqlite::Database other = mapbox::sqlite::Database::open(filename, mapbox::sqlite::ReadOnly);
+        const std::string sql = "SELECT min(accessed) FROM "s + table;
+        mapbox::sqlite::Statement stmt{ other, sql.c_str() };
+        mapbox::sqlite::Query query{ stmt };
+        query.run();
+        return query.get<int64_t>(0);
+    };
+
+    OfflineDatabase db(filename);
+    db.put(fixture::resource, fixture::response);
+    db.put(fixture::tile, fixture::response);
+
+    // The access time of a resource that was just stored is recent enough already.
+    EXPECT_TRUE(bool(db.get(fixture::resource)));
+    EXPECT_TRUE(bool(db.get(fixture::tile)));
+    EXPECT_FALSE(db.hasPendingWrites());
+
+    {
+        mapbox::sqlite::Database other = mapbox::sqlite::Database::open(filename, mapbox::sqlite::ReadWriteCreate);
+        other.exec("UPDATE resources SET accessed = 0");
+        other.exec("UPDATE tiles SET accessed = 0");
+    }
+
+    // Access times are kept in memory until they are flushed.
+    EXPECT_TRUE(bool(db.get(fixture::resource)));
+    EXPECT_TRUE(bool(db.get(fixture::tile)));
+    EXPECT_TRUE(db.hasPendingWrites());
+    EXPECT_EQ(0, accessed("resources"));
+    EXPECT_EQ(0, accessed("tiles"));
+
+    db.flush();
+    EXPECT_FALSE(db.hasPendingWrites());
+    EXPECT_LT(0, accessed("resources"));
+    EXPECT_LT(0, accessed("tiles"));
+
+    EXPECT_EQ(0u, log.uncheckedCount());
+}
+
 TEST(OfflineDatabase, PutEvictsLeastRecentlyUsedResources) {
     FixtureLog log;
     OfflineDatabase db(":memory:");
@@ -1565,7 +1741,6 @@ TEST(OfflineDatabase, TEST_REQUIRES_WRITE(DisallowedIO)) {
     fs.allowIO(false);
 
     EXPECT_EQ(nullopt, db.get(fixture::resource));
-    EXPECT_EQ(1u, log.count(warning(ResultCode::Auth, "Can't update timestamp: authorization denied")));
     EXPECT_EQ(1u, log.count(warning(ResultCode::Auth, "Can't read resource: authorization denied")));
     EXPECT_EQ(0u, log.uncheckedCount());
 
@@ -1586,7 +1761,6 @@ TEST(OfflineDatabase, TEST_REQUIRES_WRITE(DisallowedIO)) {
     EXPECT_EQ(0u, log.uncheckedCount());
 
     EXPECT_EQ(nullopt, db.getRegionResource(fixture::resource));
-    EXPECT_EQ(1u, log.count(warning(ResultCode::Auth, "Can't update timestamp: authorization denied")));
     EXPECT_EQ(1u, log.count(warning(ResultCode::Auth, "Can't read region resource: authorization denied")));
     EXPECT_EQ(0u, log.uncheckedCount());
 
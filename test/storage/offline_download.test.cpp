@@ -946,4 +946,80 @@ TEST(OfflineDownload, ResourceOfflineUsageUnset) {
     map.jumpTo(CameraOptions().withCenter(LatLng{0.0, 0.0}).withZoom(0));
     test.loop.run();
 }
+TEST(OfflineDownload, TEST_REQUIRES_WRITE(ResumeFromCheckpoint)) {
+    deleteDatabaseFiles();
+
+    OfflineTest test{ filename };
+    auto region = test.createRegion();
+    ASSERT_TRUE(region);
+    const OfflineTilePyramidRegionDefinition definition("http://127.0.0.1:3000/style.json", LatLngBounds::world(), 0.0, 1.0, 1.0, false);
+
+    test.fileSource.styleResponse = [&] (const Resource&) {
+        return test.response("inline_source.style.json");
+    };
+
+    test.fileSource.tileResponse = [&] (const Resource&) {
+        return test.response("0-0-0.vector.pbf");
+    };
+
+    OfflineRegionStatus downloaded;
+    {
+        OfflineDownload download(region->getID(), definition, test.db, test.fileSource);
+        download.setBatchSize(2);
+
+        auto observer = std::make_unique<MockObserver>();
+        observer->statusChangedFn = [&] (OfflineRegionStatus status) {
+            if (status.complete()) {
+                downloaded = status;
+                test.loop.stop();
+            }
+        };
+
+        download.setObserver(std::move(observer));
+        download.setState(OfflineRegionDownloadState::Active);
+        test.loop.run();
+        download.setState(OfflineRegionDownloadState::Inactive);
+    }
+
+    EXPECT_EQ(5u, downloaded.completedTileCount);
+    EXPECT_EQ(6u, downloaded.completedResourceCount);
+
+    // Remove the stored tiles behind the back of the download. Looking them
+    // up would find them missing and request them again, so the download
+    // must take the checkpoint's word that they are stored.
+    {
+        auto other = mapbox::sqlite::Database::open(filename, mapbox::sqlite::ReadWriteCreate);
+        other.exec("DELETE FROM region_tiles");
+        other.exec("DELETE FROM tiles");
+    }
+
+    std::size_t tileRequests = 0;
+    test.fileSource.tileResponse = [&] (const Resource&) {
+        tileRequests++;
+        return test.response("0-0-0.vector.pbf");
+    };
+
+    OfflineDownload download(region->getID(), definition, test.db, test.fileSource);
+
+    auto observer = std::make_unique<MockObserver>();
+    observer->statusChangedFn = [&] (OfflineRegionStatus status) {
+        // Checkpointed tiles are counted as complete as soon as the style
+        // has been read, before any tile is visited.
+        if (status.requiredResourceCountIsPrecise) {
+            EXPECT_EQ(downloaded.completedTileCount, status.completedTileCount);
+            EXPECT_EQ(downloaded.completedTileSize, status.completedTileSize);
+        }
+        if (status.complete()) {
+            EXPECT_EQ(downloaded.completedResourceCount, status.completedResourceCount);
+            EXPECT_EQ(downloaded.completedResourceSize, status.completedResourceSize);
+            test.loop.stop();
+        }
+    };
+
+    download.setObserver(std::move(observer));
+    download.setState(OfflineRegionDownloadState::Active);
+    test.loop.run();
+    EXPECT_EQ(0u, tileRequests);
+}
+
 #endif // __QT__
@@ -546,3 +546,78 @@ TEST(OnlineFileSource, TEST_REQUIRES_SERVER(RequestSameUrlMultipleTimes)) {
 
     loop.run();
 }
+
+TEST(OnlineFileSource, TEST_REQUIRES_SERVER(PendingRequestOrder)) {
+    util::RunLoop loop;
+    OnlineFileSource fs;
+
+    fs.setMaximumConcurrentRequests(1);
+
+    std::vector<std::string> responses;
+    std::vector<std::unique_ptr<AsyncRequest>> requests;
+
+    auto request = [&](const Resource& resource) {
+        requests.push_back(fs.request(resource, [&, url = resource.url](Response) {
+            responses.push_back(url);
+            if (responses.size() == 5) {
+                loop.stop();
+            }
+        }));
+    };
+
+    auto tile = [](int32_t x, double order) {
+        Resource resource = Resource::tile("http://127.0.0.1:3000/load/{x}", 1, x, 0, 0, Tileset::Scheme::XYZ);
+        resource.order = order;
+        return resource;
+    };
+
+    // Occupies the only connection while the other requests are queued.
+    request({ Resource::Unknown, "http://127.0.0.1:3000/load/0" });
+    request(tile(1, 1));
+    request(tile(2, 2));
+    request(tile(3, 3));
+    request(Resource::style("http://127.0.0.1:3000/load/4"));
+
+    // Moves the last tile to the front of the queue, behind the style.
+    requests[3]->setPriority(0);
+
+    loop.run();
+
+    EXPECT_EQ(std::vector<std::string>({
+        "http://127.0.0.1:3000/load/0",
+        "http://127.0.0.1:3000/load/4",
+        "http://127.0.0.1:3000/load/3",
+        "http://127.0.0.1:3000/load/1",
+        "http://127.0.0.1:3000/load/2",
+    }), responses);
+}
+
+TEST(OnlineFileSource, TEST_REQUIRES_SERVER(MaximumConcurrentRequestsPerHost)) {
+    util::RunLoop loop;
+    OnlineFileSource fs;
+
+    ASSERT_EQ(fs.getMaximumConcurrentRequestsPerHost(), 0u);
+
+    fs.setMaximumConcurrentRequestsPerHost(1);
+    ASSERT_EQ(fs.getMaximumConcurrentRequestsPerHost(), 1u);
+
+    std::vector<std::string> responses;
+    std::vector<std::unique_ptr<AsyncRequest>> requests;
+
+    for (const char* url : { "http://127.0.0.1:3000/load/1", "http://127.0.0.1:3000/load/2",
+                             "http://localhost:3000/load/3" }) {
+        requests.push_back(fs.request({ Resource::Unknown, url }, [&, url](Response) {
+            responses.push_back(url);
+            if (responses.size() == 3) {
+                loop.stop();
+            }
+        }));
+    }
+
+    loop.run();
+
+    // The second request to 127.0.0.1 has to wait for the first one, but
+    // doesn't hold up the request to localhost.
+    ASSERT_EQ(responses.size(), 3u);
+    EXPECT_EQ(responses[2], "http://127.0.0.1:3000/load/2");
+}
@@ -58,3 +58,35 @@ TEST(SQLite, CloseMovedDatabaseWithPendingTransaction) {
     db2 = std::make_unique<mapbox::sqlite::Database>(std::move(db1));
     transaction.commit();
 }
+
+TEST(SQLite, Savepoint) {
+    mapbox::sqlite::Database db = mapbox::sqlite::Database::open(":memory:", mapbox::sqlite::ReadWriteCreate);
+    db.exec("CREATE TABLE test (id INTEGER);");
+
+    auto count = [&] {
+        mapbox::sqlite::Statement stmt{ db, "SELECT COUNT(*) FROM test" };
+        mapbox::sqlite::Query query{ stmt };
+        query.run();
+        return query.get<int64_t>(0);
+    };
+
+    mapbox::sqlite::Transaction transaction(db);
+    db.exec("INSERT INTO test (id) VALUES (1);");
+    {
+        mapbox::sqlite::Savepoint savepoint(db, "first");
+        db.exec("INSERT INTO test (id) VALUES (2);");
+        savepoint.release();
+    }
+    {
+        // Savepoints that aren't released are rolled back to.
+        mapbox::sqlite::Savepoint savepoint(db, "second");
+        db.exec("INSERT INTO test (id) VALUES (3);");
+    }
+    EXPECT_EQ(2, count());
+
+    mapbox::sqlite::Savepoint savepoint(db, "third");
+    db.exec("INSERT INTO test (id) VALUES (4);");
+    savepoint.rollback();
+    transaction.commit();
+    EXPECT_EQ(2, count());
+}
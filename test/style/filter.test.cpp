@@ -256,6 +256,55 @@ TEST(Filter, Short) {
     filter(R"(["==", ["id"], "foo"])");
 }
 
+TEST(Filter, CompiledMatchesExpression) {
+    const char* filters[] = {
+        R"(["==", "foo", "bar"])",
+        R"(["!=", "foo", 1])",
+        R"(["in", "foo", 1, "bar", true])",
+        R"(["!in", "foo", 2])",
+        R"(["<", "foo", 2])",
+        R"([">=", "foo", "b"])",
+        R"(["has", "foo"])",
+        R"(["!has", "foo"])",
+        R"(["==", "$type", "LineString"])",
+        R"(["in", "$type", "Point", "Polygon", "Foo"])",
+        R"(["all", ["==", "foo", 1], ["has", "bar"]])",
+        R"(["any", ["==", "foo", "bar"], ["<=", "bar", 0]])",
+        R"(["none", ["==", "foo", true]])",
+        R"(["==", ["get", "foo"], "bar"])",
+        R"(["!=", 1, ["get", "foo"]])",
+        R"(["==", ["get", "foo"], null])",
+        R"(["<", ["get", "foo"], 2])",
+        R"(["all", ["<", ["get", "foo"], 2], true])",
+        R"(["!", ["any", ["has", "bar"], ["<", ["get", "foo"], 2]]])",
+    };
+    const PropertyMap properties[] = {
+        {},
+        {{"foo", std::string("bar")}},
+        {{"foo", uint64_t(1)}},
+        {{"foo", int64_t(-1)}},
+        {{"foo", 1.5}},
+        {{"foo", true}},
+        {{"foo", std::string("bar")}, {"bar", 0.0}},
+    };
+
+    for (const char* json : filters) {
+        conversion::Error error;
+        optional<Filter> filter = conversion::convertJSON<Filter>(json, error);
+        ASSERT_TRUE(bool(filter)) << json;
+        for (const auto& featureProperties : properties) {
+            for (FeatureType type : { FeatureType::Point, FeatureType::LineString }) {
+                StubGeometryTileFeature feature { {}, type, {}, featureProperties };
+                expression::EvaluationContext context = { 0.0f, &feature };
+
+                const expression::EvaluationResult result = (*filter->expression)->evaluate(context);
+                const bool expected = result && result->is<bool>() && result->get<bool>();
+                EXPECT_EQ(expected, (*filter)(context)) << json;
+            }
+        }
+    }
+}
+
 TEST(Filter, LegacyExpressionInvalidType) {
     const JSValue value("string");
     conversion::Error error;
@@ -68,6 +68,22 @@ TEST(PropertyExpression, Defaults) {
         .evaluate(oneString, 2.0f));
 }
 
+TEST(PropertyExpression, EvaluateFeatures) {
+    const std::vector<const GeometryTileFeature*> features { &oneInteger, &oneDouble, &oneString, &emptyTileFeature };
+    std::vector<float> result;
+
+    PropertyExpression<float>(number(get("property")), 0.0).evaluate(nullopt, features, 2.0f, result);
+    EXPECT_EQ((std::vector<float>{ 1.0f, 1.0f, 0.0f, 0.0f }), result);
+
+    PropertyExpression<float>(number(get("property"))).evaluate(nullopt, features, 2.0f, result);
+    EXPECT_EQ((std::vector<float>{ 1.0f, 1.0f, 2.0f, 2.0f }), result);
+
+    PropertyExpression<float>(
+        interpolate(linear(), zoom(), 0.0, number(get("property")), 10.0, literal(11.0)), 0.0f)
+    .evaluate(5.0f, features, -1.0f, result);
+    EXPECT_EQ((std::vector<float>{ 6.0f, 6.0f, 0.0f, 0.0f }), result);
+}
+
 TEST(PropertyExpression, ZoomInterpolation) {
     EXPECT_EQ(40.0f, PropertyExpression<float>(
         interpolate(linear(), zoom(),
@@ -133,6 +149,34 @@ TEST(PropertyExpression, Issue8460) {
     EXPECT_NEAR(600.0f, fn2.evaluate(19.0f, oneInteger, -1.0f), 0.00);
 }
 
+TEST(PropertyExpression, CompiledMatchesExpression) {
+    const char* expressions[] = {
+        R"(["number", ["get", "property"]])",
+        R"(["number", ["get", "property"], ["get", "other"], 4])",
+        R"(["interpolate", ["linear"], ["zoom"], 0, 0, 10, 100])",
+        R"(["interpolate", ["exponential", 2], ["get", "property"], 0, 0, 10, 100])",
+        R"(["interpolate", ["cubic-bezier", 0.4, 0, 0.6, 1], ["zoom"], 1, ["number", ["get", "property"]], 10, 30])",
+        R"(["step", ["get", "property"], 1, 0.5, 2, 5, 3])",
+        R"(["case", ["==", ["get", "property"], 1], 10, ["has", "other"], ["*", 2, ["get", "other"]], -1])",
+        R"(["+", ["zoom"], ["get", "property"]])",
+    };
+    const StubGeometryTileFeature other{PropertyMap{{"property", 0.75}, {"other", int64_t(-3)}}};
+    const StubGeometryTileFeature* features[] = { &oneInteger, &oneDouble, &oneString, &emptyTileFeature, &other };
+
+    for (const char* json : expressions) {
+        std::unique_ptr<Expression> parsed = createExpression(json);
+        ASSERT_TRUE(parsed) << json;
+        PropertyExpression<float> expression(std::move(parsed));
+        for (const float zoom : { 0.0f, 2.5f, 10.0f, 20.0f }) {
+            for (const StubGeometryTileFeature* feature : features) {
+                const EvaluationResult result = expression.getExpression().evaluate(EvaluationContext(zoom, feature));
+                const optional<float> expected = result ? fromExpressionValue<float>(*result) : nullopt;
+                EXPECT_EQ(expected ? *expected : -1.0f, expression.evaluate(zoom, *feature, -1.0f)) << json;
+            }
+        }
+    }
+}
+
 TEST(PropertyExpression, FormatSectionOverride) {
     using Value = expression::Value;
     Value formattedSection =
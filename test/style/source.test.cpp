@@ -72,6 +72,8 @@ public:
                 annotationManager,
                 imageManager,
                 glyphManager,
+                0,
+                false,
                 0};
     };
 
@@ -340,3 +340,69 @@ TEST(CrossTileSymbolLayerIndex, bucketReplacement) {
     ASSERT_EQ(secondBucket.symbolInstances.at(2).crossTileID, 3u); // C' gets new ID
 }
 
+
+TEST(CrossTileSymbolLayerIndex, repeatedKeys) {
+    uint32_t maxCrossTileID = 0;
+    uint32_t maxBucketInstanceId = 0;
+    CrossTileSymbolLayerIndex index;
+
+    Immutable<style::SymbolLayoutProperties::PossiblyEvaluated> layout =
+        makeMutable<style::SymbolLayoutProperties::PossiblyEvaluated>();
+    bool iconsNeedLinear = false;
+    bool sortFeaturesByY = false;
+    std::string bucketLeaderID = "test";
+
+    // A row of labels with the same text, like house numbers or road shields.
+    OverscaledTileID mainID(6, 0, 6, 8, 8);
+    std::vector<SymbolInstance> mainInstances;
+    for (int i = 0; i < 50; ++i) {
+        mainInstances.push_back(makeSymbolInstance(80 * i, 1000, u"1"));
+    }
+    SymbolBucket mainBucket{layout,
+                            {},
+                            16.0f,
+                            1.0f,
+                            0,
+                            iconsNeedLinear,
+                            sortFeaturesByY,
+                            bucketLeaderID,
+                            std::move(mainInstances),
+                            1.0f,
+                            false,
+                            {},
+                            false /*iconsInText*/};
+    mainBucket.bucketInstanceId = ++maxBucketInstanceId;
+
+    // The same labels in the child tile, in reverse order.
+    OverscaledTileID childID(7, 0, 7, 16, 16);
+    std::vector<SymbolInstance> childInstances;
+    for (int i = 49; i >= 0; --i) {
+        childInstances.push_back(makeSymbolInstance(160 * i, 2000, u"1"));
+    }
+    SymbolBucket childBucket{layout,
+                             {},
+                             16.0f,
+                             1.0f,
+                             0,
+                             iconsNeedLinear,
+                             sortFeaturesByY,
+                             bucketLeaderID,
+                             std::move(childInstances),
+                             1.0f,
+                             false,
+                             {},
+                             false /*iconsInText*/};
+    childBucket.bucketInstanceId = ++maxBucketInstanceId;
+
+    index.addBucket(mainID, mainBucket, maxCrossTileID);
+    for (uint32_t i = 0; i < 50; ++i) {
+        ASSERT_EQ(mainBucket.symbolInstances.at(i).crossTileID, i + 1);
+    }
+
+    // each label matches the one at the same location in the parent tile
+    index.addBucket(childID, childBucket, maxCrossTileID);
+    for (uint32_t i = 0; i < 50; ++i) {
+        ASSERT_EQ(childBucket.symbolInstances.at(i).crossTileID, 50 - i);
+    }
+    ASSERT_EQ(maxCrossTileID, 50u);
+}
@@ -0,0 +1,110 @@
+#include <mbgl/test/util.hpp>
+#include <mbgl/text/glyph_atlas.hpp>
+
+using namespace mbgl;
+
+namespace {
+
+Immutable<Glyph> makeGlyph(GlyphID id, uint32_t size) {
+    auto glyph = makeMutable<Glyph>();
+    glyph->id = id;
+    glyph->bitmap = AlphaImage({ size, size });
+    glyph->bitmap.fill(static_cast<uint8_t>(id));
+    glyph->metrics.width = size;
+    glyph->metrics.height = size;
+    return std::move(glyph);
+}
+
+} // namespace
+
+TEST(GlyphAtlas, SharedGlyphs) {
+    auto atlas = std::make_shared<GlyphAtlas>();
+    const FontStackHash fontStack = FontStackHasher()({ "Test" });
+
+    GlyphMap first;
+    first[fontStack].emplace(u'a', makeGlyph(u'a', 8));
+    first[fontStack].emplace(u'b', makeGlyph(u'b', 8));
+
+    GlyphMap second;
+    second[fontStack].emplace(u'b', makeGlyph(u'b', 8));
+    second[fontStack].emplace(u'c', makeGlyph(u'c', 8));
+    second[fontStack].emplace(u'd', optional<Immutable<Glyph>>());
+
+    GlyphPositions firstPositions;
+    GlyphPositions secondPositions;
+    auto firstReference = atlas->addGlyphs(first, firstPositions);
+    auto secondReference = atlas->addGlyphs(second, secondPositions);
+
+    // Glyphs used by several tiles are only added once, and tiles share the position.
+    EXPECT_EQ(3u, atlas->getGlyphCount());
+    ASSERT_EQ(2u, secondPositions[fontStack].size());
+    EXPECT_EQ(firstPositions[fontStack][u'b'].rect, secondPositions[fontStack][u'b'].rect);
+    EXPECT_EQ(10, firstPositions[fontStack][u'a'].rect.w);
+    EXPECT_EQ(8u, firstPositions[fontStack][u'a'].metrics.width);
+
+    // Glyphs are evicted once no tile references them anymore.
+    firstReference = {};
+    EXPECT_EQ(2u, atlas->getGlyphCount());
+    const Size size = atlas->getSize();
+
+    // The freed space is reused, and the positions of the remaining glyphs don't change.
+    GlyphMap third;
+    third[fontStack].emplace(u'e', makeGlyph(u'e', 8));
+    GlyphPositions thirdPositions;
+    auto thirdReference = atlas->addGlyphs(third, thirdPositions);
+    EXPECT_EQ(3u, atlas->getGlyphCount());
+    EXPECT_EQ(size, atlas->getSize());
+    EXPECT_EQ(firstPositions[fontStack][u'a'].rect, thirdPositions[fontStack][u'e'].rect);
+
+    secondReference = {};
+    thirdReference = {};
+    EXPECT_EQ(0u, atlas->getGlyphCount());
+}
+
+TEST(GlyphAtlas, Overflow) {
+    // Room for nine glyphs of 8x8 pixels plus padding.
+    auto atlas = std::make_shared<GlyphAtlas>(Size { 32, 32 });
+    const FontStackHash fontStack = FontStackHasher()({ "Test" });
+
+    GlyphMap first;
+    for (GlyphID id = u'a'; id < u'a' + 4; ++id) {
+        first[fontStack].emplace(id, makeGlyph(id, 8));
+    }
+    GlyphPositions firstPositions;
+    auto firstReference = atlas->addGlyphs(first, firstPositions);
+    EXPECT_FALSE(firstReference.hasOwnImage());
+    EXPECT_EQ(4u, atlas->getGlyphCount());
+
+    // A layout whose glyphs don't all fit gets an image of its own, and leaves
+    // the shared atlas as it was.
+    GlyphMap second;
+    for (GlyphID id = u'a'; id < u'a' + 12; ++id) {
+        second[fontStack].emplace(id, makeGlyph(id, 8));
+    }
+    GlyphPositions secondPositions;
+    auto secondReference = atlas->addGlyphs(second, secondPositions);
+    EXPECT_TRUE(secondReference.hasOwnImage());
+    EXPECT_EQ(4u, atlas->getGlyphCount());
+    EXPECT_GE(32u, atlas->getSize().width);
+    EXPECT_GE(32u, atlas->getSize().height);
+    EXPECT_EQ(12u, secondPositions[fontStack].size());
+
+    EXPECT_LT(0u, secondReference.getMemoryUsage());
+    optional<AlphaImage> image = secondReference.takeOwnImage();
+    ASSERT_TRUE(image);
+    EXPECT_EQ(0u, secondReference.getMemoryUsage());
+    EXPECT_FALSE(secondReference.takeOwnImage());
+    EXPECT_TRUE(secondReference.hasOwnImage());
+
+    const GlyphPosition& position = secondPositions[fontStack][u'k'];
+    EXPECT_EQ(u'k', image->data[(position.rect.y + 1) * image->size.width + position.rect.x + 1]);
+
+    // Layouts that fit keep using the shared atlas.
+    GlyphMap third;
+    third[fontStack].emplace(u'x', makeGlyph(u'x', 8));
+    GlyphPositions thirdPositions;
+    auto thirdReference = atlas->addGlyphs(third, thirdPositions);
+    EXPECT_FALSE(thirdReference.hasOwnImage());
+    EXPECT_EQ(5u, atlas->getGlyphCount());
+    EXPECT_EQ(Size(32, 32), atlas->getSize());
+}
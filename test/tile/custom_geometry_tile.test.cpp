@@ -39,6 +39,8 @@ public:
         annotationManager,
         imageManager,
         glyphManager,
+        0,
+        false,
         0
     };
 };
@@ -7,9 +7,14 @@
 #include <mbgl/annotation/annotation_manager.hpp>
 #include <mbgl/map/transform.hpp>
 #include <mbgl/renderer/image_manager.hpp>
+#include <mbgl/renderer/property_evaluation_parameters.hpp>
 #include <mbgl/renderer/tile_parameters.hpp>
+#include <mbgl/renderer/tile_render_data.hpp>
+#include <mbgl/style/expression/dsl.hpp>
 #include <mbgl/style/layers/circle_layer.hpp>
 #include <mbgl/style/layers/circle_layer_impl.hpp>
+#include <mbgl/style/layers/line_layer.hpp>
+#include <mbgl/style/layers/line_layer_impl.hpp>
 #include <mbgl/style/sources/geojson_source.hpp>
 #include <mbgl/style/style.hpp>
 #include <mbgl/text/glyph_manager.hpp>
@@ -40,6 +45,8 @@ public:
         annotationManager,
         imageManager,
         glyphManager,
+        0,
+        false,
         0
     };
 };
@@ -65,6 +72,48 @@ private:
     TileFeatures features;
 };
 
+Immutable<LayerProperties> evaluateLayer(const CircleLayer& layer) {
+    auto impl = staticImmutableCast<CircleLayer::Impl>(layer.baseImpl);
+    return makeMutable<CircleLayerProperties>(impl, impl->paint.untransitioned().evaluate(PropertyEvaluationParameters(0)));
+}
+
+Immutable<LayerProperties> evaluateLayer(const LineLayer& layer) {
+    auto impl = staticImmutableCast<LineLayer::Impl>(layer.baseImpl);
+    const PropertyEvaluationParameters parameters(0);
+    return makeMutable<LineLayerProperties>(impl, parameters.getCrossfadeParameters(),
+                                            impl->paint.untransitioned().evaluate(parameters));
+}
+
+// Lays out a tile with the `before` layer, then with the `after` layer, and
+// returns whether the bucket built by the first layout was kept by the second.
+template <class LayerType>
+bool keepsBucket(const LayerType& before, const LayerType& after) {
+    GeoJSONTileTest test;
+
+    mapbox::feature::feature_collection<int16_t> features;
+    features.push_back(mapbox::feature::feature<int16_t> { mapbox::geometry::point<int16_t>(0, 0) });
+    features.push_back(mapbox::feature::feature<int16_t> {
+        mapbox::geometry::line_string<int16_t> { { 0, 0 }, { 100, 100 } } });
+    auto data = std::make_shared<FakeGeoJSONData>(std::move(features));
+    GeoJSONTile tile(OverscaledTileID(0, 0, 0), "source", test.tileParameters, data);
+
+    tile.setLayers({ evaluateLayer(before) });
+    while (!tile.isComplete()) {
+        test.loop.runOnce();
+    }
+    const Bucket* previous = tile.createRenderData()->getBucket(*before.baseImpl);
+    EXPECT_TRUE(previous);
+
+    tile.setLayers({ evaluateLayer(after) });
+    while (!tile.isComplete()) {
+        test.loop.runOnce();
+    }
+    const Bucket* current = tile.createRenderData()->getBucket(*after.baseImpl);
+    EXPECT_TRUE(current);
+
+    return previous == current;
+}
+
 } // namespace
 
 TEST(GeoJSONTile, Issue7648) {
@@ -134,3 +183,37 @@ TEST(GeoJSONTile, Issue9927) {
     ASSERT_TRUE(tile.isRenderable());
     ASSERT_TRUE(tile.layerPropertiesUpdated(layerProperties));
  }
+
+TEST(GeoJSONTile, KeepsBucketOnPaintChange) {
+    CircleLayer before("circle", "source");
+    CircleLayer after("circle", "source");
+    after.setCircleColor(Color::red());
+    after.setCircleRadius(10.0f);
+
+    EXPECT_TRUE(keepsBucket(before, after));
+}
+
+TEST(GeoJSONTile, RebuildsBucketOnFilterChange) {
+    CircleLayer before("circle", "source");
+    CircleLayer after("circle", "source");
+    after.setFilter(Filter(expression::dsl::literal(true)));
+
+    EXPECT_FALSE(keepsBucket(before, after));
+}
+
+TEST(GeoJSONTile, RebuildsBucketOnLayoutChange) {
+    LineLayer before("line", "source");
+    LineLayer after("line", "source");
+    after.setLineCap(LineCapType::Round);
+
+    EXPECT_FALSE(keepsBucket(before, after));
+}
+
+TEST(GeoJSONTile, RebuildsBucketOnDataDrivenPaintChange) {
+    using namespace expression::dsl;
+    CircleLayer before("circle", "source");
+    CircleLayer after("circle", "source");
+    after.setCircleRadius(PropertyExpression<float>(number(get("radius")), 5.0f));
+
+    EXPECT_FALSE(keepsBucket(before, after));
+}
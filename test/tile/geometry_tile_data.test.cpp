@@ -105,3 +105,23 @@ TEST(GeometryTileData, limitHoles3) {
     ASSERT_EQ(original.at(3), polygon.at(2));
 
 }
+
+TEST(GeometryTileData, FeaturePropertyKeyResolution) {
+    const FeaturePropertyKey b("FeaturePropertyKeyResolution.b");
+    std::vector<FeaturePropertyKey> others;
+    for (int i = 0; i < 1000; ++i) {
+        others.emplace_back("FeaturePropertyKeyResolution.other" + std::to_string(i));
+    }
+
+    const FeaturePropertyKey::Resolution resolution({ "FeaturePropertyKeyResolution.a", "FeaturePropertyKeyResolution.b" });
+    EXPECT_EQ(optional<uint32_t>(1u), resolution.find(b));
+    EXPECT_EQ(optional<uint32_t>(FeaturePropertyKey::noIndex), resolution.find(others.front()));
+    EXPECT_EQ(optional<uint32_t>(FeaturePropertyKey::noIndex), resolution.find(others.back()));
+
+    // Keys registered afterwards aren't resolved.
+    const FeaturePropertyKey a("FeaturePropertyKeyResolution.a");
+    EXPECT_EQ(nullopt, resolution.find(a));
+
+    // Only the names in the list take up space, however many keys are registered.
+    EXPECT_GT(others.size() * sizeof(uint32_t), resolution.getMemoryUsage());
+}
@@ -34,6 +34,8 @@ public:
         annotationManager,
         imageManager,
         glyphManager,
+        0,
+        false,
         0
     };
 };
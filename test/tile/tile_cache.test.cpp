@@ -42,6 +42,8 @@ public:
                                   annotationManager,
                                   imageManager,
                                   glyphManager,
+                                  0,
+                                  false,
                                   0};
 };
 
@@ -85,3 +87,47 @@ TEST(TileCache, Issue15926) {
     EXPECT_FALSE(cache.has(id0));
     EXPECT_TRUE(cache.has(id1));
 }
+
+class SizedTileMock : public VectorTileMock {
+public:
+    SizedTileMock(const OverscaledTileID& id, VectorTileTest& test, std::size_t memoryUsage_)
+        : VectorTileMock(id, "source", test.tileParameters, test.tileset), memoryUsage(memoryUsage_) {}
+
+    std::size_t getMemoryUsage() const override { return memoryUsage; }
+
+private:
+    const std::size_t memoryUsage;
+};
+
+TEST(TileCache, MemoryLimit) {
+    VectorTileTest test;
+    TileCache cache(10);
+    cache.setMaximumMemoryUsage(100);
+    OverscaledTileID id0(1, 0, 0);
+    OverscaledTileID id1(1, 1, 0);
+    OverscaledTileID id2(1, 0, 1);
+
+    cache.add(id0, std::make_unique<SizedTileMock>(id0, test, 60));
+    cache.add(id1, std::make_unique<SizedTileMock>(id1, test, 30));
+    EXPECT_EQ(cache.getMemoryUsage(), 90u);
+
+    // Evicts the least recently added tile.
+    cache.add(id2, std::make_unique<SizedTileMock>(id2, test, 40));
+    EXPECT_FALSE(cache.has(id0));
+    EXPECT_TRUE(cache.has(id1));
+    EXPECT_TRUE(cache.has(id2));
+    EXPECT_EQ(cache.getMemoryUsage(), 70u);
+
+    EXPECT_TRUE(cache.pop(id1));
+    EXPECT_EQ(cache.getMemoryUsage(), 40u);
+
+    // Tiles exceeding the limit on their own aren't kept.
+    cache.add(id0, std::make_unique<SizedTileMock>(id0, test, 200));
+    EXPECT_FALSE(cache.has(id0));
+    EXPECT_TRUE(cache.has(id2));
+    EXPECT_EQ(cache.getMemoryUsage(), 40u);
+
+    cache.setMaximumMemoryUsage(10);
+    EXPECT_FALSE(cache.has(id2));
+    EXPECT_EQ(cache.getMemoryUsage(), 0u);
+}
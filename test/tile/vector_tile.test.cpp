@@ -40,6 +40,8 @@ public:
         annotationManager,
         imageManager,
         glyphManager,
+        0,
+        false,
         0
     };
 };
@@ -104,3 +106,58 @@ TEST(VectorTileData, ParseResults) {
 
     ASSERT_EQ(feature->getValue("invalid"), nullopt);
 }
+
+TEST(VectorTileData, SharesDecodedFeatures) {
+    VectorTileData data(std::make_shared<std::string>(util::read_file("test/fixtures/map/issue12432/0-0-0.mvt")));
+    std::unique_ptr<GeometryTileData> clone = data.clone();
+
+    std::unique_ptr<GeometryTileFeature> feature = data.getLayer("admin")->getFeature(0u);
+    std::unique_ptr<GeometryTileFeature> other = data.getLayer("admin")->getFeature(0u);
+    std::unique_ptr<GeometryTileFeature> cloned = clone->getLayer("admin")->getFeature(0u);
+
+    // Geometries are decoded once per source layer and shared by all readers.
+    EXPECT_EQ(&feature->getGeometries(), &other->getGeometries());
+    EXPECT_EQ(&feature->getGeometries(), &cloned->getGeometries());
+    EXPECT_EQ(feature->getProperties(), cloned->getProperties());
+    EXPECT_EQ(feature->getID(), cloned->getID());
+}
+
+TEST(VectorTileData, MemoryUsage) {
+    auto data = std::make_shared<std::string>(util::read_file("test/fixtures/map/issue12432/0-0-0.mvt"));
+    FeatureIndex featureIndex(std::make_unique<VectorTileData>(data));
+    const GeometryTileData& tileData = *featureIndex.getData();
+
+    const std::size_t initial = featureIndex.getMemoryUsage();
+    EXPECT_LE(data->size(), tileData.getMemoryUsage());
+    EXPECT_LE(tileData.getMemoryUsage(), initial);
+
+    // Decoded source layers are counted once they're parsed, and only once for
+    // all clones of the data.
+    std::unique_ptr<GeometryTileData> clone = tileData.clone();
+    std::unique_ptr<GeometryTileLayer> layer = clone->getLayer("admin");
+    EXPECT_EQ(initial, featureIndex.getMemoryUsage());
+    layer->getFeature(0u);
+    const std::size_t parsed = featureIndex.getMemoryUsage();
+    EXPECT_LT(initial, parsed);
+    EXPECT_EQ(clone->getMemoryUsage(), tileData.getMemoryUsage());
+
+    layer->getFeature(1u);
+    EXPECT_EQ(parsed, featureIndex.getMemoryUsage());
+}
+
+TEST(VectorTileData, PropertyKeys) {
+    const FeaturePropertyKey disputed("disputed");
+    const FeaturePropertyKey invalid("invalid");
+
+    VectorTileData data(std::make_shared<std::string>(util::read_file("test/fixtures/map/issue12432/0-0-0.mvt")));
+    std::unique_ptr<GeometryTileFeature> feature = data.getLayer("admin")->getFeature(0u);
+
+    EXPECT_EQ(feature->getPropertyValue(disputed), feature->getValue("disputed"));
+    EXPECT_EQ(feature->getPropertyValue(invalid), nullopt);
+
+    // Keys registered after the layer was decoded are found as well.
+    for (const auto& property : feature->getProperties()) {
+        EXPECT_EQ(feature->getPropertyValue(FeaturePropertyKey(property.first)), optional<Value>(property.second));
+    }
+    EXPECT_EQ(feature->getPropertyValue(FeaturePropertyKey("VectorTileData.PropertyKeys")), nullopt);
+}
@@ -0,0 +1,78 @@
+#include <mbgl/test/util.hpp>
+
+#include <mbgl/util/compression.hpp>
+
+#include <random>
+#include <stdexcept>
+
+using namespace mbgl;
+
+namespace {
+
+std::string randomString(std::size_t size) {
+    std::string result(size, 0);
+    std::mt19937 random;
+    for (auto& c : result) {
+        c = random() % 16;
+    }
+    return result;
+}
+
+} // namespace
+
+TEST(Compression, RoundTrip) {
+    for (std::size_t size : { 0u, 1u, 1000u, 100000u }) {
+        const std::string raw = randomString(size);
+        const std::string compressed = util::compress(raw);
+        EXPECT_EQ(raw, util::decompress(compressed)) << size;
+        EXPECT_EQ(raw, util::decompress(compressed)) << size;
+    }
+}
+
+TEST(Compression, Pool) {
+    util::CompressionPool pool;
+    for (std::size_t size : { 0u, 1u, 1000u, 100000u }) {
+        const std::string raw = randomString(size);
+        const std::string compressed = pool.compress(raw);
+        EXPECT_EQ(util::compress(raw), compressed) << size;
+        EXPECT_EQ(raw, pool.decompress(compressed)) << size;
+        EXPECT_EQ(raw, pool.decompress(compressed)) << size;
+    }
+}
+
+TEST(Compression, Streaming) {
+    const std::string raw = randomString(100000);
+
+    util::CompressionPool pool;
+    util::Compressor compressor(pool);
+    std::string compressed;
+    for (std::size_t i = 0; i < raw.size(); i += 777) {
+        compressor.write(raw.data() + i, std::min<std::size_t>(777, raw.size() - i), compressed);
+    }
+    compressor.finish(compressed);
+    EXPECT_EQ(util::compress(raw), compressed);
+
+    util::Decompressor decompressor(pool);
+    std::string decompressed;
+    for (std::size_t i = 0; i < compressed.size(); i += 333) {
+        decompressor.write(compressed.data() + i, std::min<std::size_t>(333, compressed.size() - i), decompressed);
+    }
+    decompressor.finish();
+    EXPECT_EQ(raw, decompressed);
+}
+
+TEST(Compression, Gzip) {
+    // "hello" compressed with gzip.
+    const std::string gzipped("\x1f\x8b\x08\x00\x00\x00\x00\x00\x02\x03\xcb\x48\xcd\xc9\xc9\x07\x00\x86\xa6\x10\x36\x05\x00\x00\x00", 25);
+    EXPECT_EQ("hello", util::decompress(gzipped));
+}
+
+TEST(Compression, Invalid) {
+    EXPECT_THROW(util::decompress("not compressed"), std::runtime_error);
+
+    // Truncated streams are rejected, and don't affect later uses of the pooled stream.
+    util::CompressionPool pool;
+    const std::string compressed = pool.compress(randomString(1000));
+    EXPECT_THROW(pool.decompress(compressed.substr(0, compressed.size() / 2)), std::runtime_error);
+    EXPECT_EQ(randomString(1000), pool.decompress(compressed));
+}
@@ -56,3 +56,44 @@ TEST(GridIndex, IndexesFeaturesOverflow) {
     grid.insert(0, {{4500, 4500}, {4900, 4900}});
     EXPECT_EQ(grid.query({{4000, 4000}, {5000, 5000}}), (std::vector<int16_t>{0}));
 }
+
+TEST(GridIndex, HitTestPredicate) {
+    GridIndex<int16_t> grid(100, 100, 10);
+    grid.insert(0, {{10, 10}, {40, 40}});
+    grid.insert(1, {{30, 30}, 15});
+
+    EXPECT_TRUE(grid.hitTest({{20, 20}, {35, 35}}, [](int16_t t) { return t == 1; }));
+    EXPECT_FALSE(grid.hitTest({{12, 12}, {14, 14}}, [](int16_t t) { return t == 1; }));
+    EXPECT_FALSE(grid.hitTest({{30, 30}, 5}, [](int16_t) { return false; }));
+
+    // Elements spanning many cells are reported once per query, every time.
+    for (int i = 0; i < 3; ++i) {
+        EXPECT_EQ(grid.query({{0, 0}, {50, 50}}), (std::vector<int16_t>{0, 1}));
+    }
+}
+
+TEST(GridIndex, InsertBetweenQueries) {
+    GridIndex<int16_t> grid(100, 100, 10);
+    std::vector<GridIndex<int16_t>::BBox> boxes;
+
+    // Queries see the elements inserted since the cells were last compacted
+    // as well as the compacted ones.
+    for (int16_t i = 0; i < 400; ++i) {
+        const float x = (i * 37) % 90;
+        const float y = (i * 53) % 90;
+        boxes.push_back({{x, y}, {x + i % 11, y + i % 7}});
+        grid.insert(int16_t(i), boxes.back());
+
+        const GridIndex<int16_t>::BBox query {{20, 30}, {45, 60}};
+        std::vector<int16_t> expected;
+        for (int16_t j = 0; j <= i; ++j) {
+            const auto& box = boxes[j];
+            if (box.min.x <= query.max.x && box.min.y <= query.max.y && box.max.x >= query.min.x && box.max.y >= query.min.y) {
+                expected.push_back(j);
+            }
+        }
+        std::vector<int16_t> result = grid.query(query);
+        std::sort(result.begin(), result.end());
+        ASSERT_EQ(expected, result) << i;
+    }
+}
@@ -3,6 +3,7 @@
 
 #include <mbgl/layout/merge_lines.hpp>
 #include <mbgl/layout/symbol_feature.hpp>
+#include <mbgl/util/monotonic_arena.hpp>
 #include <utility>
 
 const std::u16string aaa = u"a";
@@ -15,6 +16,9 @@ namespace {
 PropertyMap properties;
 LineString<int16_t> emptyLine;
 
+// Owns the features referenced by the symbol features, as the layout does.
+util::MonotonicArena arena;
+
 } // namespace
 
 class SymbolFeatureStub : public SymbolFeature {
@@ -26,8 +30,8 @@ public:
                       optional<std::u16string> text_,
                       optional<style::expression::Image> icon_,
                       std::size_t index_)
-        : SymbolFeature(std::make_unique<StubGeometryTileFeature>(
-              std::move(id_), type_, std::move(geometry_), std::move(properties_))) {
+        : SymbolFeature(*arena.make<StubGeometryTileFeature>(
+              std::move(id_), type_, std::move(geometry_), std::move(properties_)), true) {
         if (text_) {
             formattedText = TaggedString(*text_, SectionOptions(1.0, {}));
         }
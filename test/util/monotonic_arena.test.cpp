@@ -0,0 +1,59 @@
+#include <mbgl/test/util.hpp>
+
+#include <mbgl/util/monotonic_arena.hpp>
+
+#include <cstdint>
+#include <vector>
+
+using namespace mbgl;
+
+namespace {
+
+struct Tracked {
+    Tracked(std::vector<int>& log_, int id_) : log(log_), id(id_) {}
+    ~Tracked() { log.push_back(id); }
+
+    std::vector<int>& log;
+    int id;
+};
+
+} // namespace
+
+TEST(MonotonicArena, Alignment) {
+    util::MonotonicArena arena(64);
+    for (std::size_t alignment : { 1u, 2u, 4u, 8u, 16u, 1u, 32u }) {
+        void* memory = arena.allocate(3, alignment);
+        EXPECT_EQ(0u, reinterpret_cast<std::uintptr_t>(memory) % alignment);
+    }
+
+    // Allocations larger than a block get a block of their own.
+    void* large = arena.allocate(1000, 8);
+    EXPECT_EQ(0u, reinterpret_cast<std::uintptr_t>(large) % 8);
+    EXPECT_LE(1000u + 64u, arena.getCapacity());
+}
+
+TEST(MonotonicArena, DestroysObjects) {
+    std::vector<int> log;
+    {
+        util::MonotonicArena arena(64);
+        for (int i = 0; i < 10; ++i) {
+            EXPECT_EQ(i, arena.make<Tracked>(log, i)->id);
+        }
+        EXPECT_TRUE(log.empty());
+
+        const std::size_t capacity = arena.getCapacity();
+        arena.reset();
+        EXPECT_EQ((std::vector<int>{ 9, 8, 7, 6, 5, 4, 3, 2, 1, 0 }), log);
+        EXPECT_GE(capacity, arena.getCapacity());
+        EXPECT_LT(0u, arena.getCapacity());
+
+        log.clear();
+        arena.make<Tracked>(log, 10);
+
+        // Moving the arena transfers the objects it owns.
+        util::MonotonicArena moved(std::move(arena));
+        EXPECT_EQ(0u, arena.getCapacity());
+        EXPECT_TRUE(log.empty());
+    }
+    EXPECT_EQ((std::vector<int>{ 10 }), log);
+}
@@ -0,0 +1,59 @@
+#include <mbgl/test/util.hpp>
+
+#include <mbgl/util/parallel_for.hpp>
+#include <mbgl/util/thread_pool.hpp>
+
+#include <atomic>
+#include <future>
+#include <stdexcept>
+#include <vector>
+
+using namespace mbgl;
+
+TEST(ParallelFor, VisitsEveryIndexOnce) {
+    ThreadPool pool(4);
+
+    std::vector<std::atomic<int>> visits(1000);
+    for (auto& visit : visits) visit = 0;
+
+    util::parallelFor(pool, visits.size(), [&](std::size_t i) { visits[i]++; });
+
+    for (const auto& visit : visits) {
+        EXPECT_EQ(1, visit);
+    }
+}
+
+TEST(ParallelFor, NestedInPoolTask) {
+    // All threads of the pool are busy running the outer tasks, so the inner
+    // loops have to make progress on their calling threads.
+    ThreadPool pool(2);
+
+    std::atomic<std::size_t> count(0);
+    std::vector<std::promise<void>> done(2);
+
+    for (auto& promise : done) {
+        pool.schedule([&] {
+            util::parallelFor(pool, 100, [&](std::size_t) { count++; });
+            promise.set_value();
+        });
+    }
+
+    for (auto& promise : done) {
+        promise.get_future().wait();
+    }
+
+    EXPECT_EQ(200u, count);
+}
+
+TEST(ParallelFor, RethrowsException) {
+    ThreadPool pool(2);
+
+    std::atomic<std::size_t> count(0);
+    EXPECT_THROW(util::parallelFor(pool, 10, [&](std::size_t i) {
+        count++;
+        if (i == 5) throw std::runtime_error("test");
+    }), std::runtime_error);
+
+    // Remaining calls still run to completion.
+    EXPECT_EQ(10u, count);
+}
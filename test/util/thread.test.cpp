@@ -4,10 +4,14 @@
 #include <mbgl/actor/scheduler.hpp>
 #include <mbgl/test/util.hpp>
 #include <mbgl/util/run_loop.hpp>
+#include <mbgl/util/thread_pool.hpp>
 #include <mbgl/util/timer.hpp>
 
 #include <atomic>
+#include <future>
 #include <memory>
+#include <string>
+#include <vector>
 
 using namespace mbgl;
 using namespace mbgl::util;
@@ -188,6 +192,112 @@ TEST(Thread, ThreadPoolMessaging) {
     loop->run();
 }
 
+TEST(Thread, ThreadPoolThreadCount) {
+    ThreadPool pool(7);
+    EXPECT_EQ(7u, pool.getThreadCount());
+
+    ThreadPool::setDefaultThreadCount(2);
+    EXPECT_EQ(2u, ThreadPool::getDefaultThreadCount());
+    EXPECT_EQ(2u, ThreadPool().getThreadCount());
+
+    ThreadPool::setDefaultThreadCount(0);
+    EXPECT_LE(4u, ThreadPool::getDefaultThreadCount());
+}
+
+TEST(Thread, ThreadPoolWorkStealing) {
+    RunLoop loop;
+    ThreadPool pool(4);
+
+    const unsigned numTasks = 1000;
+    std::atomic<unsigned> completed(numTasks * 2);
+
+    auto done = [&] {
+        if (!--completed) {
+            loop.invoke([&] { loop.stop(); });
+        }
+    };
+
+    // Tasks scheduled from inside a worker land in that worker's own queue
+    // and have to be stolen by its siblings to run in parallel.
+    for (unsigned i = 0; i < numTasks; ++i) {
+        pool.schedule([&pool, done] {
+            pool.schedule(done);
+            done();
+        });
+    }
+
+    loop.run();
+    EXPECT_EQ(0u, completed);
+}
+
+TEST(Thread, ThreadPoolPriority) {
+    ThreadPool pool(1);
+
+    std::promise<void> started;
+    std::promise<void> blocked;
+    std::promise<void> done;
+    std::vector<int> order;
+
+    // Keep the only worker busy while the prioritized tasks are queued up.
+    pool.schedule([&] {
+        started.set_value();
+        blocked.get_future().wait();
+    });
+    started.get_future().wait();
+
+    std::vector<std::shared_ptr<TaskPriority>> priorities;
+    for (int i = 0; i < 4; ++i) {
+        priorities.push_back(std::make_shared<TaskPriority>(i));
+        pool.scheduleWithPriority([&, i] {
+            order.push_back(i);
+            if (order.size() == 4) done.set_value();
+        }, priorities.back());
+    }
+
+    // Priorities can change while tasks are pending.
+    *priorities[3] = -1;
+    *priorities[0] = 10;
+
+    blocked.set_value();
+    done.get_future().wait();
+
+    EXPECT_EQ((std::vector<int>{ 3, 1, 2, 0 }), order);
+}
+
+TEST(Thread, ThreadPoolPriorityInterleaving) {
+    ThreadPool pool(1);
+
+    std::promise<void> started;
+    std::promise<void> blocked;
+    std::promise<void> done;
+    std::vector<std::string> order;
+
+    pool.schedule([&] {
+        started.set_value();
+        blocked.get_future().wait();
+    });
+    started.get_future().wait();
+
+    auto task = [&](std::string name) {
+        return [&, name] {
+            order.push_back(name);
+            if (order.size() == 4) done.set_value();
+        };
+    };
+    auto urgent = std::make_shared<TaskPriority>(0);
+    auto later = std::make_shared<TaskPriority>(1);
+    pool.schedule(task("regular 1"));
+    pool.schedule(task("regular 2"));
+    pool.scheduleWithPriority(task("later"), later);
+    pool.scheduleWithPriority(task("urgent"), urgent);
+
+    blocked.set_value();
+    done.get_future().wait();
+
+    // Prioritized tasks don't wait for all regular tasks to drain.
+    EXPECT_EQ((std::vector<std::string>{ "urgent", "regular 1", "later", "regular 2" }), order);
+}
+
 TEST(Thread, ReferenceCanOutliveThread) {
     auto thread = std::make_unique<Thread<TestWorker>>("Test");
     auto worker = thread->actor();
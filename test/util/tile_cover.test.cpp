@@ -4,6 +4,7 @@
 
 #include <algorithm>
 #include <cstdlib>     /* srand, rand */
+#include <limits>
 #include <ctime>       /* time */
 #include <gtest/gtest.h>
 
@@ -362,6 +363,47 @@ TEST(TileCount, BoundsCrossingAntimeridian) {
     EXPECT_EQ(8u, util::tileCount(crossingBounds, 4));
 }
 
+TEST(TileCoverStream, Skip) {
+    const auto zoom = 13;
+    std::vector<UnwrappedTileID> tiles;
+    util::TileCover all(sanFrancisco, zoom);
+    while (all.hasNext()) {
+        tiles.push_back(*all.next());
+    }
+    ASSERT_GT(tiles.size(), 10u);
+
+    for (uint64_t count : { uint64_t(0), uint64_t(1), uint64_t(7), uint64_t(tiles.size() - 1) }) {
+        util::TileCover tc(sanFrancisco, zoom);
+        EXPECT_EQ(count, tc.skip(count));
+        EXPECT_EQ(tiles[count], *tc.next());
+    }
+
+    util::TileCover tc(sanFrancisco, zoom);
+    EXPECT_EQ(3u, tc.skip(3));
+    EXPECT_EQ(tiles.size() - 3, tc.skip(std::numeric_limits<uint64_t>::max()));
+    EXPECT_FALSE(tc.hasNext());
+    EXPECT_EQ(0u, tc.skip(1));
+}
+
+TEST(TileCount, GeomPolygon) {
+    auto polygon = Polygon<double>{
+        {
+            {5.09765625,53.067626642387374},
+            {2.373046875,43.389081939117496},
+            {-4.74609375,48.45835188280866},
+            {-1.494140625,37.09023980307208},
+            {22.587890625,36.24427318493909},
+            {31.640625,46.13417004624326},
+            {17.841796875,54.7246201949245},
+            {5.09765625,53.067626642387374},
+        }
+    };
+
+    for (uint8_t z = 0; z <= 10; z++) {
+        EXPECT_EQ(util::tileCover(polygon, z).size(), util::tileCount(polygon, z));
+    }
+}
+
 TEST(TileCover, DISABLED_FuzzPoly) {
     while(true)
     {